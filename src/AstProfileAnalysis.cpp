@@ -0,0 +1,171 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file AstProfileAnalysis.cpp
+ *
+ * Implements the reading of the statistics of a profile log.
+ *
+ ***********************************************************************/
+
+#include "AstProfileAnalysis.h"
+#include "AstClause.h"
+#include "Global.h"
+#include "ProfileDatabase.h"
+#include "Util.h"
+#include "json11.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace souffle {
+
+namespace {
+
+// the share of the runtime of the program from which on a rule is considered hot
+const double HOT_FRACTION = 0.01;
+
+/** add the runtime of a rule recorded in the given profile directory */
+void addRuntime(const profile::DirectoryEntry* rule, std::map<std::string, double>& runtimes) {
+    if (rule == nullptr) {
+        return;
+    }
+    auto* srcLocator = dynamic_cast<profile::TextEntry*>(rule->readEntry("source-locator"));
+    auto* duration = dynamic_cast<profile::DurationEntry*>(rule->readEntry("runtime"));
+    if (srcLocator != nullptr && duration != nullptr) {
+        runtimes[srcLocator->getText()] += (duration->getEnd() - duration->getStart()).count();
+    }
+}
+
+}  // namespace
+
+void ProfileUseAnalysis::run(const AstTranslationUnit& /* translationUnit */) {
+    if (!Global::config().has("use-profile")) {
+        return;
+    }
+
+    // a missing or malformed log is reported once, as the analysis is repeated after transformations,
+    // and no statistics are used
+    static bool warned = false;
+    std::string fileName = Global::config().get("use-profile");
+    auto warn = [&](const std::string& problem) {
+        if (!warned) {
+            std::cerr << "Warning: profile log " << fileName << " " << problem << ", it is ignored\n";
+            warned = true;
+        }
+    };
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        warn("could not be opened");
+        return;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::string error;
+    json11::Json json = json11::Json::parse(text, error);
+    if (!error.empty() || !json["root"].is_object()) {
+        warn("is malformed");
+        return;
+    }
+    profile::ProfileDatabase db;
+    db.addEntries(json);
+
+    auto* programRuntime = dynamic_cast<profile::DurationEntry*>(db.lookupEntry({"program", "runtime"}));
+    if (programRuntime != nullptr) {
+        runtime = (programRuntime->getEnd() - programRuntime->getStart()).count();
+    }
+
+    auto* relations = dynamic_cast<profile::DirectoryEntry*>(db.lookupEntry({"program", "relation"}));
+    if (relations == nullptr) {
+        return;
+    }
+    for (const std::string& rel : relations->getKeys()) {
+        const profile::DirectoryEntry* relation = relations->readDirectoryEntry(rel);
+        if (relation == nullptr) {
+            continue;
+        }
+
+        // the tuples of the non-recursive rules, to which each iteration adds its new tuples
+        auto* tuples = dynamic_cast<profile::SizeEntry*>(relation->readEntry("num-tuples"));
+        if (tuples != nullptr) {
+            sizes[rel] = tuples->getSize();
+        }
+        if (const profile::DirectoryEntry* rules = relation->readDirectoryEntry("non-recursive-rule")) {
+            for (const std::string& rule : rules->getKeys()) {
+                addRuntime(rules->readDirectoryEntry(rule), runtimes);
+            }
+        }
+
+        const profile::DirectoryEntry* loop = relation->readDirectoryEntry("iteration");
+        if (loop == nullptr) {
+            continue;
+        }
+        iterations[rel] = loop->getKeys().size();
+        for (const std::string& iteration : loop->getKeys()) {
+            const profile::DirectoryEntry* cur = loop->readDirectoryEntry(iteration);
+            if (cur == nullptr) {
+                continue;
+            }
+            if (auto* newTuples = dynamic_cast<profile::SizeEntry*>(cur->readEntry("num-tuples"))) {
+                sizes[rel] += newTuples->getSize();
+            }
+            const profile::DirectoryEntry* rules = cur->readDirectoryEntry("recursive-rule");
+            if (rules == nullptr) {
+                continue;
+            }
+            for (const std::string& rule : rules->getKeys()) {
+                const profile::DirectoryEntry* versions = rules->readDirectoryEntry(rule);
+                if (versions == nullptr) {
+                    continue;
+                }
+                for (const std::string& version : versions->getKeys()) {
+                    addRuntime(versions->readDirectoryEntry(version), runtimes);
+                }
+            }
+        }
+    }
+}
+
+void ProfileUseAnalysis::print(std::ostream& os) const {
+    os << "runtime: " << runtime << "us" << std::endl;
+    for (const auto& cur : sizes) {
+        os << cur.first << ": " << cur.second << " tuples";
+        if (iterations.count(cur.first) > 0) {
+            os << " in " << iterations.at(cur.first) << " iterations";
+        }
+        os << std::endl;
+    }
+    for (const auto& cur : runtimes) {
+        os << cur.first << ": " << cur.second << "us" << std::endl;
+    }
+}
+
+bool ProfileUseAnalysis::hasSize(const AstRelationIdentifier& rel) const {
+    return sizes.count(toString(rel)) > 0;
+}
+
+size_t ProfileUseAnalysis::getSize(const AstRelationIdentifier& rel) const {
+    auto pos = sizes.find(toString(rel));
+    return (pos != sizes.end()) ? pos->second : 0;
+}
+
+size_t ProfileUseAnalysis::getIterations(const AstRelationIdentifier& rel) const {
+    auto pos = iterations.find(toString(rel));
+    return (pos != iterations.end()) ? pos->second : 0;
+}
+
+double ProfileUseAnalysis::getRuntime(const AstClause& clause) const {
+    auto pos = runtimes.find(toString(clause.getSrcLoc()));
+    return (pos != runtimes.end()) ? pos->second : 0;
+}
+
+bool ProfileUseAnalysis::isHot(const AstClause& clause) const {
+    return runtime > 0 && getRuntime(clause) >= HOT_FRACTION * runtime;
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,77 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file AstProfileAnalysis.h
+ *
+ * Defines an analysis providing the statistics recorded in the profile
+ * log of a previous run of the program.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "AstAnalysis.h"
+#include "AstRelationIdentifier.h"
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace souffle {
+
+class AstClause;
+class AstTranslationUnit;
+
+/**
+ * Analysis pass reading the profile log given by the use-profile option.
+ *
+ * Relations are identified by their names and rules by their source
+ * locations, such that the statistics remain applicable to a program
+ * whose other parts have changed since the profile was recorded. Without
+ * a profile log no statistics are available.
+ */
+class ProfileUseAnalysis : public AstAnalysis {
+private:
+    /** the number of tuples of each relation at the end of the run */
+    std::map<std::string, size_t> sizes;
+
+    /** the number of iterations of the fixpoint computing each recursive relation */
+    std::map<std::string, size_t> iterations;
+
+    /** the runtime of the rules at each source location, in microseconds */
+    std::map<std::string, double> runtimes;
+
+    /** the runtime of the program, in microseconds */
+    double runtime = 0;
+
+public:
+    static constexpr const char* name = "profile-use";
+
+    void run(const AstTranslationUnit& translationUnit) override;
+
+    void print(std::ostream& os) const override;
+
+    /** Check whether the profile recorded the number of tuples of a relation */
+    bool hasSize(const AstRelationIdentifier& rel) const;
+
+    /** Get the number of tuples of a relation recorded by the profile */
+    size_t getSize(const AstRelationIdentifier& rel) const;
+
+    /** Get the number of iterations recorded for a recursive relation, zero if none */
+    size_t getIterations(const AstRelationIdentifier& rel) const;
+
+    /** Get the runtime recorded for a clause, in microseconds */
+    double getRuntime(const AstClause& clause) const;
+
+    /** Check whether a clause took a significant share of the runtime of the program */
+    bool isHot(const AstClause& clause) const;
+};
+
+}  // end of namespace souffle
@@ -64,6 +64,15 @@
 /* Relation uses a hash set */
 #define HASHSET_RELATION (0x400)
 
+/* Relation stores its tuples column-wise */
+#define COLUMNAR_RELATION (0x800)
+
+/* Relation uses a b-tree with compressed leaves */
+#define COMPRESSED_RELATION (0x1000)
+
+/* Relation spills its tuples to disk if short of memory */
+#define SPILL_RELATION (0x2000)
+
 namespace souffle {
 
 /*!
@@ -176,6 +185,21 @@ public:
         return (qualifier & HASHSET_RELATION) != 0;
     }
 
+    /** Check whether relation is a columnar relation */
+    bool isColumnar() const {
+        return (qualifier & COLUMNAR_RELATION) != 0;
+    }
+
+    /** Check whether relation is a compressed b-tree relation */
+    bool isCompressed() const {
+        return (qualifier & COMPRESSED_RELATION) != 0;
+    }
+
+    /** Check whether relation spills its tuples to disk */
+    bool isSpill() const {
+        return (qualifier & SPILL_RELATION) != 0;
+    }
+
     /** Check whether relation is an input relation */
     bool isPrintSize() const {
         return (qualifier & PRINTSIZE_RELATION) != 0;
@@ -258,6 +282,15 @@ public:
         if (isHashset()) {
             os << "hashset ";
         }
+        if (isColumnar()) {
+            os << "columnar ";
+        }
+        if (isCompressed()) {
+            os << "compressed ";
+        }
+        if (isSpill()) {
+            os << "spill ";
+        }
         if (isEqRel()) {
             os << "eqrel ";
         }
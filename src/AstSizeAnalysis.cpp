@@ -0,0 +1,343 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file AstSizeAnalysis.cpp
+ *
+ * Implements the estimation of the cardinalities of relations.
+ *
+ ***********************************************************************/
+
+#include "AstSizeAnalysis.h"
+#include "AstArgument.h"
+#include "AstClause.h"
+#include "AstIODirective.h"
+#include "AstLiteral.h"
+#include "AstProfileAnalysis.h"
+#include "AstProgram.h"
+#include "AstRelation.h"
+#include "AstTranslationUnit.h"
+#include "AstVisitor.h"
+#include "BinaryConstraintOps.h"
+#include "Global.h"
+#include "PrecedenceGraph.h"
+#include "Util.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <unordered_map>
+
+namespace souffle {
+
+namespace {
+
+// the number of tuples assumed for inputs without a readable fact file
+const double DEFAULT_SIZE = 1000;
+
+// the upper bound of all estimates, keeping products of estimates finite
+const double MAX_SIZE = 1e18;
+
+// the number of tuples of a fact file sampled for counting distinct values
+const size_t SAMPLE_SIZE = 100000;
+
+// the maximal number of rounds estimating the relations of a recursive SCC
+const int MAX_ROUNDS = 16;
+
+// the relative change of an estimate considered to be settled
+const double TOLERANCE = 0.01;
+
+}  // namespace
+
+bool RelationSizeAnalysis::isBound(const AstArgument& arg, const std::set<std::string>& bound) {
+    bool res = true;
+    visitDepthFirst(arg, [&](const AstArgument& cur) {
+        if (auto* var = dynamic_cast<const AstVariable*>(&cur)) {
+            res = res && bound.count(var->getName()) > 0;
+        } else if (dynamic_cast<const AstUnnamedVariable*>(&cur) != nullptr ||
+                   dynamic_cast<const AstCounter*>(&cur) != nullptr ||
+                   dynamic_cast<const AstAggregator*>(&cur) != nullptr) {
+            res = false;
+        }
+    });
+    return res;
+}
+
+void RelationSizeAnalysis::bindEqualities(const AstClause& clause, std::set<std::string>& bound) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (AstBinaryConstraint* constraint : clause.getBinaryConstraints()) {
+            if (constraint->getOperator() != BinaryConstraintOp::EQ) {
+                continue;
+            }
+            auto bind = [&](const AstArgument* var, const AstArgument* value) {
+                auto* variable = dynamic_cast<const AstVariable*>(var);
+                if (variable != nullptr && bound.count(variable->getName()) == 0 && isBound(*value, bound)) {
+                    bound.insert(variable->getName());
+                    changed = true;
+                }
+            };
+            bind(constraint->getLHS(), constraint->getRHS());
+            bind(constraint->getRHS(), constraint->getLHS());
+        }
+    }
+}
+
+bool RelationSizeAnalysis::readFacts(const AstRelation& rel) {
+    std::map<std::string, std::string> directives;
+    for (AstIODirective* cur : rel.getIODirectives()) {
+        if (cur->isInput()) {
+            for (const auto& pair : cur->getIODirectiveMap()) {
+                directives[pair.first] = pair.second;
+            }
+        }
+    }
+    if (directives.count("IO") > 0 && directives["IO"] != "file") {
+        return false;
+    }
+    std::string fileName = directives.count("filename") > 0
+                                   ? directives["filename"]
+                                   : toString(join(rel.getName().getNames(), "-")) + ".facts";
+    if (!fileName.empty() && fileName.front() != '/') {
+        fileName = Global::config().get("fact-dir") + "/" + fileName;
+    }
+    std::ifstream in(fileName);
+    if (!in) {
+        return false;
+    }
+    std::string delimiter = directives.count("delimiter") > 0 ? directives["delimiter"] : "\t";
+    std::string line;
+    if (directives["headers"] == "true") {
+        std::getline(in, line);
+    }
+
+    // count the occurrences of values within a sample of the tuples
+    size_t arity = rel.getArity();
+    std::vector<std::unordered_map<std::string, size_t>> counts(arity);
+    size_t sampled = 0;
+    while (sampled < SAMPLE_SIZE && std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        sampled++;
+        size_t start = 0;
+        for (size_t col = 0; col < arity; col++) {
+            size_t end = line.find(delimiter, start);
+            counts[col][line.substr(start, end - start)]++;
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + delimiter.size();
+        }
+    }
+
+    // rather than reading a large file to its end, extrapolate its tuples from the bytes of the sample
+    size_t lines = sampled;
+    if (sampled == SAMPLE_SIZE) {
+        std::streamoff read = in.tellg();
+        in.seekg(0, std::ios::end);
+        std::streamoff total = in.tellg();
+        if (read > 0 && total > read) {
+            lines = static_cast<size_t>((double)sampled * total / read);
+        }
+    }
+
+    // extrapolate the distinct values of a sample, where values seen once likely recur unseen
+    std::vector<double> cols(arity);
+    for (size_t col = 0; col < arity; col++) {
+        double values = counts[col].size();
+        double singletons = std::count_if(counts[col].begin(), counts[col].end(),
+                [](const std::pair<const std::string, size_t>& cur) { return cur.second == 1; });
+        if (sampled < lines) {
+            values = std::sqrt((double)lines / sampled) * singletons + (values - singletons);
+        }
+        cols[col] = std::max(1.0, std::min(values, (double)lines));
+    }
+    sizes[rel.getName()] = lines;
+    distinct[rel.getName()] = cols;
+    measured.insert(rel.getName());
+    return true;
+}
+
+double RelationSizeAnalysis::estimateClause(
+        const AstClause& clause, std::vector<double>& headDistinct) const {
+    std::set<std::string> bound;
+    bindEqualities(clause, bound);
+    std::set<std::string> constant = bound;
+
+    // join the atoms in the order of the clause, the estimate does not depend on it
+    double size = 1;
+    std::map<std::string, double> varDistinct;
+    for (AstAtom* atom : clause.getAtoms()) {
+        size = std::min(size * getMatches(*atom, bound), MAX_SIZE);
+        std::vector<AstArgument*> args = atom->getArguments();
+        for (size_t i = 0; i < args.size(); i++) {
+            if (auto* var = dynamic_cast<const AstVariable*>(args[i])) {
+                double values = getDistinct(atom->getName(), i);
+                auto pos = varDistinct.find(var->getName());
+                if (pos == varDistinct.end() || values < pos->second) {
+                    varDistinct[var->getName()] = values;
+                }
+            }
+        }
+        visitDepthFirst(*atom, [&](const AstVariable& var) { bound.insert(var.getName()); });
+        bindEqualities(clause, bound);
+    }
+
+    std::vector<AstArgument*> args = clause.getHead()->getArguments();
+    for (size_t i = 0; i < args.size() && i < headDistinct.size(); i++) {
+        double values = size;
+        if (isBound(*args[i], constant)) {
+            values = 1;
+        } else if (auto* var = dynamic_cast<const AstVariable*>(args[i])) {
+            auto pos = varDistinct.find(var->getName());
+            if (pos != varDistinct.end()) {
+                values = pos->second;
+            }
+        }
+        headDistinct[i] += std::min(values, size);
+    }
+    return size;
+}
+
+void RelationSizeAnalysis::run(const AstTranslationUnit& translationUnit) {
+    const auto* sccGraph = translationUnit.getAnalysis<SCCGraph>();
+    const auto* sccOrder = translationUnit.getAnalysis<TopologicallySortedSCCGraph>();
+    const auto* profile = translationUnit.getAnalysis<ProfileUseAnalysis>();
+
+    for (unsigned scc : sccOrder->order()) {
+        const std::set<const AstRelation*> rels = sccGraph->getInternalRelations(scc);
+
+        // the statistics of facts and inputs, which the clauses add to
+        std::map<AstRelationIdentifier, std::pair<double, std::vector<double>>> base;
+        for (const AstRelation* rel : rels) {
+            const AstRelationIdentifier& name = rel->getName();
+            std::vector<std::set<std::string>> values(rel->getArity());
+            double facts = 0;
+            for (AstClause* clause : rel->getClauses()) {
+                if (clause->isFact()) {
+                    facts++;
+                    std::vector<AstArgument*> args = clause->getHead()->getArguments();
+                    for (size_t i = 0; i < args.size() && i < values.size(); i++) {
+                        values[i].insert(toString(*args[i]));
+                    }
+                }
+            }
+            std::vector<double> cols(rel->getArity());
+            for (size_t i = 0; i < cols.size(); i++) {
+                cols[i] = values[i].size();
+            }
+            if (rel->isInput()) {
+                if (!readFacts(*rel)) {
+                    sizes[name] = DEFAULT_SIZE;
+                    distinct[name] = std::vector<double>(rel->getArity(), DEFAULT_SIZE);
+                }
+                facts += sizes[name];
+                for (size_t i = 0; i < cols.size(); i++) {
+                    cols[i] += distinct[name][i];
+                }
+            }
+            base[name] = std::make_pair(facts, cols);
+            sizes[name] = facts;
+            distinct[name] = cols;
+        }
+
+        // derive the statistics from the clauses, relations of recursive SCCs grow over several rounds
+        int rounds = sccGraph->isRecursive(scc) ? MAX_ROUNDS : 1;
+        for (int round = 0; round < rounds; round++) {
+            std::map<AstRelationIdentifier, std::pair<double, std::vector<double>>> next;
+            for (const AstRelation* rel : rels) {
+                double size = base[rel->getName()].first;
+                std::vector<double> cols = base[rel->getName()].second;
+                for (AstClause* clause : rel->getClauses()) {
+                    if (!clause->isFact()) {
+                        size += estimateClause(*clause, cols);
+                    }
+                }
+                // a relation holds at most one tuple per combination of distinct values
+                double combinations = 1;
+                for (double& values : cols) {
+                    values = std::min(values, size);
+                    combinations = std::min(combinations * values, MAX_SIZE);
+                }
+                next[rel->getName()] = std::make_pair(std::min(size, combinations), cols);
+            }
+            bool settled = true;
+            for (auto& cur : next) {
+                double previous = sizes[cur.first];
+                if (std::abs(cur.second.first - previous) > TOLERANCE * std::max(previous, 1.0)) {
+                    settled = false;
+                }
+                sizes[cur.first] = cur.second.first;
+                distinct[cur.first] = cur.second.second;
+            }
+            if (settled && round > 0) {
+                break;
+            }
+        }
+
+        // sizes recorded by a profile replace the estimates, scaling the distinct values alike
+        for (const AstRelation* rel : rels) {
+            const AstRelationIdentifier& name = rel->getName();
+            if (!profile->hasSize(name)) {
+                continue;
+            }
+            double size = profile->getSize(name);
+            double ratio = sizes[name] > 0 ? size / sizes[name] : 1;
+            for (double& values : distinct[name]) {
+                values = std::max(1.0, std::min(sizes[name] > 0 ? values * ratio : size, size));
+            }
+            sizes[name] = size;
+            measured.insert(name);
+        }
+    }
+}
+
+void RelationSizeAnalysis::print(std::ostream& os) const {
+    for (const auto& cur : sizes) {
+        os << cur.first << ": " << cur.second << " tuples, distinct values " << distinct.at(cur.first)
+           << (isMeasured(cur.first) ? " (measured)" : "") << std::endl;
+    }
+}
+
+double RelationSizeAnalysis::getSize(const AstRelationIdentifier& rel) const {
+    auto pos = sizes.find(rel);
+    return (pos != sizes.end()) ? pos->second : DEFAULT_SIZE;
+}
+
+double RelationSizeAnalysis::getDistinct(const AstRelationIdentifier& rel, size_t column) const {
+    auto pos = distinct.find(rel);
+    if (pos == distinct.end() || column >= pos->second.size()) {
+        return getSize(rel);
+    }
+    return pos->second[column];
+}
+
+double RelationSizeAnalysis::getMatches(const AstAtom& atom, const std::set<std::string>& bound) const {
+    double res = getSize(atom.getName());
+    std::vector<AstArgument*> args = atom.getArguments();
+    for (size_t i = 0; i < args.size(); i++) {
+        if (isBound(*args[i], bound)) {
+            res /= std::max(1.0, getDistinct(atom.getName(), i));
+        }
+    }
+    return res;
+}
+
+double RelationSizeAnalysis::getJoinSize(
+        const std::vector<AstAtom*>& atoms, std::set<std::string> bound) const {
+    double res = 1;
+    for (const AstAtom* atom : atoms) {
+        res = std::min(res * getMatches(*atom, bound), MAX_SIZE);
+        visitDepthFirst(*atom, [&](const AstVariable& var) { bound.insert(var.getName()); });
+    }
+    return res;
+}
+
+}  // end of namespace souffle
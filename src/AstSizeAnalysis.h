@@ -0,0 +1,101 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file AstSizeAnalysis.h
+ *
+ * Defines an analysis estimating the number of tuples of each relation
+ * and the number of distinct values of each of their columns.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "AstAnalysis.h"
+#include "AstRelationIdentifier.h"
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+class AstArgument;
+class AstAtom;
+class AstClause;
+class AstRelation;
+class AstTranslationUnit;
+
+/**
+ * Analysis pass estimating the cardinalities of relations and the number of
+ * distinct values of their columns.
+ *
+ * The statistics of input relations are obtained from their fact files, where
+ * the distinct values are counted on a sample of the tuples and extrapolated.
+ * Inputs without a readable fact file are assumed to be of a default size. The
+ * statistics of the remaining relations are derived from their clauses in
+ * topological order, assuming values to be distributed uniformly and columns
+ * to be independent; recursive relations are estimated by iterating their
+ * clauses until the estimates settle. Relations whose sizes were recorded by
+ * the profile of a previous run take on these sizes instead.
+ */
+class RelationSizeAnalysis : public AstAnalysis {
+private:
+    /** estimated number of tuples of each relation */
+    std::map<AstRelationIdentifier, double> sizes;
+
+    /** estimated number of distinct values of each column of each relation */
+    std::map<AstRelationIdentifier, std::vector<double>> distinct;
+
+    /** relations whose statistics were obtained from data or a profile rather than derived */
+    std::set<AstRelationIdentifier> measured;
+
+    /** obtain the statistics of an input relation from its fact file, returning whether it was found */
+    bool readFacts(const AstRelation& rel);
+
+    /** estimate the tuples derived by a clause, adding the distinct values of its head columns */
+    double estimateClause(const AstClause& clause, std::vector<double>& headDistinct) const;
+
+public:
+    static constexpr const char* name = "relation-sizes";
+
+    void run(const AstTranslationUnit& translationUnit) override;
+
+    void print(std::ostream& os) const override;
+
+    /** Get the estimated number of tuples of a relation */
+    double getSize(const AstRelationIdentifier& rel) const;
+
+    /** Get the estimated number of distinct values in a column of a relation */
+    double getDistinct(const AstRelationIdentifier& rel, size_t column) const;
+
+    /** Check whether the statistics of a relation were obtained from data */
+    bool isMeasured(const AstRelationIdentifier& rel) const {
+        return measured.count(rel) > 0;
+    }
+
+    /** Check whether an argument is bound by constants and the given variables */
+    static bool isBound(const AstArgument& arg, const std::set<std::string>& bound);
+
+    /** Add the variables of a clause equal to bound arguments to the given variables */
+    static void bindEqualities(const AstClause& clause, std::set<std::string>& bound);
+
+    /** Get the estimated number of tuples of an atom matching one binding of the given variables */
+    double getMatches(const AstAtom& atom, const std::set<std::string>& bound) const;
+
+    /**
+     * Get the estimated number of tuples produced by joining the given atoms in
+     * order, starting from one binding of the given variables.
+     */
+    double getJoinSize(const std::vector<AstAtom*>& atoms, std::set<std::string> bound) const;
+};
+
+}  // end of namespace souffle
@@ -19,17 +19,22 @@
 #include "AstClause.h"
 #include "AstLiteral.h"
 #include "AstNode.h"
+#include "AstProfileAnalysis.h"
 #include "AstProgram.h"
 #include "AstRelation.h"
 #include "AstRelationIdentifier.h"
+#include "AstSizeAnalysis.h"
 #include "AstTypeAnalysis.h"
 #include "AstTypes.h"
 #include "AstUtils.h"
 #include "AstVisitor.h"
 #include "BinaryConstraintOps.h"
+#include "ErrorReport.h"
+#include "Global.h"
 #include "GraphUtils.h"
 #include "PrecedenceGraph.h"
 #include "TypeSystem.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <functional>
@@ -37,6 +42,7 @@
 #include <memory>
 #include <ostream>
 #include <set>
+#include <sstream>
 
 namespace souffle {
 
@@ -843,6 +849,43 @@ bool RemoveRedundantRelationsTransformer::transform(AstTranslationUnit& translat
     return changed;
 }
 
+bool SelectOutputsTransformer::transform(AstTranslationUnit& translationUnit) {
+    AstProgram& program = *translationUnit.getProgram();
+
+    // obtain the comma-separated names of the selected relations
+    std::set<std::string> selected;
+    std::stringstream names(Global::config().get("outputs"));
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        if (!name.empty()) {
+            selected.insert(name);
+        }
+    }
+
+    std::set<std::string> computed;
+    for (AstRelation* rel : program.getRelations()) {
+        if (rel->isComputed()) {
+            computed.insert(toString(rel->getName()));
+        }
+    }
+    for (const std::string& cur : selected) {
+        if (computed.count(cur) == 0) {
+            translationUnit.getErrorReport().addDiagnostic(Diagnostic(Diagnostic::ERROR,
+                    DiagnosticMessage("Selected output " + cur + " is not an output relation")));
+        }
+    }
+
+    // relations not selected are neither stored nor size-printed
+    bool changed = false;
+    for (AstRelation* rel : program.getRelations()) {
+        if (rel->isComputed() && selected.count(toString(rel->getName())) == 0) {
+            rel->setQualifier(rel->getQualifier() & ~(OUTPUT_RELATION | PRINTSIZE_RELATION));
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 bool RemoveBooleanConstraintsTransformer::transform(AstTranslationUnit& translationUnit) {
     AstProgram& program = *translationUnit.getProgram();
 
@@ -1440,4 +1483,458 @@ bool NormaliseConstraintsTransformer::transform(AstTranslationUnit& translationU
     return changed;
 }
 
+std::vector<unsigned int> AutoScheduleTransformer::scheduleAtoms(
+        const AstClause& clause, const RelationSizeAnalysis& sizes, int delta, double deltaRatio) {
+    std::vector<AstAtom*> atoms = clause.getAtoms();
+    std::vector<bool> scheduled(atoms.size(), false);
+    std::vector<unsigned int> order;
+
+    std::set<std::string> bound;
+    RelationSizeAnalysis::bindEqualities(clause, bound);
+    while (order.size() < atoms.size()) {
+        // pick the atom matching the fewest tuples, preferring lookups binding more columns on ties
+        int best = -1;
+        double bestMatches = 0;
+        size_t bestBound = 0;
+        for (size_t i = 0; i < atoms.size(); i++) {
+            if (scheduled[i]) {
+                continue;
+            }
+            double matches = sizes.getMatches(*atoms[i], bound) * ((int)i == delta ? deltaRatio : 1);
+            size_t boundColumns = 0;
+            for (AstArgument* arg : atoms[i]->getArguments()) {
+                if (RelationSizeAnalysis::isBound(*arg, bound)) {
+                    boundColumns++;
+                }
+            }
+            if (best < 0 || matches < bestMatches || (matches == bestMatches && boundColumns > bestBound)) {
+                best = i;
+                bestMatches = matches;
+                bestBound = boundColumns;
+            }
+        }
+        scheduled[best] = true;
+        order.push_back(best);
+        visitDepthFirst(*atoms[best], [&](const AstVariable& var) { bound.insert(var.getName()); });
+        RelationSizeAnalysis::bindEqualities(clause, bound);
+    }
+    return order;
+}
+
+bool AutoScheduleTransformer::transform(AstTranslationUnit& translationUnit) {
+    const AstProgram* program = translationUnit.getProgram();
+    const auto* sizes = translationUnit.getAnalysis<RelationSizeAnalysis>();
+    const auto* relationSchedule = translationUnit.getAnalysis<RelationSchedule>();
+    const auto* recursiveClauses = translationUnit.getAnalysis<RecursiveClauses>();
+    const auto* profile = translationUnit.getAnalysis<ProfileUseAnalysis>();
+
+    // the estimated fraction of a recursive relation held by its delta relation in an iteration
+    const double deltaRatio = 0.1;
+
+    // guided by a profile alone, only the clauses dominating the runtime are reordered
+    bool hotOnly = !Global::config().has("auto-schedule");
+
+    bool changed = false;
+    for (const RelationScheduleStep& step : relationSchedule->schedule()) {
+        const std::set<const AstRelation*>& scc = step.computed();
+        for (const AstRelation* rel : scc) {
+            for (AstClause* clause : rel->getClauses()) {
+                std::vector<AstAtom*> atoms = clause->getAtoms();
+                if (atoms.size() < 2 || (hotOnly && !profile->isHot(*clause))) {
+                    continue;
+                }
+
+                // each atom of the same SCC is read from a delta relation in one version of the clause
+                std::vector<int> deltas;
+                if (recursiveClauses->recursive(clause)) {
+                    for (size_t i = 0; i < atoms.size(); i++) {
+                        if (scc.count(getAtomRelation(atoms[i], program)) > 0) {
+                            deltas.push_back(i);
+                        }
+                    }
+                }
+
+                // joins of two relations on variables only are conducted by hash joins, unless some
+                // variable is bound by a constant and better served by an index lookup
+                std::set<std::string> constants;
+                RelationSizeAnalysis::bindEqualities(*clause, constants);
+                if (deltas.empty() && constants.empty() && atoms.size() == 2 &&
+                        all_of(atoms, [](const AstAtom* atom) {
+                            return all_of(atom->getArguments(), [](const AstArgument* arg) {
+                                return dynamic_cast<const AstVariable*>(arg) != nullptr ||
+                                       dynamic_cast<const AstUnnamedVariable*>(arg) != nullptr;
+                            });
+                        })) {
+                    continue;
+                }
+                if (deltas.empty()) {
+                    deltas.push_back(-1);
+                }
+
+                // orders given by the program are kept, and source orders are not recorded
+                std::unique_ptr<AstExecutionPlan> plan(clause->getExecutionPlan()
+                                                               ? clause->getExecutionPlan()->clone()
+                                                               : new AstExecutionPlan());
+                bool planned = false;
+                for (size_t version = 0; version < deltas.size(); version++) {
+                    if (plan->hasOrderFor(version)) {
+                        continue;
+                    }
+                    // a delta relation holds the tuples of one iteration, as often as recorded
+                    double ratio = deltaRatio;
+                    if (deltas[version] >= 0) {
+                        size_t iterations = profile->getIterations(atoms[deltas[version]]->getName());
+                        ratio = iterations > 0 ? 1.0 / iterations : deltaRatio;
+                    }
+                    std::vector<unsigned int> order =
+                            scheduleAtoms(*clause, *sizes, deltas[version], ratio);
+                    if (std::is_sorted(order.begin(), order.end())) {
+                        continue;
+                    }
+                    auto executionOrder = std::make_unique<AstExecutionOrder>();
+                    for (unsigned int i : order) {
+                        executionOrder->appendAtomIndex(i + 1);
+                    }
+                    executionOrder->setSrcLoc(clause->getSrcLoc());
+                    plan->setOrderFor(version, std::move(executionOrder));
+                    planned = true;
+                }
+                if (planned) {
+                    clause->setExecutionPlan(std::move(plan));
+                    changed = true;
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+bool MaterializeSharedJoinsTransformer::transform(AstTranslationUnit& translationUnit) {
+    // the cost of inserting a tuple into a relation relative to enumerating it
+    const double insertCost = 3;
+
+    if (Global::config().has("provenance")) {
+        return false;
+    }
+    AstProgram& program = *translationUnit.getProgram();
+    const auto* sizes = translationUnit.getAnalysis<RelationSizeAnalysis>();
+
+    // the prefix of the names of relations materialising joins
+    const std::string prefix = "__shared_join_";
+
+    // the clauses containing the same join of two of their atoms, each with the positions of these atoms
+    // among its atoms, the atoms in the order of the join, and the variables of the join in the order of
+    // their first occurrence
+    struct JoinUse {
+        AstClause* clause;
+        std::pair<size_t, size_t> positions;
+        std::vector<AstAtom*> atoms;
+        std::vector<std::string> vars;
+    };
+    std::map<std::string, std::vector<JoinUse>> joins;
+
+    // obtain the text of the join of two atoms, where variables are numbered by their first occurrence
+    auto getJoinText = [](const AstAtom* first, const AstAtom* second, std::vector<std::string>& vars) {
+        std::stringstream text;
+        vars.clear();
+        for (const AstAtom* atom : {first, second}) {
+            text << atom->getName() << "(";
+            for (AstArgument* arg : atom->getArguments()) {
+                if (auto* var = dynamic_cast<AstVariable*>(arg)) {
+                    auto pos = std::find(vars.begin(), vars.end(), var->getName());
+                    text << "v" << (pos - vars.begin());
+                    if (pos == vars.end()) {
+                        vars.push_back(var->getName());
+                    }
+                } else {
+                    text << "_";
+                }
+                text << ",";
+            }
+            text << ")";
+        }
+        return text.str();
+    };
+
+    // any two atoms of a clause sharing a variable form a join; a join reading a relation of the
+    // recursive stratum of its clause becomes part of that stratum, where semi-naive evaluation
+    // maintains it from the delta versions of its atoms
+    for (AstRelation* rel : program.getRelations()) {
+        // the joins materialised in earlier applications are not shared again
+        if (toString(rel->getName()).compare(0, prefix.size(), prefix) == 0) {
+            continue;
+        }
+        for (AstClause* clause : rel->getClauses()) {
+            std::vector<AstAtom*> atoms = clause->getAtoms();
+            if (atoms.size() < 2 || clause->getExecutionPlan() != nullptr) {
+                continue;
+            }
+
+            // only atoms of relations on variables are joined
+            std::vector<bool> joinable(atoms.size());
+            std::vector<std::set<std::string>> atomVars(atoms.size());
+            for (size_t i = 0; i < atoms.size(); i++) {
+                joinable[i] = getAtomRelation(atoms[i], &program) != nullptr;
+                for (AstArgument* arg : atoms[i]->getArguments()) {
+                    if (auto* var = dynamic_cast<AstVariable*>(arg)) {
+                        atomVars[i].insert(var->getName());
+                    } else if (dynamic_cast<AstUnnamedVariable*>(arg) == nullptr) {
+                        joinable[i] = false;
+                    }
+                }
+            }
+
+            // each join is used at most once per clause
+            std::set<std::string> found;
+            for (size_t i = 0; i < atoms.size(); i++) {
+                for (size_t j = i + 1; j < atoms.size(); j++) {
+                    if (!joinable[i] || !joinable[j] || !any_of(atomVars[i], [&](const std::string& var) {
+                            return atomVars[j].count(var) > 0;
+                        })) {
+                        continue;
+                    }
+
+                    // joins are identified regardless of the order of their atoms
+                    JoinUse use{clause, {i, j}, {atoms[i], atoms[j]}, {}};
+                    std::vector<std::string> swappedVars;
+                    std::string text = getJoinText(atoms[i], atoms[j], use.vars);
+                    std::string swappedText = getJoinText(atoms[j], atoms[i], swappedVars);
+                    if (swappedText < text) {
+                        use.positions = {j, i};
+                        use.atoms = {atoms[j], atoms[i]};
+                        use.vars = swappedVars;
+                        text = swappedText;
+                    }
+                    if (found.insert(text).second) {
+                        joins[text].push_back(use);
+                    }
+                }
+            }
+        }
+    }
+
+    // determine the variables of a join used by the remainder of each clause, and the estimated cost
+    // saved by materialising it: the join scans its first relation and looks up the second one for
+    // each tuple, while its materialisation is computed once and holds at most one tuple per
+    // combination of values
+    auto getSavings = [&](const std::vector<JoinUse>& uses, std::vector<bool>& needed,
+                              std::vector<std::vector<bool>>& neededBy) {
+        const std::vector<std::string>& vars = uses.front().vars;
+        needed.assign(vars.size(), false);
+        neededBy.clear();
+        for (const JoinUse& use : uses) {
+            std::map<std::string, int> occurrences;
+            visitDepthFirst(*use.clause, [&](const AstVariable& var) { occurrences[var.getName()]++; });
+            for (const AstAtom* atom : use.atoms) {
+                visitDepthFirst(*atom, [&](const AstVariable& var) { occurrences[var.getName()]--; });
+            }
+            neededBy.emplace_back();
+            for (size_t i = 0; i < use.vars.size(); i++) {
+                neededBy.back().push_back(occurrences[use.vars[i]] > 0);
+                needed[i] = needed[i] || neededBy.back().back();
+            }
+        }
+
+        const std::vector<AstAtom*>& atoms = uses.front().atoms;
+        double joinSize = sizes->getJoinSize(atoms, std::set<std::string>());
+        double evaluation = 2 * sizes->getSize(atoms[0]->getName()) + joinSize;
+        double tuples = 1;
+        for (size_t i = 0; i < vars.size(); i++) {
+            if (!needed[i]) {
+                continue;
+            }
+            double values = joinSize;
+            for (const AstAtom* atom : atoms) {
+                for (size_t col = 0; col < atom->getArity(); col++) {
+                    auto* var = dynamic_cast<const AstVariable*>(atom->getArgument(col));
+                    if (var != nullptr && var->getName() == vars[i]) {
+                        values = std::min(values, sizes->getDistinct(atom->getName(), col));
+                    }
+                }
+            }
+            tuples = std::min(tuples * values, joinSize);
+        }
+        double count = uses.size();
+        return count * evaluation - (evaluation + insertCost * tuples + count * tuples);
+    };
+
+    // joins saving the most are materialised first, and each clause is rewritten once per application
+    std::vector<std::pair<double, std::string>> candidates;
+    for (const auto& cur : joins) {
+        std::vector<bool> needed;
+        std::vector<std::vector<bool>> neededBy;
+        if (cur.second.size() >= 2) {
+            candidates.emplace_back(-getSavings(cur.second, needed, neededBy), cur.first);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    bool changed = false;
+    int counter = 0;
+    std::set<const AstClause*> rewritten;
+    for (const auto& candidate : candidates) {
+        std::vector<JoinUse> uses;
+        for (const JoinUse& use : joins[candidate.second]) {
+            if (rewritten.count(use.clause) == 0) {
+                uses.push_back(use);
+            }
+        }
+        std::vector<bool> needed;
+        std::vector<std::vector<bool>> neededBy;
+        if (uses.size() < 2 || getSavings(uses, needed, neededBy) <= 0) {
+            continue;
+        }
+        const std::vector<AstAtom*>& atoms = uses.front().atoms;
+        const std::vector<std::string>& vars = uses.front().vars;
+
+        // -- create a relation computing the join --
+
+        std::string relName = prefix + toString(counter++);
+        while (program.getRelation(relName) != nullptr) {
+            relName = prefix + toString(counter++);
+        }
+        auto rel = std::make_unique<AstRelation>();
+        rel->setName(relName);
+        auto head = std::make_unique<AstAtom>(relName);
+        for (size_t i = 0; i < vars.size(); i++) {
+            if (!needed[i]) {
+                continue;
+            }
+            // the type of a variable is the type of the first column it occurs in
+            AstTypeIdentifier type;
+            bool typed = false;
+            for (const AstAtom* atom : atoms) {
+                for (size_t col = 0; col < atom->getArity() && !typed; col++) {
+                    auto* var = dynamic_cast<const AstVariable*>(atom->getArgument(col));
+                    if (var != nullptr && var->getName() == vars[i]) {
+                        type = getAtomRelation(atom, &program)->getAttribute(col)->getTypeName();
+                        typed = true;
+                    }
+                }
+            }
+            rel->addAttribute(std::make_unique<AstAttribute>(vars[i], type));
+            head->addArgument(std::make_unique<AstVariable>(vars[i]));
+        }
+        auto joinClause = std::make_unique<AstClause>();
+        joinClause->setSrcLoc(uses.front().clause->getSrcLoc());
+        joinClause->setHead(std::move(head));
+        for (const AstAtom* atom : atoms) {
+            joinClause->addToBody(std::unique_ptr<AstLiteral>(atom->clone()));
+        }
+        rel->addClause(std::move(joinClause));
+        program.appendRelation(std::move(rel));
+
+        // -- replace the join in each clause by an atom at the position of its first atom --
+
+        for (size_t use = 0; use < uses.size(); use++) {
+            AstClause* clause = uses[use].clause;
+            const std::vector<std::string>& useVars = uses[use].vars;
+            auto atom = std::make_unique<AstAtom>(relName);
+            for (size_t i = 0; i < useVars.size(); i++) {
+                if (neededBy[use][i]) {
+                    atom->addArgument(std::make_unique<AstVariable>(useVars[i]));
+                } else if (needed[i]) {
+                    atom->addArgument(std::make_unique<AstUnnamedVariable>());
+                }
+            }
+
+            std::unique_ptr<AstClause> res(clause->cloneHead());
+            res->setGenerated(clause->isGenerated());
+            std::vector<AstAtom*> clauseAtoms = clause->getAtoms();
+            const std::pair<size_t, size_t>& positions = uses[use].positions;
+            const AstAtom* first = clauseAtoms[std::min(positions.first, positions.second)];
+            const AstAtom* second = clauseAtoms[std::max(positions.first, positions.second)];
+            for (AstLiteral* lit : clause->getBodyLiterals()) {
+                if (lit == first) {
+                    res->addToBody(std::move(atom));
+                } else if (lit != second) {
+                    res->addToBody(std::unique_ptr<AstLiteral>(lit->clone()));
+                }
+            }
+            rewritten.insert(clause);
+            program.removeClause(clause);
+            program.appendClause(std::move(res));
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool SelectDataStructuresTransformer::transform(AstTranslationUnit& translationUnit) {
+    // the number of tuples from which on a hash set outperforms the default b-tree
+    const size_t minSize = 10000;
+
+    if (Global::config().has("data-structure") || Global::config().has("provenance")) {
+        return false;
+    }
+    AstProgram* program = translationUnit.getProgram();
+    const auto* profile = translationUnit.getAnalysis<ProfileUseAnalysis>();
+
+    // collect the relations searched by a part of their columns, which requires an ordered index
+    std::set<AstRelationIdentifier> partiallySearched;
+    auto search = [&](const AstAtom& atom, const std::set<std::string>& bound) {
+        size_t boundColumns = 0;
+        for (AstArgument* arg : atom.getArguments()) {
+            if (RelationSizeAnalysis::isBound(*arg, bound)) {
+                boundColumns++;
+            }
+        }
+        if (boundColumns > 0 && boundColumns < atom.getArity()) {
+            partiallySearched.insert(atom.getName());
+        }
+    };
+    for (AstRelation* rel : program->getRelations()) {
+        for (AstClause* clause : rel->getClauses()) {
+            std::vector<AstAtom*> atoms = clause->getAtoms();
+
+            // the atoms are evaluated in the order of the clause or in an order of its execution plan
+            std::vector<std::vector<size_t>> orders(1);
+            for (size_t i = 0; i < atoms.size(); i++) {
+                orders[0].push_back(i);
+            }
+            if (const AstExecutionPlan* plan = clause->getExecutionPlan()) {
+                for (const auto& cur : plan->getOrders()) {
+                    orders.emplace_back();
+                    for (int i : *cur.second) {
+                        orders.back().push_back(i - 1);
+                    }
+                }
+            }
+
+            for (const std::vector<size_t>& order : orders) {
+                std::set<std::string> bound;
+                RelationSizeAnalysis::bindEqualities(*clause, bound);
+                for (size_t i : order) {
+                    if (i >= atoms.size()) {
+                        continue;
+                    }
+                    search(*atoms[i], bound);
+                    visitDepthFirst(*atoms[i], [&](const AstVariable& var) { bound.insert(var.getName()); });
+                    RelationSizeAnalysis::bindEqualities(*clause, bound);
+                }
+
+                // negations and aggregates are evaluated with the variables of all atoms bound
+                for (AstLiteral* lit : clause->getBodyLiterals()) {
+                    if (dynamic_cast<AstAtom*>(lit) == nullptr) {
+                        visitDepthFirst(*lit, [&](const AstAtom& atom) { search(atom, bound); });
+                    }
+                }
+            }
+        }
+    }
+
+    const int dataStructures = BRIE_RELATION | BTREE_RELATION | EQREL_RELATION | RBTSET_RELATION |
+                               HASHSET_RELATION | COLUMNAR_RELATION | COMPRESSED_RELATION | SPILL_RELATION;
+    bool changed = false;
+    for (AstRelation* rel : program->getRelations()) {
+        if ((rel->getQualifier() & dataStructures) != 0 || rel->getArity() == 0 ||
+                partiallySearched.count(rel->getName()) > 0 || profile->getSize(rel->getName()) < minSize) {
+            continue;
+        }
+        rel->setQualifier(rel->getQualifier() | HASHSET_RELATION);
+        changed = true;
+    }
+    return changed;
+}
+
 }  // end of namespace souffle
@@ -31,6 +31,7 @@ namespace souffle {
 class AstClause;
 class AstProgram;
 class AstRelation;
+class RelationSizeAnalysis;
 
 /**
  * Transformation pass to eliminate grounded aliases.
@@ -190,6 +191,21 @@ public:
     }
 };
 
+/**
+ * Transformation pass to restrict the outputs of a program to the relations selected
+ * via the outputs option. Other relations are no longer output or size-printed, thus
+ * relations the selected ones do not depend on are subsequently found to be redundant.
+ */
+class SelectOutputsTransformer : public AstTransformer {
+private:
+    bool transform(AstTranslationUnit& translationUnit) override;
+
+public:
+    std::string getName() const override {
+        return "SelectOutputsTransformer";
+    }
+};
+
 /**
  * Transformation pass to add provenance information via guided SLD
  */
@@ -290,6 +306,76 @@ public:
     }
 };
 
+/**
+ * Transformation pass choosing the order of the atoms of clauses without an
+ * execution plan, based on the estimated cardinalities of relations and the
+ * selectivities of their columns. Each semi-naive version of a recursive clause
+ * obtains its own order, where the delta relation is estimated to hold a small
+ * fraction of the recursive relation, or the share of one iteration recorded by
+ * a profile. Given a profile only, the clauses dominating its runtime are ordered.
+ */
+class AutoScheduleTransformer : public AstTransformer {
+private:
+    bool transform(AstTranslationUnit& translationUnit) override;
+
+    /**
+     * Order the atoms of a clause greedily, such that each next atom is the one
+     * expected to match the fewest tuples given the variables bound so far.
+     *
+     * @param clause the clause to be ordered
+     * @param sizes the estimated cardinalities of relations
+     * @param delta the index of the atom read from a delta relation, negative if none
+     * @param deltaRatio the fraction of its relation held by the delta relation
+     * @return the indices of the atoms in the order of evaluation
+     */
+    static std::vector<unsigned int> scheduleAtoms(
+            const AstClause& clause, const RelationSizeAnalysis& sizes, int delta, double deltaRatio);
+
+public:
+    std::string getName() const override {
+        return "AutoScheduleTransformer";
+    }
+};
+
+/**
+ * Transformation pass materialising joins shared by several clauses. If any two
+ * atoms sharing a variable join the same relations on the same variables in
+ * several clauses without an execution plan, the join is computed once into a
+ * new relation, which replaces the two atoms in each of these clauses. Applied
+ * until a fixpoint is reached, joins of more atoms are materialised as well. A
+ * join is only materialised if the estimated cost of inserting its tuples is
+ * offset by the evaluations of the join saved, and the joins saving the most are
+ * chosen first. Joins reading a relation of the recursive stratum of their clause
+ * become part of it, such that semi-naive evaluation maintains them from the
+ * delta versions of their atoms.
+ */
+class MaterializeSharedJoinsTransformer : public AstTransformer {
+private:
+    bool transform(AstTranslationUnit& translationUnit) override;
+
+public:
+    std::string getName() const override {
+        return "MaterializeSharedJoinsTransformer";
+    }
+};
+
+/**
+ * Transformation pass choosing hash sets for relations that the profile of a
+ * previous run found to be large, and that are only scanned or looked up by
+ * all of their columns in the orders of evaluation of the program. Relations
+ * with a data structure given by the program or the data-structure option keep
+ * it.
+ */
+class SelectDataStructuresTransformer : public AstTransformer {
+private:
+    bool transform(AstTranslationUnit& translationUnit) override;
+
+public:
+    std::string getName() const override {
+        return "SelectDataStructuresTransformer";
+    }
+};
+
 /**
  * Magic Set Transformation
  */
@@ -23,6 +23,7 @@
 #include "AstNode.h"
 #include "AstProgram.h"
 #include "AstRelation.h"
+#include "AstSizeAnalysis.h"
 #include "AstTranslationUnit.h"
 #include "AstTypeAnalysis.h"
 #include "AstUtils.h"
@@ -55,6 +56,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -209,7 +211,208 @@ std::unique_ptr<RamRelation> getRamRelation(const AstRelation* rel, const TypeEn
 
     return std::make_unique<RamRelation>(name, arity, attributeNames, attributeTypeQualifiers,
             getSymbolMask(*rel, *typeEnv), rel->isInput(), rel->isComputed(), rel->isOutput(), rel->isBTree(),
-            rel->isRbtset(), rel->isHashset(), rel->isBrie(), rel->isEqRel(), istemp);
+            rel->isRbtset(), rel->isHashset(), rel->isBrie(), rel->isEqRel(), rel->isColumnar(),
+            rel->isCompressed(), rel->isSpill(), istemp);
+}
+
+/**
+ * Get a relation of the program, or one of the temporary relations kept for it by incremental
+ * updates as named by the given prefix, e.g. its delta or the tuples it gained by an update.
+ * The changes of relations are stored by default relations.
+ */
+std::unique_ptr<RamRelation> getKeptRelation(
+        const AstRelation* rel, const TypeEnvironment& typeEnv, const std::string& prefix = "") {
+    bool isChange = prefix.find("added_") == 0 || prefix.find("removed_") == 0;
+    return getRamRelation(isChange ? nullptr : rel, &typeEnv, prefix + getRelationName(rel->getName()),
+            rel->getArity(), !prefix.empty(), !isChange && rel->isHashset());
+}
+
+/**
+ * Determines whether the given relation is represented by a brie.
+ */
+bool isBrieRelation(const AstRelation* rel) {
+    if (!rel) {
+        return false;
+    }
+    if (rel->isBrie()) {
+        return true;
+    }
+    if (rel->isBTree() || rel->isRbtset() || rel->isHashset() || rel->isEqRel() || rel->isColumnar() ||
+            rel->isCompressed() || rel->isSpill()) {
+        return false;
+    }
+    return Global::config().get("data-structure") == "brie";
+}
+
+/**
+ * Determines whether the hypergraph formed by the given sets of variables is
+ * cyclic, utilizing the GYO reduction.
+ */
+bool isCyclic(std::vector<std::set<std::string>> edges) {
+    bool changed = true;
+    while (changed && edges.size() > 1) {
+        changed = false;
+
+        // remove variables only occurring in a single edge
+        for (auto& edge : edges) {
+            for (auto it = edge.begin(); it != edge.end();) {
+                bool isolated = std::none_of(edges.begin(), edges.end(), [&](const std::set<std::string>& other) {
+                    return &other != &edge && other.count(*it) > 0;
+                });
+                if (isolated) {
+                    it = edge.erase(it);
+                    changed = true;
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // remove edges contained in another edge
+        for (size_t i = 0; i < edges.size(); i++) {
+            for (size_t j = 0; j < edges.size(); j++) {
+                if (i != j && std::includes(edges[j].begin(), edges[j].end(), edges[i].begin(),
+                                      edges[i].end())) {
+                    edges.erase(edges.begin() + i);
+                    changed = true;
+                    i--;
+                    break;
+                }
+            }
+        }
+    }
+    return edges.size() > 1;
+}
+
+/**
+ * Determines whether the atoms of the given clause are to be joined by a
+ * single leapfrog triejoin instead of nested scans. This is the case for
+ * cyclic joins of at least three bries binding distinct variables only, for
+ * which the worst-case optimal join is superior to any nested loop plan.
+ */
+bool isLeapfrogJoinable(const AstClause& clause, const AstClause& originalClause, const AstProgram* program) {
+    const auto& atoms = clause.getAtoms();
+    if (!program || atoms.size() < 3) {
+        return false;
+    }
+
+    // all joined relations have to be represented by bries
+    for (const AstAtom* atom : originalClause.getAtoms()) {
+        if (!isBrieRelation(getAtomRelation(atom, program))) {
+            return false;
+        }
+    }
+
+    // all atoms have to bind distinct variables
+    std::vector<std::set<std::string>> edges;
+    for (const AstAtom* atom : atoms) {
+        std::set<std::string> vars;
+        for (const AstArgument* arg : atom->getArguments()) {
+            const auto* var = dynamic_cast<const AstVariable*>(arg);
+            if (!var || !vars.insert(var->getName()).second) {
+                return false;
+            }
+        }
+        if (vars.empty()) {
+            return false;
+        }
+        edges.push_back(vars);
+    }
+
+    return isCyclic(edges);
+}
+
+/**
+ * Determines whether the two atoms of the given clause are to be joined by a
+ * hash join instead of nested scans. This is the case for rules joining two
+ * relations on variables only that are not a semi-naive version of a
+ * recursive rule, such that the transient hash table is built only once and
+ * no index is required for the join.
+ */
+bool isHashJoinable(const AstClause& clause, const AstProgram* program) {
+    const auto& atoms = clause.getAtoms();
+    if (!program || atoms.size() != 2 || clause.hasFixedExecutionPlan()) {
+        return false;
+    }
+
+    std::set<std::string> vars;
+    for (const AstAtom* atom : atoms) {
+        // semi-naive versions of recursive rules read auxiliary delta relations
+        if (!getAtomRelation(atom, program)) {
+            return false;
+        }
+
+        // constants are served by index lookups
+        for (const AstArgument* arg : atom->getArguments()) {
+            if (!dynamic_cast<const AstVariable*>(arg) && !dynamic_cast<const AstUnnamedVariable*>(arg)) {
+                return false;
+            }
+        }
+    }
+
+    // the atoms have to share a variable
+    for (const AstArgument* arg : atoms[0]->getArguments()) {
+        if (const auto* var = dynamic_cast<const AstVariable*>(arg)) {
+            vars.insert(var->getName());
+        }
+    }
+    return any_of(atoms[1]->getArguments(), [&](const AstArgument* arg) {
+        const auto* var = dynamic_cast<const AstVariable*>(arg);
+        return var && vars.count(var->getName()) > 0;
+    });
+}
+
+/**
+ * Collects the columns on which the atoms of the clauses of a program search their relations.
+ * The automatic index selection provides an index for each of these searches, apart from those of
+ * clauses conducted by a hash join.
+ */
+std::map<AstRelationIdentifier, std::set<SearchColumns>> getIndexedSearches(const AstProgram& program) {
+    std::map<AstRelationIdentifier, std::set<SearchColumns>> searches;
+    for (AstRelation* rel : program.getRelations()) {
+        for (AstClause* clause : rel->getClauses()) {
+            std::vector<AstAtom*> atoms = clause->getAtoms();
+
+            // the atoms are evaluated in the order of the clause or in an order of its execution plan
+            std::vector<std::vector<size_t>> orders;
+            if (!isHashJoinable(*clause, &program)) {
+                orders.emplace_back();
+                for (size_t i = 0; i < atoms.size(); i++) {
+                    orders[0].push_back(i);
+                }
+            }
+            if (const AstExecutionPlan* plan = clause->getExecutionPlan()) {
+                for (const auto& cur : plan->getOrders()) {
+                    orders.emplace_back();
+                    for (int i : *cur.second) {
+                        orders.back().push_back(i - 1);
+                    }
+                }
+            }
+
+            for (const std::vector<size_t>& order : orders) {
+                std::set<std::string> bound;
+                RelationSizeAnalysis::bindEqualities(*clause, bound);
+                for (size_t i : order) {
+                    if (i >= atoms.size()) {
+                        continue;
+                    }
+                    SearchColumns keys = 0;
+                    for (size_t j = 0; j < atoms[i]->argSize(); j++) {
+                        if (RelationSizeAnalysis::isBound(*atoms[i]->getArgument(j), bound)) {
+                            keys |= (1 << j);
+                        }
+                    }
+                    if (keys != 0) {
+                        searches[atoms[i]->getName()].insert(keys);
+                    }
+                    visitDepthFirst(*atoms[i], [&](const AstVariable& var) { bound.insert(var.getName()); });
+                    RelationSizeAnalysis::bindEqualities(*clause, bound);
+                }
+            }
+        }
+    }
+    return searches;
 }
 
 }  // namespace
@@ -489,10 +692,16 @@ std::unique_ptr<RamStatement> AstTranslator::translateClause(const AstClause& cl
     // get extract some details
     const AstAtom& head = *clause.getHead();
 
-    // a utility to translate atoms to relations
-    auto getRelation = [&](const AstAtom* atom) {
-        return getRamRelation((program ? getAtomRelation(atom, program) : nullptr), typeEnv,
-                getRelationName(atom->getName()), atom->getArity(), false, hashset);
+    // a utility to translate atoms to relations; atoms renamed to temporary relations refer to no relation
+    // of the program
+    auto getRelation = [&](const AstAtom* atom) -> std::unique_ptr<RamRelation> {
+        const AstRelation* rel = (program ? getAtomRelation(atom, program) : nullptr);
+        if (program && !rel) {
+            return std::make_unique<RamRelation>(
+                    getRelationName(atom->getName()), atom->getArity(), true, hashset);
+        }
+        return getRamRelation(
+                rel, typeEnv, getRelationName(atom->getName()), atom->getArity(), false, hashset);
     };
 
     // handle facts
@@ -717,6 +926,103 @@ std::unique_ptr<RamStatement> AstTranslator::translateClause(const AstClause& cl
         }
     }
 
+    // obtain the frequency-profiling label of the scan of an atom
+    auto getProfileText = [&](const AstAtom* atom, size_t level) {
+        std::stringstream ss;
+        ss << clause.getHead()->getName();
+        std::string relName = ss.str();
+        ss.str("");
+
+        if (modifiedIdMap.find(relName) != modifiedIdMap.end()) {
+            relName = modifiedIdMap[relName];
+        }
+
+        ss << "@frequency-atom" << ';';
+        ss << relName << ';';
+        ss << version << ';';
+        ss << stringify(toString(clause)) << ';';
+        ss << stringify(toString(*atom)) << ';';
+        ss << stringify(toString(originalClause)) << ';';
+        ss << level << ';';
+        return ss.str();
+    };
+
+    // cyclic joins of bries are conducted by a single leapfrog triejoin
+    bool isLeapfrogJoin = !ret && aggregators.empty() && op_nesting.size() == clause.getAtoms().size() &&
+                          !Global::config().has("provenance") &&
+                          isLeapfrogJoinable(clause, originalClause, program);
+    if (isLeapfrogJoin) {
+        // number variables in the order of their first appearance
+        std::map<std::string, size_t> varIds;
+        std::vector<std::unique_ptr<RamRelation>> rels;
+        std::vector<std::vector<size_t>> vars;
+        for (const AstAtom* atom : clause.getAtoms()) {
+            rels.push_back(getRelation(atom));
+            vars.emplace_back();
+            for (const AstArgument* arg : atom->getArguments()) {
+                const std::string& name = static_cast<const AstVariable*>(arg)->getName();
+                auto pos = varIds.insert(std::make_pair(name, varIds.size())).first;
+                vars.back().push_back(pos->second);
+            }
+        }
+
+        std::string profileText;
+        if (Global::config().has("profile")) {
+            profileText = getProfileText(clause.getAtoms().back(), op_nesting.size() - 1);
+        }
+        op = std::make_unique<RamLeapfrogJoin>(std::move(rels), std::move(vars), std::move(op), profileText);
+        op_nesting.clear();
+    }
+
+    // joins of two relations in non-recursive rules are conducted by a hash join, unless the
+    // second one is a mere existence check or an index already serves the join
+    bool isHashJoin = !isLeapfrogJoin && !ret && aggregators.empty() &&
+                      op_nesting.size() == clause.getAtoms().size() && !Global::config().has("provenance") &&
+                      isHashJoinable(clause, program) && valueIndex.isSomethingDefinedOn(1);
+    std::vector<size_t> leftKeys;
+    std::vector<size_t> rightKeys;
+    if (isHashJoin) {
+        const AstAtom* left = clause.getAtoms()[0];
+        const AstAtom* right = clause.getAtoms()[1];
+
+        // join on the first occurrences of the shared variables
+        std::set<std::string> joined;
+        for (size_t i = 0; i < right->argSize(); i++) {
+            const auto* var = dynamic_cast<const AstVariable*>(right->getArgument(i));
+            if (!var || !joined.insert(var->getName()).second) {
+                continue;
+            }
+            for (size_t j = 0; j < left->argSize(); j++) {
+                const auto* cur = dynamic_cast<const AstVariable*>(left->getArgument(j));
+                if (cur && cur->getName() == var->getName()) {
+                    leftKeys.push_back(j);
+                    rightKeys.push_back(i);
+                    break;
+                }
+            }
+        }
+
+        // an index maintained for other searches of the second relation serves the join without a hash table
+        SearchColumns keys = 0;
+        for (size_t cur : rightKeys) {
+            keys |= (1 << cur);
+        }
+        auto pos = indexedSearches.find(right->getName());
+        isHashJoin = pos == indexedSearches.end() || pos->second.count(keys) == 0;
+    }
+    if (isHashJoin) {
+        const AstAtom* left = clause.getAtoms()[0];
+        const AstAtom* right = clause.getAtoms()[1];
+
+        std::string profileText;
+        if (Global::config().has("profile")) {
+            profileText = getProfileText(right, 1);
+        }
+        op = std::make_unique<RamHashJoin>(getRelation(left), getRelation(right), std::move(leftKeys),
+                std::move(rightKeys), std::move(op), profileText);
+        op_nesting.clear();
+    }
+
     // build operation bottom-up
     while (!op_nesting.empty()) {
         // get next operator
@@ -737,23 +1043,8 @@ std::unique_ptr<RamStatement> AstTranslator::translateClause(const AstClause& cl
 
             // add a scan level
             if (Global::config().has("profile")) {
-                std::stringstream ss;
-                ss << clause.getHead()->getName();
-                std::string relName = ss.str();
-                ss.str("");
-
-                if (modifiedIdMap.find(relName) != modifiedIdMap.end()) {
-                    relName = modifiedIdMap[relName];
-                }
-
-                ss << "@frequency-atom" << ';';
-                ss << relName << ';';
-                ss << version << ';';
-                ss << stringify(toString(clause)) << ';';
-                ss << stringify(toString(*atom)) << ';';
-                ss << stringify(toString(originalClause)) << ';';
-                ss << level << ';';
-                op = std::make_unique<RamScan>(getRelation(atom), std::move(op), isExistCheck, ss.str());
+                op = std::make_unique<RamScan>(
+                        getRelation(atom), std::move(op), isExistCheck, getProfileText(atom, level));
             } else {
                 op = std::make_unique<RamScan>(getRelation(atom), std::move(op), isExistCheck);
             }
@@ -793,8 +1084,11 @@ std::unique_ptr<RamStatement> AstTranslator::translateClause(const AstClause& cl
         }
     }
 
-    /* add equivalence constraints imposed by variable binding */
+    /* add equivalence constraints imposed by variable binding, implied by a leapfrog triejoin */
     for (const auto& cur : valueIndex.getVariableReferences()) {
+        if (isLeapfrogJoin) {
+            break;
+        }
         // the first appearance
         const Location& first = *cur.second.begin();
         // all other appearances
@@ -979,6 +1273,73 @@ void nameUnnamedVariables(AstClause* clause) {
         atom->apply(init);
     }
 }
+
+/**
+ * Creates an atom of the given relation whose arguments are distinct variables.
+ */
+std::unique_ptr<AstAtom> makeVariableAtom(const std::string& name, size_t arity) {
+    auto res = std::make_unique<AstAtom>(name);
+    for (size_t i = 0; i < arity; i++) {
+        res->addArgument(std::make_unique<AstVariable>(" _var" + toString(i)));
+    }
+    return res;
+}
+
+/**
+ * Creates an atom of the given relation matching the head of a clause. Arguments of the head other
+ * than variables and constants are bound to fresh variables by constraints added to the clause.
+ */
+std::unique_ptr<AstAtom> matchHead(AstClause& clause, const std::string& name) {
+    auto res = std::make_unique<AstAtom>(name);
+    const auto& args = clause.getHead()->getArguments();
+    for (size_t i = 0; i < args.size(); i++) {
+        if (dynamic_cast<const AstVariable*>(args[i]) || dynamic_cast<const AstConstant*>(args[i])) {
+            res->addArgument(std::unique_ptr<AstArgument>(args[i]->clone()));
+            continue;
+        }
+        auto var = " _head_var" + toString(i);
+        clause.addToBody(std::make_unique<AstBinaryConstraint>(BinaryConstraintOp::EQ,
+                std::make_unique<AstVariable>(var), std::unique_ptr<AstArgument>(args[i]->clone())));
+        res->addArgument(std::make_unique<AstVariable>(var));
+    }
+    return res;
+}
+
+/**
+ * Moves the atom of the given index to the front of the body of a clause, such that its evaluation
+ * starts from the tuples of that atom.
+ */
+void moveAtomToFront(AstClause& clause, size_t index) {
+    std::vector<unsigned int> order = {static_cast<unsigned int>(index)};
+    for (size_t i = 0; i < clause.getAtoms().size(); i++) {
+        if (i != index) {
+            order.push_back(i);
+        }
+    }
+    clause.reorderAtoms(order);
+}
+
+/**
+ * Determines whether incremental updates may maintain the relations of a strongly-connected
+ * component from the changes of the relations it depends on. Aggregates, counters and
+ * equivalence relations are not maintained, neither are relations explained by provenance.
+ */
+bool isMaintainable(const std::set<const AstRelation*>& scc, const AstProgram* program) {
+    if (Global::config().has("provenance")) {
+        return false;
+    }
+    bool res = true;
+    for (const AstRelation* rel : scc) {
+        res = res && !rel->isEqRel();
+        visitDepthFirst(rel->getClauses(), [&](const AstAtom& atom) {
+            const AstRelation* cur = getAtomRelation(&atom, program);
+            res = res && !(cur && cur->isEqRel());
+        });
+        visitDepthFirst(rel->getClauses(), [&](const AstAggregator&) { res = false; });
+        visitDepthFirst(rel->getClauses(), [&](const AstCounter&) { res = false; });
+    }
+    return res;
+}
 }  // namespace
 
 /** generate RAM code for recursive relations in a strongly-connected component */
@@ -1029,11 +1390,18 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
                     LogStatement::cRecursiveRelation(toString(rel->getName()), rel->getSrcLoc()));
         }
 
-        /* drop temporary tables after recursion */
-        appendStmt(postamble,
-                std::make_unique<RamSequence>(
-                        std::make_unique<RamDrop>(std::unique_ptr<RamRelation>(relDelta[rel]->clone())),
-                        std::make_unique<RamDrop>(std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
+        /* drop temporary tables after recursion, or clear them if kept for incremental updates */
+        if (Global::config().has("incremental")) {
+            appendStmt(postamble,
+                    std::make_unique<RamSequence>(
+                            std::make_unique<RamClear>(std::unique_ptr<RamRelation>(relDelta[rel]->clone())),
+                            std::make_unique<RamClear>(std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
+        } else {
+            appendStmt(postamble,
+                    std::make_unique<RamSequence>(
+                            std::make_unique<RamDrop>(std::unique_ptr<RamRelation>(relDelta[rel]->clone())),
+                            std::make_unique<RamDrop>(std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
+        }
 
         /* Generate code for non-recursive part of relation */
         appendStmt(preamble, translateNonRecursiveRelation(*rel, program, recursiveClauses, typeEnv));
@@ -1180,6 +1548,277 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
     return nullptr;
 }
 
+/** generate RAM code updating the relations of a strongly-connected component from the changes of others */
+std::unique_ptr<RamStatement> AstTranslator::translateUpdate(const std::set<const AstRelation*>& scc,
+        const AstProgram* program, const RecursiveClauses* recursiveClauses, const TypeEnvironment& typeEnv) {
+    std::unique_ptr<RamStatement> res = std::make_unique<RamSequence>();
+
+    // create a utility to check SCC membership
+    auto isInSameSCC = [&](const AstRelation* rel) { return scc.count(rel) > 0; };
+
+    // a utility referring to a relation or to one of the temporary relations kept for it
+    auto getRelation = [&](const AstRelation* rel, const std::string& prefix) {
+        return getKeptRelation(rel, typeEnv, prefix);
+    };
+    auto getName = [&](const AstRelation* rel, const std::string& prefix) {
+        return getRelation(rel, prefix)->getName();
+    };
+
+    // input relations that also have rules keep their facts apart
+    auto hasFacts = [&](const AstRelation* rel) { return rel->isInput() && rel->clauseSize() > 0; };
+
+    // the relations of other strata read by the clauses of the stratum
+    std::set<const AstRelation*> externals;
+    for (const AstRelation* rel : scc) {
+        visitDepthFirst(rel->getClauses(), [&](const AstAtom& atom) {
+            const AstRelation* cur = getAtomRelation(&atom, program);
+            if (!isInSameSCC(cur)) {
+                externals.insert(cur);
+            }
+        });
+    }
+
+    // a utility translating a clause derived from a clause of the stratum
+    auto translateVersion = [&](std::unique_ptr<AstClause> clause, const AstClause& original,
+                                    const AstRelation* rel) -> std::unique_ptr<RamStatement> {
+        clause->clearExecutionPlan();
+        nameUnnamedVariables(clause.get());
+        std::unique_ptr<RamStatement> rule =
+                translateClause(*clause, program, &typeEnv, original, 0, false, rel->isHashset());
+        std::ostringstream ds;
+        ds << toString(*clause) << "\nin file ";
+        ds << original.getSrcLoc();
+        return std::make_unique<RamDebugInfo>(std::move(rule), ds.str());
+    };
+
+    // a utility translating a clause copying the tuples of the first relation found in the second one,
+    // or missing from it if negated, into a third one
+    auto translateCopy = [&](const AstRelation* rel, const std::string& source, const std::string& other,
+                                 bool negated, const std::string& target) {
+        auto clause = std::make_unique<AstClause>();
+        clause->setHead(makeVariableAtom(getName(rel, target), rel->getArity()));
+        clause->addToBody(makeVariableAtom(getName(rel, source), rel->getArity()));
+        std::unique_ptr<AstAtom> atom = makeVariableAtom(getName(rel, other), rel->getArity());
+        if (negated) {
+            clause->addToBody(std::make_unique<AstNegation>(std::move(atom)));
+        } else {
+            clause->addToBody(std::move(atom));
+        }
+        return translateClause(*clause, program, &typeEnv, *clause);
+    };
+
+    // a utility translating the versions of the rules of the stratum starting from the changes of each
+    // literal of another stratum, given by the first prefix for atoms and by the second one for negations;
+    // derived tuples are either existing tuples losing a derivation or tuples not derived before
+    auto translateSeeds = [&](const std::string& positive, const std::string& negative,
+                                  const std::string& head, bool existing) {
+        for (const AstRelation* rel : scc) {
+            for (AstClause* cl : rel->getClauses()) {
+                if (!cl->isRule()) {
+                    continue;
+                }
+                std::vector<std::unique_ptr<AstClause>> versions;
+                const auto& atoms = cl->getAtoms();
+                for (size_t j = 0; j < atoms.size(); j++) {
+                    const AstRelation* atomRelation = getAtomRelation(atoms[j], program);
+                    if (isInSameSCC(atomRelation)) {
+                        continue;
+                    }
+                    std::unique_ptr<AstClause> version(cl->clone());
+                    version->getAtoms()[j]->setName(getName(atomRelation, positive));
+                    moveAtomToFront(*version, j);
+                    versions.push_back(std::move(version));
+                }
+                for (const AstNegation* neg : cl->getNegations()) {
+                    std::unique_ptr<AstClause> version(cl->clone());
+                    std::unique_ptr<AstAtom> atom(neg->getAtom()->clone());
+                    atom->setName(getName(getAtomRelation(neg->getAtom(), program), negative));
+                    version->addToBody(std::move(atom));
+                    moveAtomToFront(*version, version->getAtoms().size() - 1);
+                    versions.push_back(std::move(version));
+                }
+                for (auto& version : versions) {
+                    if (existing) {
+                        version->addToBody(matchHead(*version, getName(rel, "")));
+                    } else {
+                        std::unique_ptr<AstAtom> atom(cl->getHead()->clone());
+                        version->addToBody(std::make_unique<AstNegation>(std::move(atom)));
+                    }
+                    version->getHead()->setName(getName(rel, head));
+                    appendStmt(res, translateVersion(std::move(version), *cl, rel));
+                }
+            }
+        }
+    };
+
+    // a utility translating the fixpoint of the recursive rules of the stratum, deriving the tuples losing
+    // a derivation or the tuples not derived before from the delta of the previous iteration
+    auto translateFixpoint = [&](bool existing) {
+        std::unique_ptr<RamParallel> loopSeq(new RamParallel());
+        std::unique_ptr<RamSequence> updateTable(new RamSequence());
+        std::unique_ptr<RamCondition> exitCond;
+        for (const AstRelation* rel : scc) {
+            std::unique_ptr<RamStatement> loopRelSeq;
+            for (AstClause* cl : rel->getClauses()) {
+                if (!recursiveClauses->recursive(cl)) {
+                    continue;
+                }
+                const auto& atoms = cl->getAtoms();
+                for (size_t j = 0; j < atoms.size(); j++) {
+                    const AstRelation* atomRelation = getAtomRelation(atoms[j], program);
+                    if (!isInSameSCC(atomRelation)) {
+                        continue;
+                    }
+                    std::unique_ptr<AstClause> version(cl->clone());
+                    version->getAtoms()[j]->setName(getName(atomRelation, "delta_"));
+                    moveAtomToFront(*version, j);
+                    if (existing) {
+                        version->addToBody(matchHead(*version, getName(rel, "")));
+                        std::unique_ptr<AstAtom> removed(cl->getHead()->clone());
+                        removed->setName(getName(rel, "removed_"));
+                        version->addToBody(std::make_unique<AstNegation>(std::move(removed)));
+                    } else {
+                        std::unique_ptr<AstAtom> atom(cl->getHead()->clone());
+                        version->addToBody(std::make_unique<AstNegation>(std::move(atom)));
+                    }
+                    version->getHead()->setName(getName(rel, "new_"));
+                    appendStmt(loopRelSeq, translateVersion(std::move(version), *cl, rel));
+                }
+            }
+            if (loopRelSeq) {
+                loopSeq->add(std::move(loopRelSeq));
+            }
+
+            // the new tuples are added to the tuples losing a derivation, or to the relation and its changes
+            if (existing) {
+                updateTable->add(
+                        std::make_unique<RamMerge>(getRelation(rel, "removed_"), getRelation(rel, "new_")));
+            } else {
+                updateTable->add(std::make_unique<RamMerge>(getRelation(rel, ""), getRelation(rel, "new_")));
+                updateTable->add(
+                        std::make_unique<RamMerge>(getRelation(rel, "added_"), getRelation(rel, "new_")));
+            }
+            updateTable->add(std::make_unique<RamSwap>(getRelation(rel, "delta_"), getRelation(rel, "new_")));
+            updateTable->add(std::make_unique<RamClear>(getRelation(rel, "new_")));
+            std::unique_ptr<RamCondition> empty = std::make_unique<RamEmpty>(getRelation(rel, "new_"));
+            exitCond = (exitCond) ? std::make_unique<RamAnd>(std::move(exitCond), std::move(empty))
+                                  : std::move(empty);
+        }
+        if (!loopSeq->getStatements().empty()) {
+            appendStmt(res, std::make_unique<RamLoop>(std::move(loopSeq),
+                                    std::make_unique<RamExit>(std::move(exitCond)), std::move(updateTable)));
+        }
+        for (const AstRelation* rel : scc) {
+            appendStmt(res, std::make_unique<RamClear>(getRelation(rel, "delta_")));
+        }
+    };
+
+    // --- delete all tuples losing a derivation, evaluated against the previous state of the other strata ---
+
+    for (const AstRelation* rel : externals) {
+        appendStmt(res, std::make_unique<RamErase>(getRelation(rel, ""), getRelation(rel, "added_")));
+        appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, ""), getRelation(rel, "removed_")));
+    }
+    translateSeeds("removed_", "added_", "removed_", true);
+    for (const AstRelation* rel : scc) {
+        if (hasFacts(rel)) {
+            appendStmt(res, translateCopy(rel, "removed_facts_", "", false, "removed_"));
+        }
+        appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, "delta_"), getRelation(rel, "removed_")));
+    }
+    translateFixpoint(true);
+    for (const AstRelation* rel : externals) {
+        appendStmt(res, std::make_unique<RamErase>(getRelation(rel, ""), getRelation(rel, "removed_")));
+        appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, ""), getRelation(rel, "added_")));
+    }
+    for (const AstRelation* rel : scc) {
+        appendStmt(res, std::make_unique<RamErase>(getRelation(rel, ""), getRelation(rel, "removed_")));
+    }
+
+    // --- derive the deleted tuples again which keep a derivation, and the tuples gaining one ---
+
+    for (const AstRelation* rel : scc) {
+        for (AstClause* cl : rel->getClauses()) {
+            std::unique_ptr<AstClause> version(cl->clone());
+            version->addToBody(matchHead(*version, getName(rel, "removed_")));
+            moveAtomToFront(*version, version->getAtoms().size() - 1);
+            version->getHead()->setName(getName(rel, "delta_"));
+            appendStmt(res, translateVersion(std::move(version), *cl, rel));
+        }
+        if (hasFacts(rel)) {
+            appendStmt(res, translateCopy(rel, "removed_", "facts_", false, "delta_"));
+        }
+    }
+    translateSeeds("added_", "removed_", "delta_", false);
+    for (const AstRelation* rel : scc) {
+        if (hasFacts(rel)) {
+            appendStmt(res, translateCopy(rel, "added_facts_", "", true, "delta_"));
+        }
+        appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, ""), getRelation(rel, "delta_")));
+        appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, "added_"), getRelation(rel, "delta_")));
+    }
+    translateFixpoint(false);
+
+    // --- record the net changes, as tuples derived again are both deleted and added ---
+
+    for (const AstRelation* rel : scc) {
+        appendStmt(res, translateCopy(rel, "removed_", "added_", false, "delta_"));
+        appendStmt(res, std::make_unique<RamErase>(getRelation(rel, "removed_"), getRelation(rel, "delta_")));
+        appendStmt(res, std::make_unique<RamErase>(getRelation(rel, "added_"), getRelation(rel, "delta_")));
+        appendStmt(res, std::make_unique<RamClear>(getRelation(rel, "delta_")));
+    }
+    return res;
+}
+
+/** generate RAM code computing the relations of a strongly-connected component anew */
+std::unique_ptr<RamStatement> AstTranslator::translateRecompute(const std::set<const AstRelation*>& scc,
+        bool isRecursive, const AstProgram* program, const RecursiveClauses* recursiveClauses,
+        const TypeEnvironment& typeEnv) {
+    std::unique_ptr<RamStatement> res = std::make_unique<RamSequence>();
+
+    // relations without clauses only change by the changes applied to them
+    const AstRelation* first = *scc.begin();
+    if (scc.size() == 1 && first->clauseSize() == 0) {
+        return res;
+    }
+
+    // a utility referring to a relation or to one of the temporary relations kept for it
+    auto getRelation = [&](const AstRelation* rel, const std::string& prefix) {
+        return getKeptRelation(rel, typeEnv, prefix);
+    };
+
+    // keep the previous tuples, computing the relations anew from their facts
+    for (const AstRelation* rel : scc) {
+        appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, "removed_"), getRelation(rel, "")));
+        appendStmt(res, std::make_unique<RamClear>(getRelation(rel, "")));
+        if (rel->isInput()) {
+            appendStmt(res, std::make_unique<RamMerge>(getRelation(rel, ""), getRelation(rel, "facts_")));
+        }
+    }
+    appendStmt(res, (!isRecursive) ? translateNonRecursiveRelation(*first, program, recursiveClauses, typeEnv)
+                                   : translateRecursiveRelation(scc, program, recursiveClauses, typeEnv));
+
+    // the added tuples are new, the removed tuples are gone
+    for (const AstRelation* rel : scc) {
+        auto makeAtom = [&](const std::string& prefix) {
+            return makeVariableAtom(getRelation(rel, prefix)->getName(), rel->getArity());
+        };
+        auto added = std::make_unique<AstClause>();
+        added->setHead(makeAtom("added_"));
+        added->addToBody(makeAtom(""));
+        added->addToBody(std::make_unique<AstNegation>(makeAtom("removed_")));
+        appendStmt(res, translateClause(*added, program, &typeEnv, *added));
+        auto kept = std::make_unique<AstClause>();
+        kept->setHead(makeAtom("delta_"));
+        kept->addToBody(makeAtom("removed_"));
+        kept->addToBody(makeAtom(""));
+        appendStmt(res, translateClause(*kept, program, &typeEnv, *kept));
+        appendStmt(res, std::make_unique<RamErase>(getRelation(rel, "removed_"), getRelation(rel, "delta_")));
+        appendStmt(res, std::make_unique<RamClear>(getRelation(rel, "delta_")));
+    }
+    return res;
+}
+
 /** make a subroutine to search for subproofs */
 std::unique_ptr<RamStatement> AstTranslator::makeSubproofSubroutine(
         const AstClause& clause, const AstProgram* program, const TypeEnvironment& typeEnv) {
@@ -1243,6 +1882,9 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
     // obtain the schedule of relations expired at each index of the topological order
     const auto& expirySchedule = translationUnit.getAnalysis<RelationSchedule>()->schedule();
 
+    // obtain the searches served by indexes, which make hash joins redundant
+    indexedSearches = getIndexedSearches(*translationUnit.getProgram());
+
     // start with an empty sequence of ram statements
     std::unique_ptr<RamStatement> res = std::make_unique<RamSequence>();
 
@@ -1254,6 +1896,10 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
     // maintain the index of the SCC within the topological order
     unsigned index = 0;
 
+    // the subroutines of incremental updates, and a subroutine discarding the changes of the previous update
+    std::vector<std::pair<std::string, std::unique_ptr<RamStatement>>> updates;
+    std::unique_ptr<RamSequence> clearChanges(new RamSequence());
+
     // iterate over each SCC according to the topological order
     for (const auto& scc : sccOrder) {
         // make a new ram statement for the current SCC
@@ -1262,6 +1908,9 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
         // find out if the current SCC is recursive
         const auto& isRecursive = sccGraph.isRecursive(scc);
 
+        // find out if relations are kept for incremental updates
+        const bool isIncremental = Global::config().has("incremental");
+
         // make variables for particular sets of relations contained within the current SCC, and, predecessors
         // and successor SCCs thereof
         const auto& allInterns = sccGraph.getInternalRelations(scc);
@@ -1275,21 +1924,22 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
         // make a variable for all relations that are expired at the current SCC
         const auto& internExps = expirySchedule.at(index).expired();
 
+        // input relations that also have rules are loaded into their facts when kept for incremental updates
+        const auto& hasFacts = [&](const AstRelation* relation) {
+            return isIncremental && relation->isInput() && relation->clauseSize() > 0;
+        };
+
         // a function to create relations
         const auto& makeRamCreate = [&](const AstRelation* relation, const std::string relationNamePrefix) {
-            appendStmt(current,
-                    std::make_unique<RamCreate>(std::unique_ptr<RamRelation>(getRamRelation(relation,
-                            &typeEnv, relationNamePrefix + getRelationName(relation->getName()),
-                            relation->getArity(), !relationNamePrefix.empty(), relation->isHashset()))));
+            appendStmt(current, std::make_unique<RamCreate>(
+                                        getKeptRelation(relation, typeEnv, relationNamePrefix)));
         };
 
         // a function to load relations
         const auto& makeRamLoad = [&](const AstRelation* relation, const std::string& inputDirectory,
                 const std::string& fileExtension) {
             std::unique_ptr<RamStatement> statement = std::make_unique<RamLoad>(
-                    std::unique_ptr<RamRelation>(
-                            getRamRelation(relation, &typeEnv, getRelationName(relation->getName()),
-                                    relation->getArity(), false, relation->isHashset())),
+                    getKeptRelation(relation, typeEnv, hasFacts(relation) ? "facts_" : ""),
                     getInputIODirectives(relation, Global::config().get(inputDirectory), fileExtension));
             if (Global::config().has("profile")) {
                 const std::string logTimerStatement = LogStatement::tRelationLoadTime(
@@ -1337,6 +1987,19 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
             if (isRecursive) {
                 makeRamCreate(relation, "delta_");
                 makeRamCreate(relation, "new_");
+            } else if (isIncremental) {
+                makeRamCreate(relation, "delta_");
+            }
+            // create the relations keeping the changes of updates, and the facts of input relations with
+            // rules
+            if (isIncremental) {
+                makeRamCreate(relation, "added_");
+                makeRamCreate(relation, "removed_");
+                if (hasFacts(relation)) {
+                    makeRamCreate(relation, "facts_");
+                    makeRamCreate(relation, "added_facts_");
+                    makeRamCreate(relation, "removed_facts_");
+                }
             }
         }
 
@@ -1344,6 +2007,12 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
         for (const auto& relation : internIns) {
             makeRamLoad(relation, "fact-dir", ".facts");
         }
+        for (const auto& relation : internIns) {
+            if (hasFacts(relation)) {
+                appendStmt(current, std::make_unique<RamMerge>(getKeptRelation(relation, typeEnv),
+                                            getKeptRelation(relation, typeEnv, "facts_")));
+            }
+        }
 
         // if a communication engine has been specified...
         if (Global::config().has("engine")) {
@@ -1386,8 +2055,8 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
             makeRamStore(relation, "output-dir", ".csv");
         }
 
-        // if provenance is not enabled...
-        if (!Global::config().has("provenance")) {
+        // if provenance is not enabled and relations are not kept for incremental updates...
+        if (!Global::config().has("provenance") && !Global::config().has("incremental")) {
             // if a communication engine is enabled...
             if (Global::config().has("engine")) {
                 // drop all internal relations
@@ -1411,6 +2080,28 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
         }
 
         if (current) {
+            // add the subroutines of incremental updates, maintaining the relations of the stratum from the
+            // changes of the relations it depends on where possible, or computing them anew
+            if (isIncremental) {
+                const AstProgram* program = translationUnit.getProgram();
+                if (isMaintainable(allInterns, program)) {
+                    updates.emplace_back("update_" + std::to_string(index),
+                            translateUpdate(allInterns, program, recursiveClauses, typeEnv));
+                }
+                updates.emplace_back("recompute_" + std::to_string(index),
+                        translateRecompute(allInterns, isRecursive, program, recursiveClauses, typeEnv));
+                for (const auto& relation : allInterns) {
+                    for (const std::string prefix : {"added_", "removed_"}) {
+                        clearChanges->add(
+                                std::make_unique<RamClear>(getKeptRelation(relation, typeEnv, prefix)));
+                        if (hasFacts(relation)) {
+                            clearChanges->add(std::make_unique<RamClear>(
+                                    getKeptRelation(relation, typeEnv, std::string(prefix) + "facts_")));
+                        }
+                    }
+                }
+            }
+
             // append the current SCC as a stratum to the sequence
             appendStmt(res, std::make_unique<RamStratum>(std::move(current), index));
             // increment the index of the current SCC
@@ -1426,6 +2117,14 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
     // done for main prog
     std::unique_ptr<RamProgram> prog(new RamProgram(std::move(res)));
 
+    // add subroutines of incremental updates
+    if (Global::config().has("incremental")) {
+        for (auto& cur : updates) {
+            prog->addSubroutine(cur.first, std::move(cur.second));
+        }
+        prog->addSubroutine("clear_changes", std::move(clearChanges));
+    }
+
     // add subroutines for each clause
     if (Global::config().has("provenance")) {
         visitDepthFirst(translationUnit.getProgram()->getRelations(), [&](const AstClause& clause) {
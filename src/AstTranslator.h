@@ -17,6 +17,7 @@
 #pragma once
 
 #include "AstRelationIdentifier.h"
+#include "RamTypes.h"
 #include <map>
 #include <memory>
 #include <set>
@@ -65,6 +66,20 @@ public:
             const AstProgram* program, const RecursiveClauses* recursiveClauses,
             const TypeEnvironment& typeEnv);
 
+    /**
+     * Generates RAM code updating the relations of a strongly-connected component from the changes
+     * of the relations it depends on. Tuples losing a derivation are deleted and derived again if
+     * they keep another one (DRed), new tuples are derived semi-naively from the added tuples.
+     */
+    std::unique_ptr<RamStatement> translateUpdate(const std::set<const AstRelation*>& scc,
+            const AstProgram* program, const RecursiveClauses* recursiveClauses,
+            const TypeEnvironment& typeEnv);
+
+    /** generate RAM code computing the relations of a strongly-connected component anew, recording changes */
+    std::unique_ptr<RamStatement> translateRecompute(const std::set<const AstRelation*>& scc,
+            bool isRecursive, const AstProgram* program, const RecursiveClauses* recursiveClauses,
+            const TypeEnvironment& typeEnv);
+
     /** generate RAM code for subroutine to get subproofs */
     std::unique_ptr<RamStatement> makeSubproofSubroutine(
             const AstClause& clause, const AstProgram* program, const TypeEnvironment& typeEnv);
@@ -78,6 +93,9 @@ public:
 private:
     /** Map modified relation identifiers to original relation identifiers */
     std::map<std::string, std::string> modifiedIdMap;
+
+    /** Map relations to the columns on which atoms served by indexes search them */
+    std::map<AstRelationIdentifier, std::set<SearchColumns>> indexedSearches;
 };
 
 }  // end of namespace souffle
@@ -17,16 +17,21 @@
 
 #pragma once
 
+#include "NodePool.h"
 #include "ParallelUtils.h"
 #include "Util.h"
 #ifdef HAS_TSX
 #include "htmx86.h"
 #endif
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <type_traits>
 #include <vector>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
 
 namespace souffle {
 
@@ -198,6 +203,188 @@ struct binary_search : public search_strategy {
     }
 };
 
+// ---------- vectorised search utilities --------------
+
+/**
+ * A trait describing keys which can be searched by vectorised operations: keys
+ * which are, or are plain arrays of, 32 or 64 bit integers. Specialisations define
+ * the type of the values and the number of values per key.
+ */
+template <typename Key>
+struct simd_key {
+    enum { enabled = false };
+};
+
+template <>
+struct simd_key<int32_t> {
+    enum { enabled = true, stride = 1 };
+    using value_type = int32_t;
+};
+
+template <>
+struct simd_key<int64_t> {
+    enum { enabled = true, stride = 1 };
+    using value_type = int64_t;
+};
+
+/**
+ * A trait determining the value of a simd_key which the given comparator
+ * orders by first, using the natural order of integers. The value is -1
+ * if the comparator does not expose such an order.
+ */
+template <typename Comparator>
+struct leading_column {
+    enum { value = -1 };
+};
+
+template <>
+struct leading_column<comparator<int32_t>> {
+    enum { value = 0 };
+};
+
+template <>
+struct leading_column<comparator<int64_t>> {
+    enum { value = 0 };
+};
+
+namespace simd_utils {
+
+/**
+ * Counts the number of the n values starting at the given address which are
+ * less than (or, if inclusive, not greater than) the given value.
+ */
+template <bool inclusive, typename T>
+inline std::size_t count_below(const T* values, std::size_t n, T value) {
+    std::size_t res = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        res += inclusive ? (values[i] <= value) : (values[i] < value);
+    }
+    return res;
+}
+
+#ifdef __SSE2__
+/* Sums up the 32 bit lanes of the given vector. */
+inline int32_t sum_lanes(__m128i acc) {
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+}
+
+/*
+ * The vectorised version for 32 bit values. Compare results are -1 in matching
+ * lanes and thus accumulated by subtraction; the inclusive count is obtained
+ * from the number of greater values.
+ */
+template <bool inclusive>
+inline std::size_t count_below(const int32_t* values, std::size_t n, int32_t value) {
+    std::size_t i = 0;
+    int32_t matches = 0;
+#ifdef __AVX2__
+    const __m256i key8 = _mm256_set1_epi32(value);
+    __m256i acc8 = _mm256_setzero_si256();
+    for (; i + 8 <= n; i += 8) {
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        acc8 = _mm256_sub_epi32(
+                acc8, inclusive ? _mm256_cmpgt_epi32(cur, key8) : _mm256_cmpgt_epi32(key8, cur));
+    }
+    matches += sum_lanes(_mm_add_epi32(_mm256_castsi256_si128(acc8), _mm256_extracti128_si256(acc8, 1)));
+#endif
+    const __m128i key = _mm_set1_epi32(value);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        acc = _mm_sub_epi32(acc, inclusive ? _mm_cmpgt_epi32(cur, key) : _mm_cmplt_epi32(cur, key));
+    }
+    matches += sum_lanes(acc);
+    std::size_t res = inclusive ? i - matches : matches;
+    return res + count_below<inclusive, int32_t>(values + i, n - i, value);
+}
+#endif
+
+#ifdef __AVX2__
+/* The vectorised version for 64 bit values, analogous to the 32 bit version. */
+template <bool inclusive>
+inline std::size_t count_below(const int64_t* values, std::size_t n, int64_t value) {
+    std::size_t i = 0;
+    const __m256i key = _mm256_set1_epi64x(value);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        acc = _mm256_sub_epi64(acc, inclusive ? _mm256_cmpgt_epi64(cur, key) : _mm256_cmpgt_epi64(key, cur));
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+    std::size_t matches = static_cast<std::size_t>(_mm_cvtsi128_si64(sum));
+    std::size_t res = inclusive ? i - matches : matches;
+    return res + count_below<inclusive, int64_t>(values + i, n - i, value);
+}
+#endif
+
+}  // end namespace simd_utils
+
+/**
+ * A search strategy for looking up integer keys in b-tree nodes utilizing SSE/AVX2
+ * compares, selected at compile time. Since the keys of a node are sorted, the
+ * position of the first key not less than a given key is the number of keys less
+ * than the given key, which is computed without any data-dependent branches. Keys
+ * not supported by vectorised compares are searched by a binary search.
+ */
+struct simd_search : public search_strategy {
+    /**
+     * Required user-defined default constructor.
+     */
+    simd_search() {}
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * is not less than the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter operator()(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return lower_bound(k, a, b, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * is not less than the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter lower_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return search<false>(k, a, b, comp, is_supported<Key, Comp>());
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * such that the given key is less than the referenced element.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter upper_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return search<true>(k, a, b, comp, is_supported<Key, Comp>());
+    }
+
+private:
+    template <typename Key, typename Comp, typename = void>
+    struct is_supported : public std::false_type {};
+
+    template <typename Key, typename Comp>
+    struct is_supported<Key, Comp,
+            typename std::enable_if<simd_key<Key>::enabled && simd_key<Key>::stride == 1 &&
+                                    leading_column<typename std::remove_cv<Comp>::type>::value == 0>::type>
+            : public std::true_type {};
+
+    template <bool upper, typename Key, typename Iter, typename Comp>
+    inline Iter search(const Key& k, Iter a, Iter b, Comp&, std::true_type) const {
+        using value_type = typename simd_key<Key>::value_type;
+        const Key* first = a;
+        return a + simd_utils::count_below<upper>(reinterpret_cast<const value_type*>(first), b - a, value_type(k));
+    }
+
+    template <bool upper, typename Key, typename Iter, typename Comp>
+    inline Iter search(const Key& k, Iter a, Iter b, Comp& comp, std::false_type) const {
+        return upper ? binary_search().upper_bound(k, a, b, comp) : binary_search().lower_bound(k, a, b, comp);
+    }
+};
+
 // ---------- search strategies selection --------------
 
 /**
@@ -211,13 +398,17 @@ struct strategy_selection {
 
 struct linear : public strategy_selection<linear_search> {};
 struct binary : public strategy_selection<binary_search> {};
+struct simd : public strategy_selection<simd_search> {};
 
 // by default every key utilizes binary search
 template <typename Key>
 struct default_strategy : public binary {};
 
 template <>
-struct default_strategy<int> : public linear {};
+struct default_strategy<int32_t> : public simd {};
+
+template <>
+struct default_strategy<int64_t> : public simd {};
 
 template <typename... Ts>
 struct default_strategy<std::tuple<Ts...>> : public linear {};
@@ -328,6 +519,8 @@ private:
 
     struct inner_node;
 
+    class node_pool;
+
     /**
      * The actual, generic node implementation covering the operations
      * for both, inner and leaf nodes.
@@ -352,20 +545,13 @@ private:
         // a simple constructor
         node(bool inner) : base(inner) {}
 
-        // a destructor cleaning up nodes
-        ~node() {
-            if (this->inner) {
-                asInnerNode().cleanup();
-            }
-        }
-
         /**
-         * A deep-copy operation creating a clone of this node.
+         * A deep-copy operation creating a clone of this node utilizing
+         * nodes of the given pool.
          */
-        node* clone() const {
+        node* clone(node_pool& pool) const {
             // create a clone of this node
-            node* res = (this->isInner()) ? static_cast<node*>(new inner_node())
-                                          : static_cast<node*>(new leaf_node());
+            node* res = pool.create(this->isInner());
 
             // copy basic fields
             res->position = this->position;
@@ -383,7 +569,7 @@ private:
             // copy child nodes recursively
             auto* ires = (inner_node*)res;
             for (size_type i = 0; i <= this->numElements; ++i) {
-                ires->children[i] = this->getChild(i)->clone();
+                ires->children[i] = this->getChild(i)->clone(pool);
                 ires->children[i]->parent = res;
             }
 
@@ -516,11 +702,12 @@ private:
         /**
          * Splits this node.
          *
+         * @param pool .. the pool of the enclosing b-tree providing new nodes
          * @param root .. a pointer to the root-pointer of the enclosing b-tree
          *                 (might have to be updated if the root-node needs to be split)
          * @param idx  .. the position of the insert causing the split
          */
-        void split(node** root, lock_type& root_lock, int idx) {
+        void split(node_pool& pool, node** root, lock_type& root_lock, int idx) {
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
@@ -532,8 +719,7 @@ private:
             int split_point = getSplitPoint(idx);
 
             // create a new sibling node
-            node* sibling = (this->inner) ? static_cast<node*>(new inner_node())
-                                          : static_cast<node*>(new leaf_node());
+            node* sibling = pool.create(this->inner);
 
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
             // lock sibling
@@ -561,7 +747,7 @@ private:
             sibling->numElements = maxKeys - split_point - 1;
 
             // update parent
-            grow_parent(root, root_lock, sibling);
+            grow_parent(pool, root, root_lock, sibling);
 
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
             // unlock sibling
@@ -577,11 +763,12 @@ private:
          * Returns the number of elements moved to the left side, 0 in case
          * of a split. The number of moved elements will be <= the given idx.
          *
+         * @param pool .. the pool of the enclosing b-tree providing new nodes
          * @param root .. the root node of the b-tree being part of
          * @param idx  .. the position of the insert triggering this operation
          */
         // TODO: remove root_lock ... no longer needed
-        int rebalance_or_split(node** root, lock_type& root_lock, int idx) {
+        int rebalance_or_split(node_pool& pool, node** root, lock_type& root_lock, int idx) {
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
@@ -595,15 +782,15 @@ private:
             auto parent = this->parent;
             auto pos = this->position;
 
-            // Option A) re-balance data
-            if (parent && pos > 0) {
+            // Option A) re-balance data -- bulk loads and erasures may leave siblings of different depths
+            if (parent && pos > 0 && parent->getChild(pos - 1)->inner == this->inner) {
                 node* left = parent->getChild(pos - 1);
 
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
                 // lock access to left sibling
                 if (!left->lock.try_start_write()) {
                     // left node is currently updated => skip balancing and split
-                    split(root, root_lock, idx);
+                    split(pool, root, root_lock, idx);
                     return 0;
                 }
 #endif
@@ -673,7 +860,7 @@ private:
             }
 
             // Option B) split node
-            split(root, root_lock, idx);
+            split(pool, root, root_lock, idx);
             return 0;  // = no re-balancing
         }
 
@@ -683,10 +870,11 @@ private:
          * the last key of this node as a separation key. (for internal
          * use only)
          *
+         * @param pool .. the pool of the containing tree providing new nodes
          * @param root .. a pointer to the root-pointer of the containing tree
          * @param sibling .. the new right-sibling to be add to the parent node
          */
-        void grow_parent(node** root, lock_type& root_lock, node* sibling) {
+        void grow_parent(node_pool& pool, node** root, lock_type& root_lock, node* sibling) {
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
@@ -697,7 +885,7 @@ private:
                 assert(*root == this);
 
                 // create a new root node
-                auto* new_root = new inner_node();
+                auto* new_root = pool.createInner();
                 new_root->numElements = 1;
                 new_root->keys[0] = keys[this->numElements];
 
@@ -717,20 +905,21 @@ private:
                 auto parent = this->parent;
                 auto pos = this->position;
 
-                parent->insert_inner(root, root_lock, pos, this, keys[this->numElements], sibling);
+                parent->insert_inner(pool, root, root_lock, pos, this, keys[this->numElements], sibling);
             }
         }
 
         /**
          * Inserts a new element into an inner node (for internal use only).
          *
+         * @param pool .. the pool of the containing tree providing new nodes
          * @param root .. a pointer to the root-pointer of the containing tree
          * @param pos  .. the position to insert the new key
          * @param key  .. the key to insert
          * @param newNode .. the new right-child of the inserted key
          */
-        void insert_inner(node** root, lock_type& root_lock, unsigned pos, node* predecessor, const Key& key,
-                node* newNode) {
+        void insert_inner(node_pool& pool, node** root, lock_type& root_lock, unsigned pos, node* predecessor,
+                const Key& key, node* newNode) {
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
             assert(this->lock.is_write_locked());
 #endif
@@ -743,7 +932,7 @@ private:
 #endif
 
                 // split this node
-                pos -= rebalance_or_split(root, root_lock, pos);
+                pos -= rebalance_or_split(pool, root, root_lock, pos);
 
                 // complete insertion within new sibling if necessary
                 if (pos > this->numElements) {
@@ -764,7 +953,7 @@ private:
 
                     pos = (i > other->numElements) ? 0 : i;
 #endif
-                    other->insert_inner(root, root_lock, pos, predecessor, key, newNode);
+                    other->insert_inner(pool, root, root_lock, pos, predecessor, key, newNode);
 #if defined(IS_PARALLEL) && !defined(HAS_TSX)
                     other->lock.end_write();
 #endif
@@ -1006,13 +1195,6 @@ private:
 
         // a simple default constructor initializing member fields
         inner_node() : node(true) {}
-
-        // a destruction operation clearing up child nodes recursively
-        void cleanup() {
-            for (unsigned i = 0; i <= this->numElements; ++i) {
-                delete children[i];
-            }
-        }
     };
 
     /**
@@ -1024,6 +1206,66 @@ private:
         leaf_node() : node(false) {}
     };
 
+    /**
+     * The source of the nodes of a tree, recycling the nodes of a cleared
+     * tree for subsequent insertions.
+     */
+    class node_pool {
+        NodePool<leaf_node> leaves;
+        NodePool<inner_node> inners;
+
+    public:
+        leaf_node* createLeaf() {
+            return new (leaves.allocate()) leaf_node();
+        }
+
+        inner_node* createInner() {
+            return new (inners.allocate()) inner_node();
+        }
+
+        node* create(bool inner) {
+            return inner ? static_cast<node*>(createInner()) : static_cast<node*>(createLeaf());
+        }
+
+        // destroys the tree rooted by the given node, which must comprise all nodes of this pool
+        void destroyAll(node* root) {
+            // keys without destructors do not require the nodes to be visited
+            if (root && !std::is_trivially_destructible<Key>::value) {
+                destroy(root);
+            }
+            leaves.releaseAll();
+            inners.releaseAll();
+        }
+
+        // destroys a single node, which is no longer part of the tree, returning it to the pool
+        void release(node* cur) {
+            if (cur->isLeaf()) {
+                static_cast<leaf_node*>(cur)->~leaf_node();
+                leaves.release(cur);
+            } else {
+                static_cast<inner_node*>(cur)->~inner_node();
+                inners.release(cur);
+            }
+        }
+
+        void swap(node_pool& other) {
+            leaves.swap(other.leaves);
+            inners.swap(other.inners);
+        }
+
+    private:
+        static void destroy(node* cur) {
+            if (cur->isLeaf()) {
+                static_cast<leaf_node*>(cur)->~leaf_node();
+                return;
+            }
+            for (unsigned i = 0; i <= cur->numElements; ++i) {
+                destroy(cur->getChild(i));
+            }
+            static_cast<inner_node*>(cur)->~inner_node();
+        }
+    };
+
     // ------------------- iterators ------------------------
 
 public:
@@ -1045,14 +1287,10 @@ public:
         iterator(node const* cur, field_index_type pos) : cur(cur), pos(pos) {}
 
         // a copy constructor
-        iterator(const iterator& other) : cur(other.cur), pos(other.pos) {}
+        iterator(const iterator& other) = default;
 
         // an assignment operator
-        iterator& operator=(const iterator& other) {
-            cur = other.cur;
-            pos = other.pos;
-            return *this;
-        }
+        iterator& operator=(const iterator& other) = default;
 
         // the equality operator as required by the iterator concept
         bool operator==(const iterator& other) const {
@@ -1158,6 +1396,9 @@ private:
     // a pointer to the left-most node of this tree (initial note for iteration)
     leaf_node* leftmost;
 
+    // the source of all nodes of this tree
+    node_pool pool;
+
     // an aggregation of statistical values for hardware transactions, if enabled
     struct tdata_t {
         // the counter for transaction operations
@@ -1230,6 +1471,7 @@ public:
     btree(btree&& other) : comp(other.comp), root(other.root), leftmost(other.leftmost) {
         other.root = nullptr;
         other.leftmost = nullptr;
+        pool.swap(other.pool);
     }
 
     // a copy constructor
@@ -1238,14 +1480,6 @@ public:
         *this = set;
     }
 
-protected:
-    /**
-     * An internal constructor enabling the specific creation of a tree
-     * based on internal parameters.
-     */
-    btree(size_type size, node* root, leaf_node* leftmost) : root(root), leftmost(leftmost) {}
-
-public:
     // the destructor freeing all contained nodes
     ~btree() {
         clear();
@@ -1292,7 +1526,7 @@ public:
             }
 
             // create new node
-            leftmost = new leaf_node();
+            leftmost = pool.createLeaf();
             leftmost->numElements = 1;
             leftmost->keys[0] = k;
             root = leftmost;
@@ -1458,7 +1692,7 @@ public:
 
                 // split this node
                 auto old_root = root;
-                idx -= cur->rebalance_or_split(const_cast<node**>(&root), root_lock, idx);
+                idx -= cur->rebalance_or_split(pool, const_cast<node**>(&root), root_lock, idx);
 
                 // release parent lock
                 for (auto it = parents.rbegin(); it != parents.rend(); ++it) {
@@ -1519,7 +1753,7 @@ public:
         // special handling for inserting first element
         if (empty()) {
             // create new node
-            leftmost = new leaf_node();
+            leftmost = pool.createLeaf();
             leftmost->numElements = 1;
             leftmost->keys[0] = k;
             root = leftmost;
@@ -1588,7 +1822,7 @@ public:
 
             if (cur->numElements >= node::maxKeys) {
                 // split this node
-                idx -= cur->rebalance_or_split(&root, root_lock, idx);
+                idx -= cur->rebalance_or_split(pool, &root, root_lock, idx);
 
                 // insert element in right fragment
                 if (((size_type)idx) > cur->numElements) {
@@ -1659,6 +1893,79 @@ public:
         insert(other.begin(), other.end());
     }
 
+    /**
+     * Removes the given key from this tree, returning whether it was contained.
+     * Of a multiset, a single occurrence is removed.
+     */
+    bool erase(const Key& k) {
+        operation_hints hints;
+        return erase(k, hints);
+    }
+
+    /**
+     * Removes the given key from this tree, returning whether it was contained.
+     * Of a multiset, a single occurrence is removed. Leaves left without keys
+     * are removed from the tree. Erasures must not run concurrently with any
+     * other operation, and invalidate the hints of other operations on this tree.
+     */
+    bool erase(const Key& k, operation_hints& hints) {
+        hints.clear();
+        if (empty()) {
+            return false;
+        }
+
+        // locate the key
+        node* cur = root;
+        size_type idx;
+        while (true) {
+            auto a = &(cur->keys[0]);
+            auto b = &(cur->keys[cur->numElements]);
+
+            auto pos = search(k, a, b, comp);
+
+            if (pos < b && equal(*pos, k)) {
+                idx = pos - a;
+                break;
+            }
+
+            if (!cur->inner) {
+                return false;
+            }
+
+            cur = cur->getChild(pos - a);
+        }
+
+        // a key of an inner node is replaced by its predecessor, the last key of a leaf
+        if (cur->inner) {
+            node* leaf = cur->getChild(idx);
+            while (leaf->inner) {
+                leaf = leaf->getChild(leaf->numElements);
+            }
+            assert(!leaf->isEmpty() && "Empty leaf node encountered!");
+            cur->keys[idx] = leaf->keys[leaf->numElements - 1];
+            cur = leaf;
+            idx = leaf->numElements - 1;
+        }
+
+        // remove the key from its leaf
+        for (size_type i = idx + 1; i < cur->numElements; ++i) {
+            cur->keys[i - 1] = cur->keys[i];
+        }
+        --cur->numElements;
+
+        // a leaf left without keys is removed from the tree
+        if (cur->isEmpty()) {
+            if (cur == root) {
+                pool.release(cur);
+                root = nullptr;
+                leftmost = nullptr;
+            } else {
+                removeLeaf(cur);
+            }
+        }
+        return true;
+    }
+
     // Obtains an iterator referencing the first element of the tree.
     iterator begin() const {
         return iterator(leftmost, 0);
@@ -1863,7 +2170,8 @@ public:
      * Clears this tree.
      */
     void clear() {
-        delete root;
+        // all nodes are returned to the pool for later insertions
+        pool.destroyAll(root);
 
         root = nullptr;
         leftmost = nullptr;
@@ -1878,6 +2186,7 @@ public:
         // swap the content
         std::swap(root, other.root);
         std::swap(leftmost, other.leftmost);
+        pool.swap(other.pool);
     }
 
     // Implementation of the assignment operation for trees.
@@ -1887,6 +2196,9 @@ public:
             return *this;
         }
 
+        // drop the current content
+        clear();
+
         // create a deep-copy of the content of the other tree
         // shortcut for empty sets
         if (other.empty()) {
@@ -1894,7 +2206,7 @@ public:
         }
 
         // clone content (deep copy)
-        root = other.root->clone();
+        root = other.root->clone(pool);
 
         // update leftmost reference
         auto tmp = root;
@@ -2040,25 +2352,114 @@ public:
                                            std::random_access_iterator_tag>::value,
             R>::type
     load(const Iter& a, const Iter& b) {
+        R res;
+
         // quick exit - empty range
         if (a == b) {
-            return R();
+            return res;
         }
 
         // resolve tree recursively
-        auto root = buildSubTree(a, b - 1);
+        btree& tree = res;
+        tree.root = tree.buildSubTree(a, b - 1);
 
         // find leftmost node
-        node* leftmost = root;
+        node* leftmost = tree.root;
         while (!leftmost->isLeaf()) {
             leftmost = leftmost->getChild(0);
         }
+        tree.leftmost = static_cast<leaf_node*>(leftmost);
 
-        // build result
-        return R(b - a, root, static_cast<leaf_node*>(leftmost));
+        // done
+        return res;
     }
 
 private:
+    /**
+     * Makes the given child the child of the given position of the given inner node.
+     */
+    static void adopt(node* parent, size_type pos, node* child) {
+        parent->getChildren()[pos] = child;
+        child->parent = parent;
+        child->position = pos;
+    }
+
+    /**
+     * Removes the given non-root leaf left without keys by erasures. The key separating
+     * it from a neighbouring subtree moves into the outermost leaf of that subtree,
+     * if it has space left; otherwise the leaf takes over that key in exchange for the
+     * outermost key of the full leaf. A parent left without keys is replaced by its
+     * only child. Thus, erasures never increase the depth of any leaf.
+     */
+    void removeLeaf(node* cur) {
+        node* parent = cur->parent;
+        size_type pos = cur->position;
+        size_type sep = (pos > 0) ? pos - 1 : 0;
+
+        if (pos > 0) {
+            // the separator is an upper bound of the left subtree
+            node* left = parent->getChild(pos - 1);
+            while (left->inner) {
+                left = left->getChild(left->numElements);
+            }
+            if (left->numElements == node::maxKeys) {
+                cur->keys[0] = parent->keys[sep];
+                parent->keys[sep] = left->keys[left->numElements - 1];
+                --left->numElements;
+                cur->numElements = 1;
+                return;
+            }
+            left->keys[left->numElements++] = parent->keys[sep];
+        } else {
+            // the separator is a lower bound of the right subtree
+            node* right = parent->getChild(1);
+            while (right->inner) {
+                right = right->getChild(0);
+            }
+            if (right->numElements == node::maxKeys) {
+                cur->keys[0] = parent->keys[sep];
+                parent->keys[sep] = right->keys[0];
+                for (size_type i = 1; i < right->numElements; ++i) {
+                    right->keys[i - 1] = right->keys[i];
+                }
+                --right->numElements;
+                cur->numElements = 1;
+                return;
+            }
+            for (size_type i = right->numElements; i > 0; --i) {
+                right->keys[i] = right->keys[i - 1];
+            }
+            right->keys[0] = parent->keys[sep];
+            ++right->numElements;
+            if (cur == leftmost) {
+                leftmost = static_cast<leaf_node*>(right);
+            }
+        }
+
+        // remove the separator and the leaf from the parent
+        for (size_type i = sep + 1; i < parent->numElements; ++i) {
+            parent->keys[i - 1] = parent->keys[i];
+        }
+        for (size_type i = pos + 1; i <= parent->numElements; ++i) {
+            adopt(parent, i - 1, parent->getChild(i));
+        }
+        --parent->numElements;
+        pool.release(cur);
+
+        // a parent without keys is replaced by its only child
+        if (parent->isEmpty()) {
+            node* child = parent->getChild(0);
+            if (parent == root) {
+                root = child;
+                child->parent = nullptr;
+                child->position = 0;
+            } else {
+                adopt(parent->parent, parent->position, child);
+            }
+            pool.release(parent);
+        }
+    }
+
     /**
      * Determines whether the range covered by the given node is also
      * covering the given key value.
@@ -2083,7 +2484,7 @@ private:
 
     // Utility function for the load operation above.
     template <typename Iter>
-    static node* buildSubTree(const Iter& a, const Iter& b) {
+    node* buildSubTree(const Iter& a, const Iter& b) {
         const int N = node::maxKeys;
 
         // divide range in N+1 sub-ranges
@@ -2092,7 +2493,7 @@ private:
         // terminal case: length is less then maxKeys
         if (length <= N) {
             // create a leaf node
-            node* res = new leaf_node();
+            node* res = pool.createLeaf();
             res->numElements = length;
 
             for (int i = 0; i < length; ++i) {
@@ -2112,7 +2513,7 @@ private:
         }
 
         // create inner node
-        node* res = new inner_node();
+        node* res = pool.createInner();
         res->numElements = numKeys;
 
         Iter c = a;
@@ -2162,8 +2563,6 @@ template <typename Key, typename Comparator = detail::comparator<Key>,
 class btree_set : public detail::btree<Key, Comparator, Allocator, blockSize, SearchStrategy, true> {
     using super = detail::btree<Key, Comparator, Allocator, blockSize, SearchStrategy, true>;
 
-    friend class detail::btree<Key, Comparator, Allocator, blockSize, SearchStrategy, true>;
-
 public:
     /**
      * A default constructor creating an empty set.
@@ -2184,12 +2583,6 @@ public:
     // A move constructor.
     btree_set(btree_set&& other) : super(std::move(other)) {}
 
-private:
-    // A constructor required by the bulk-load facility.
-    template <typename s, typename n, typename l>
-    btree_set(s size, n* root, l* leftmost) : super(size, root, leftmost) {}
-
-public:
     // Support for the assignment operator.
     btree_set& operator=(const btree_set& other) {
         super::operator=(other);
@@ -2218,8 +2611,6 @@ template <typename Key, typename Comparator = detail::comparator<Key>,
 class btree_multiset : public detail::btree<Key, Comparator, Allocator, blockSize, SearchStrategy, false> {
     using super = detail::btree<Key, Comparator, Allocator, blockSize, SearchStrategy, false>;
 
-    friend class detail::btree<Key, Comparator, Allocator, blockSize, SearchStrategy, false>;
-
 public:
     /**
      * A default constructor creating an empty set.
@@ -2240,12 +2631,6 @@ public:
     // A move constructor.
     btree_multiset(btree_multiset&& other) : super(std::move(other)) {}
 
-private:
-    // A constructor required by the bulk-load facility.
-    template <typename s, typename n, typename l>
-    btree_multiset(s size, n* root, l* leftmost) : super(size, root, leftmost) {}
-
-public:
     // Support for the assignment operator.
     btree_multiset& operator=(const btree_multiset& other) {
         super::operator=(other);
@@ -178,6 +178,20 @@ public:
         statesLock.unlock();
     }
 
+    /**
+     * Estimates the number of bytes occupied by the disjoint sets and their orderings
+     * @return the number of bytes
+     */
+    size_t getMemoryUsage() const {
+        statesLock.lock_shared();
+        size_t res = sizeof(*this) + sds.getMemoryUsage() + getHashMemoryUsage(orderedStates);
+        for (const auto& cur : orderedStates) {
+            res += cur.second->getMemoryUsage();
+        }
+        statesLock.unlock_shared();
+        return res;
+    }
+
     /**
      * Size of relation
      * @return the sum of the number of pairs per disjoint set
@@ -317,6 +317,14 @@ public:
         m_size = 0;
     }
 
+    /**
+     * Determines the number of bytes occupied by the blocks of this list
+     * @return the number of bytes
+     */
+    size_t getMemoryUsage() const {
+        return sizeof(*this) + listData.size() * (BLOCKSIZE * sizeof(T) + sizeof(T*));
+    }
+
     /**
      * Remove the last element from the data
      * and destroying the block if its the last one in it
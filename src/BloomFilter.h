@@ -0,0 +1,203 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file BloomFilter.h
+ *
+ * A concurrent, scalable Bloom filter utilized by indices to skip the
+ * lookup of keys which are definitely not present.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace souffle {
+
+/**
+ * A blocked Bloom filter growing with the number of inserted keys.
+ *
+ * The filter consists of a sequence of stages, each being a blocked Bloom
+ * filter of a fixed capacity. Whenever the newest stage is saturated, a new
+ * stage of four times the capacity is added, such that the false-positive
+ * rate remains bounded independently of the final number of keys. Each key
+ * sets 8 bits within a single cache-line sized block of its stage.
+ *
+ * Insertions may be conducted concurrently. Lookups may be conducted
+ * concurrently to each other, but not concurrently to insertions.
+ */
+class BloomFilter {
+    // the number of 64-bit words per block (one cache line)
+    static constexpr unsigned WORDS_PER_BLOCK = 8;
+
+    // the number of keys per block for which the false-positive rate stays below ~1%
+    static constexpr std::size_t KEYS_PER_BLOCK = 32;
+
+    // the number of blocks of the first stage
+    static constexpr std::size_t INITIAL_BLOCKS = 32;
+
+    // the maximal number of stages (sufficient for more than 2^48 keys)
+    static constexpr unsigned MAX_STAGES = 20;
+
+    using word = std::atomic<uint64_t>;
+
+    /* A single blocked Bloom filter of fixed capacity */
+    struct Stage {
+        // the number of blocks, a power of two
+        const std::size_t numBlocks;
+
+        // the number of keys this stage is dimensioned for
+        const std::size_t capacity;
+
+        // the number of keys inserted into this stage so far
+        std::atomic<std::size_t> count;
+
+        // the storage of the bits, over-allocated to enable cache line alignment
+        std::unique_ptr<word[]> storage;
+
+        // the first word of the first block
+        word* blocks;
+
+        Stage(std::size_t numBlocks)
+                : numBlocks(numBlocks), capacity(numBlocks * KEYS_PER_BLOCK), count(0),
+                  storage(new word[numBlocks * WORDS_PER_BLOCK + WORDS_PER_BLOCK - 1]()) {
+            auto offset = reinterpret_cast<uintptr_t>(storage.get()) % (WORDS_PER_BLOCK * sizeof(word));
+            blocks = storage.get() + (offset ? WORDS_PER_BLOCK - offset / sizeof(word) : 0);
+        }
+
+        word* getBlock(uint64_t hash) const {
+            return blocks + ((hash >> 32) & (numBlocks - 1)) * WORDS_PER_BLOCK;
+        }
+
+        void insert(uint64_t hash) {
+            word* block = getBlock(hash);
+            uint64_t bits = mix(hash);
+            for (unsigned i = 0; i < WORDS_PER_BLOCK; i++, bits >>= 6) {
+                uint64_t mask = uint64_t(1) << (bits & 63);
+                // avoid contended writes on the cache line if the bit is already set
+                if (!(block[i].load(std::memory_order_relaxed) & mask)) {
+                    block[i].fetch_or(mask, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool mayContain(uint64_t hash) const {
+            const word* block = getBlock(hash);
+            uint64_t bits = mix(hash);
+            for (unsigned i = 0; i < WORDS_PER_BLOCK; i++, bits >>= 6) {
+                if (!(block[i].load(std::memory_order_relaxed) & (uint64_t(1) << (bits & 63)))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // the stages of this filter, only the last one is receiving new keys
+    std::atomic<Stage*> stages[MAX_STAGES];
+
+    // the number of stages in use
+    std::atomic<unsigned> numStages;
+
+    // a lock synchronizing the creation of new stages
+    std::mutex growLock;
+
+public:
+    BloomFilter() : numStages(0) {
+        for (auto& cur : stages) {
+            cur.store(nullptr, std::memory_order_relaxed);
+        }
+        clear();
+    }
+
+    BloomFilter(const BloomFilter&) = delete;
+
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    ~BloomFilter() {
+        for (auto& cur : stages) {
+            delete cur.load(std::memory_order_relaxed);
+        }
+    }
+
+    /** Adds the given key hash to this filter. */
+    void insert(uint64_t hash) {
+        unsigned last = numStages.load(std::memory_order_acquire) - 1;
+        Stage* stage = stages[last].load(std::memory_order_acquire);
+        if (stage->count.fetch_add(1, std::memory_order_relaxed) >= stage->capacity && last + 1 < MAX_STAGES) {
+            stage = grow(last);
+        }
+        stage->insert(hash);
+    }
+
+    /** Determines whether the given key hash may have been inserted; false is definite. */
+    bool mayContain(uint64_t hash) const {
+        // start with the largest stage, which most likely holds the key
+        for (unsigned i = numStages.load(std::memory_order_acquire); i > 0; i--) {
+            if (stages[i - 1].load(std::memory_order_relaxed)->mayContain(hash)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Removes all keys from this filter. */
+    void clear() {
+        for (auto& cur : stages) {
+            delete cur.exchange(nullptr, std::memory_order_relaxed);
+        }
+        stages[0].store(new Stage(INITIAL_BLOCKS), std::memory_order_relaxed);
+        numStages.store(1, std::memory_order_release);
+    }
+
+    /** Obtains the number of bytes occupied by this filter. */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = sizeof(*this);
+        for (unsigned i = 0; i < numStages.load(std::memory_order_acquire); i++) {
+            const Stage* stage = stages[i].load(std::memory_order_relaxed);
+            res += sizeof(Stage) + (stage->numBlocks * WORDS_PER_BLOCK + WORDS_PER_BLOCK - 1) * sizeof(word);
+        }
+        return res;
+    }
+
+    /** Combines the hash of a key prefix with the next key component. */
+    static uint64_t combine(uint64_t hash, RamDomain value) {
+        return mix(hash ^ (uint64_t(uint32_t(value)) + 0x9e3779b97f4a7c15ull + (hash << 6)));
+    }
+
+private:
+    /* A 64-bit finalizer spreading the entropy of the input over all bits. */
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /* Obtains the stage following the given one, creating it if necessary. */
+    Stage* grow(unsigned last) {
+        std::lock_guard<std::mutex> lease(growLock);
+        if (numStages.load(std::memory_order_relaxed) == last + 1) {
+            Stage* prev = stages[last].load(std::memory_order_relaxed);
+            stages[last + 1].store(new Stage(prev->numBlocks * 4), std::memory_order_release);
+            numStages.store(last + 2, std::memory_order_release);
+        }
+        return stages[numStages.load(std::memory_order_relaxed) - 1].load(std::memory_order_acquire);
+    }
+};
+
+}  // end of namespace souffle
@@ -19,12 +19,18 @@
 
 #include "BTree.h"
 #include "BinaryRelation.h"
+#include "BloomFilter.h"
 #include "CompiledTuple.h"
 #include "IterUtils.h"
+#include "ParallelUtils.h"
 #include "RamTypes.h"
+#include "SpillStorage.h"
 #include "Trie.h"
 #include "Util.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <ostream>
 #include <string>
@@ -115,6 +121,37 @@ struct comparator<> {
     }
 };
 
+}  // namespace index_utils
+}  // namespace ram
+
+namespace detail {
+
+// compiled tuples are plain arrays of RamDomain values, ordered by index comparators
+
+template <std::size_t arity>
+struct simd_key<ram::Tuple<RamDomain, arity>> {
+    enum { enabled = simd_key<RamDomain>::enabled, stride = arity };
+    using value_type = RamDomain;
+};
+
+template <unsigned First, unsigned... Rest>
+struct leading_column<ram::index_utils::comparator<First, Rest...>> {
+    enum { value = First };
+};
+
+// the nodes of tuple b-trees are scanned linearly since most searches are decided
+// by the first column, unary tuples are searched like plain integers
+template <std::size_t arity>
+struct default_strategy<ram::Tuple<RamDomain, arity>> : public linear {};
+
+template <>
+struct default_strategy<ram::Tuple<RamDomain, 1>> : public simd {};
+
+}  // namespace detail
+
+namespace ram {
+namespace index_utils {
+
 // ----- a comparator wrapper dereferencing pointers ----------
 //         (required for handling indirect indices)
 
@@ -137,6 +174,29 @@ struct deref_compare {
     }
 };
 
+// ----- a hash function over a prefix of the index columns ----------
+//       (required for the Bloom filters of indices)
+
+template <unsigned... Columns>
+struct prefix_hash;
+
+template <unsigned First, unsigned... Rest>
+struct prefix_hash<First, Rest...> {
+    template <typename T>
+    uint64_t operator()(const T& t, std::size_t length, uint64_t hash = 0) const {
+        return (length == 0) ? hash
+                             : prefix_hash<Rest...>()(t, length - 1, BloomFilter::combine(hash, t[First]));
+    }
+};
+
+template <>
+struct prefix_hash<> {
+    template <typename T>
+    uint64_t operator()(const T&, std::size_t, uint64_t hash = 0) const {
+        return hash;
+    }
+};
+
 // ----- a utility for printing lists of parameters -------
 //    (required for printing descriptions of relations)
 
@@ -181,6 +241,9 @@ struct index {
     // the comparator associated to this index
     using comparator = index_utils::comparator<Columns...>;
 
+    // the hash function over prefixes of this index
+    using hasher = index_utils::prefix_hash<Columns...>;
+
     // enables to check whether the given column is covered by this index or not
     template <unsigned Col>
     struct covers {
@@ -465,6 +528,33 @@ struct is_compatible_with<index<C1...>, index<C2...>> {
     enum { value = detail::is_compatible_with_aux<index<>, index<C1...>, index<>, index<C2...>>::value };
 };
 
+// -- obtains the column at a given position of an index (-1 if out of range) --
+
+template <unsigned Pos, typename Index>
+struct column_at {
+    enum { value = -1 };
+};
+
+template <unsigned First, unsigned... Rest>
+struct column_at<0, index<First, Rest...>> {
+    enum { value = First };
+};
+
+template <unsigned Pos, unsigned First, unsigned... Rest>
+struct column_at<Pos, index<First, Rest...>> {
+    enum { value = column_at<Pos - 1, index<Rest...>>::value };
+};
+
+// -- checks whether an index orders a range column directly after a sub-index --
+
+template <typename SubIndex, unsigned Column, typename Index>
+struct is_range_compatible_with {
+    enum {
+        value = is_compatible_with<SubIndex, Index>::value &&
+                (int)column_at<SubIndex::size, Index>::value == (int)Column
+    };
+};
+
 // -- checks whether an index is a full index --
 
 template <unsigned arity, typename Index>
@@ -592,6 +682,10 @@ struct DirectIndex {
 private:
     data_structure index;
 
+    // a Bloom filter over the first filterLength columns of the indexed tuples, if non-zero
+    BloomFilter filter;
+    std::size_t filterLength = 0;
+
 public:
     bool empty() const {
         return index.empty();
@@ -603,16 +697,64 @@ public:
 
     bool insert(const key_type& key, operation_hints& hints) {
         // insert the element (insert is synchronized internally)
-        return index.insert(key, hints);
+        if (!index.insert(key, hints)) {
+            return false;
+        }
+        if (filterLength != 0) {
+            filter.insert(typename Index::hasher()(key, filterLength));
+        }
+        return true;
+    }
+
+    /* Removes the given key. The Bloom filter keeps its bits, which only admits false positives. */
+    bool erase(const key_type& key, operation_hints& hints) {
+        return index.erase(key, hints);
     }
 
     void insertAll(const DirectIndex& other) {
         // use index's insert-all
         index.insertAll(other.index);
+        if (filterLength != 0) {
+            for (const auto& cur : other) {
+                filter.insert(typename Index::hasher()(cur, filterLength));
+            }
+        }
+    }
+
+    /* Replaces the content of this index by the referenced tuples, sorted according to this index. */
+    void loadSorted(const std::vector<const Tuple*>& tuples) {
+        std::vector<Tuple> keys;
+        keys.reserve(tuples.size());
+        for (const Tuple* cur : tuples) {
+            keys.push_back(*cur);
+        }
+        data_structure tmp = data_structure::load(keys.begin(), keys.end());
+        index.swap(tmp);
+        filter.clear();
+        if (filterLength != 0) {
+            for (const auto& cur : keys) {
+                filter.insert(typename Index::hasher()(cur, filterLength));
+            }
+        }
+    }
+
+    /**
+     * Maintains a Bloom filter over the first length columns of this index,
+     * such that lookups of absent keys binding those columns skip the index.
+     */
+    void enableFilter(std::size_t length) {
+        if (filterLength != 0 && filterLength <= length) {
+            return;
+        }
+        filterLength = length;
+        filter.clear();
+        for (const auto& cur : *this) {
+            filter.insert(typename Index::hasher()(cur, length));
+        }
     }
 
     bool contains(const key_type& key, operation_hints& hints) const {
-        return index.contains(key, hints);
+        return mayContain(key, key_type::arity) && index.contains(key, hints);
     }
 
     iterator find(const key_type& key, operation_hints& hints) const {
@@ -621,6 +763,11 @@ public:
 
     template <typename SubIndex>
     range<iterator> equalRange(const key_type& key, operation_hints& hints) const {
+        // skip the lookup if the key is known to be absent
+        if (!mayContain(key, SubIndex::size)) {
+            return make_range(index.end(), index.end());
+        }
+
         // more efficient support for full-indices
         if (int(SubIndex::size) == int(Index::size) && int(Index::size) == int(key_type::arity)) {
             // in this case there is at most one element with this value
@@ -633,167 +780,1105 @@ public:
             return make_range(pos, end);
         }
 
-        // compute lower and upper bounds
-        return make_range(index.lower_bound(lower<Index, SubIndex>(key), hints),
-                index.upper_bound(raise<Index, SubIndex>(key), hints));
+        // compute lower and upper bounds
+        return make_range(index.lower_bound(lower<Index, SubIndex>(key), hints),
+                index.upper_bound(raise<Index, SubIndex>(key), hints));
+    }
+
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(const key_type& low, const key_type& high, operation_hints& hints) const {
+        static_assert(is_range_compatible_with<SubIndex, Column, Index>::value, "Invalid range query!");
+        using RangeIndex = typename extend<SubIndex, Column>::type;
+
+        // an empty range if the bounds are crossing
+        if (low[Column] > high[Column]) {
+            return make_range(index.end(), index.end());
+        }
+
+        // compute lower and upper bounds
+        return make_range(index.lower_bound(lower<Index, RangeIndex>(low), hints),
+                index.upper_bound(raise<Index, RangeIndex>(high), hints));
+    }
+
+    iterator begin() const {
+        return index.begin();
+    }
+
+    iterator end() const {
+        return index.end();
+    }
+
+    void clear() {
+        index.clear();
+        filter.clear();
+    }
+
+    std::vector<range<iterator>> partition() const {
+        return index.getChunks(400);
+    }
+
+    /* Obtains the number of bytes occupied by this index. */
+    std::size_t getMemoryUsage() const {
+        return index.getMemoryUsage() + filter.getMemoryUsage();
+    }
+
+    static void printDescription(std::ostream& out) {
+        out << "direct-btree-index(" << Index() << ")";
+    }
+
+    void printHintStatistics(std::ostream& out, const std::string& prefix) const {
+        const auto& stats = index.getHintStatistics();
+        out << prefix << "Direct B-Tree Index: (Hits/Misses/Total)\n";
+        out << prefix << "       Insert: " << stats.inserts.getHits() << "/" << stats.inserts.getMisses()
+            << "/" << stats.inserts.getAccesses() << "\n";
+
+        out << prefix << "     Contains: " << stats.contains.getHits() << "/" << stats.contains.getMisses()
+            << "/" << stats.contains.getAccesses() << "\n";
+
+        out << prefix << "  lower bound: " << stats.lower_bound.getHits() << "/"
+            << stats.lower_bound.getMisses() << "/" << stats.lower_bound.getAccesses() << "\n";
+
+        out << prefix << "  upper bound: " << stats.upper_bound.getHits() << "/"
+            << stats.upper_bound.getMisses() << "/" << stats.upper_bound.getAccesses() << "\n";
+    }
+
+private:
+    // determines whether a key binding the first length columns may be present
+    bool mayContain(const key_type& key, std::size_t length) const {
+        return filterLength == 0 || length < filterLength ||
+               filter.mayContain(typename Index::hasher()(key, filterLength));
+    }
+};
+
+/**
+ * A wrapper realizing indirect indices -- by storing pointers to the
+ * actually indexed values.
+ *
+ * @tparam Tuple .. the type of tuple to be maintained by this index
+ * @tparam Index .. the index to be internally utilized.
+ */
+template <typename Tuple, typename Index>
+struct IndirectIndex {
+    using data_structure = typename std::conditional<(int)(Tuple::arity) == (int)(Index::size),
+            btree_set<const Tuple*, index_utils::deref_compare<typename Index::comparator>>,
+            btree_multiset<const Tuple*, index_utils::deref_compare<typename Index::comparator>>>::type;
+
+    using key_type = typename std::remove_cv<
+            typename std::remove_pointer<typename data_structure::key_type>::type>::type;
+
+    using iterator = IterDerefWrapper<typename data_structure::const_iterator>;
+
+    using operation_hints = typename data_structure::operation_hints;
+
+private:
+    // the enclosed index
+    data_structure index;
+
+    // a Bloom filter over the first filterLength columns of the indexed tuples, if non-zero
+    BloomFilter filter;
+    std::size_t filterLength = 0;
+
+public:
+    bool empty() const {
+        return index.empty();
+    }
+
+    std::size_t size() const {
+        return index.size();
+    }
+
+    bool insert(const key_type& key, operation_hints& hints) {
+        // insert the element (insert is synchronized internally)
+        if (!index.insert(&key, hints)) {
+            return false;
+        }
+        if (filterLength != 0) {
+            filter.insert(typename Index::hasher()(key, filterLength));
+        }
+        return true;
+    }
+
+    void insertAll(const IndirectIndex& other) {
+        // use index's insert-all
+        index.insertAll(other.index);
+        if (filterLength != 0) {
+            for (const auto& cur : other) {
+                filter.insert(typename Index::hasher()(cur, filterLength));
+            }
+        }
+    }
+
+    /* Replaces the content of this index by the referenced tuples, sorted according to this index. */
+    void loadSorted(const std::vector<const Tuple*>& tuples) {
+        data_structure tmp = data_structure::load(tuples.begin(), tuples.end());
+        index.swap(tmp);
+        filter.clear();
+        if (filterLength != 0) {
+            for (const Tuple* cur : tuples) {
+                filter.insert(typename Index::hasher()(*cur, filterLength));
+            }
+        }
+    }
+
+    /**
+     * Maintains a Bloom filter over the first length columns of this index,
+     * such that lookups of absent keys binding those columns skip the index.
+     */
+    void enableFilter(std::size_t length) {
+        if (filterLength != 0 && filterLength <= length) {
+            return;
+        }
+        filterLength = length;
+        filter.clear();
+        for (const auto& cur : *this) {
+            filter.insert(typename Index::hasher()(cur, length));
+        }
+    }
+
+    bool contains(const key_type& key, operation_hints& hints) const {
+        return mayContain(key, key_type::arity) && index.contains(&key, hints);
+    }
+
+    iterator find(const key_type& key, operation_hints& hints) const {
+        return index.find(&key, hints);
+    }
+
+    template <typename SubIndex>
+    range<iterator> equalRange(const key_type& key, operation_hints& hints) const {
+        // skip the lookup if the key is known to be absent
+        if (!mayContain(key, SubIndex::size)) {
+            return make_range(end(), end());
+        }
+
+        // more efficient support for full-indices
+        if (int(SubIndex::size) == int(Index::size) && int(Index::size) == int(key_type::arity)) {
+            // in this case there is at most one element with this value
+            auto pos = find(key, hints);
+            auto end = this->end();
+            if (pos != end) {
+                end = pos;
+                ++end;
+            }
+            return make_range(pos, end);
+        }
+
+        // compute lower and upper bounds
+        auto low = lower<Index, SubIndex>(key);
+        auto hig = raise<Index, SubIndex>(key);
+        return make_range(
+                derefIter(index.lower_bound(&low, hints)), derefIter(index.upper_bound(&hig, hints)));
+    }
+
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(const key_type& low, const key_type& high, operation_hints& hints) const {
+        static_assert(is_range_compatible_with<SubIndex, Column, Index>::value, "Invalid range query!");
+        using RangeIndex = typename extend<SubIndex, Column>::type;
+
+        // an empty range if the bounds are crossing
+        if (low[Column] > high[Column]) {
+            return make_range(end(), end());
+        }
+
+        // compute lower and upper bounds
+        auto lowKey = lower<Index, RangeIndex>(low);
+        auto higKey = raise<Index, RangeIndex>(high);
+        return make_range(derefIter(index.lower_bound(&lowKey, hints)),
+                derefIter(index.upper_bound(&higKey, hints)));
+    }
+
+    iterator begin() const {
+        return index.begin();
+    }
+
+    iterator end() const {
+        return index.end();
+    }
+
+    void clear() {
+        index.clear();
+        filter.clear();
+    }
+
+    /**
+     * Return a list of iterators, s.t. we can process in parallel.
+     * "an approximation of the number of sub-ranges to be included in the resulting partition."
+     * "The numbers there [400] are not very important, as long as they are large enough (~10x the number of
+     * maximum expected cores)
+     * and not too large, such that processing a fragment lasts less than e.g. 1ms."
+     * @param np the number of iterators to attempt to return, which represents slices of the data structure
+     * @return a vector of these iterator ranges
+     */
+    std::vector<range<iterator>> partition() const {
+        std::vector<range<iterator>> res;
+        for (const auto& cur : index.getChunks(400)) {
+            res.push_back(make_range(derefIter(cur.begin()), derefIter(cur.end())));
+        }
+        return res;
+    }
+
+    /* Obtains the number of bytes occupied by this index. */
+    std::size_t getMemoryUsage() const {
+        return index.getMemoryUsage() + filter.getMemoryUsage();
+    }
+
+    static void printDescription(std::ostream& out) {
+        out << "indirect-btree-index(" << Index() << ")";
+    }
+
+    void printHintStatistics(std::ostream& out, const std::string& prefix) const {
+        const auto& stats = index.getHintStatistics();
+        out << prefix << "Indirect B-Tree Index: (Hits/Misses/Total)\n";
+        out << prefix << "       Insert: " << stats.inserts.getHits() << "/" << stats.inserts.getMisses()
+            << "/" << stats.inserts.getAccesses() << "\n";
+
+        out << prefix << "     Contains: " << stats.contains.getHits() << "/" << stats.contains.getMisses()
+            << "/" << stats.contains.getAccesses() << "\n";
+
+        out << prefix << "  lower bound: " << stats.lower_bound.getHits() << "/"
+            << stats.lower_bound.getMisses() << "/" << stats.lower_bound.getAccesses() << "\n";
+
+        out << prefix << "  upper bound: " << stats.upper_bound.getHits() << "/"
+            << stats.upper_bound.getMisses() << "/" << stats.upper_bound.getAccesses() << "\n";
+    }
+
+private:
+    // determines whether a key binding the first length columns may be present
+    bool mayContain(const key_type& key, std::size_t length) const {
+        return filterLength == 0 || length < filterLength ||
+               filter.mayContain(typename Index::hasher()(key, filterLength));
+    }
+};
+
+/**
+ * A tuple along with the position of its master copy within a column store, as
+ * it is passed to columnar indices.
+ *
+ * @tparam Tuple .. the type of tuple represented
+ */
+template <typename Tuple>
+struct columnar_row {
+    enum { arity = Tuple::arity };
+
+    // the values of the tuple
+    const Tuple& tuple;
+
+    // the position of the master copy, unused for lookup keys
+    std::size_t row;
+};
+
+/**
+ * An index for relations storing their tuples column-wise. Each entry holds
+ * only the columns covered by the index along with the location of the master
+ * copy of the tuple, such that the columns not covered are stored once by the
+ * relation rather than in every index. Iterators provide the position of the
+ * master copies.
+ *
+ * @tparam Row .. the columnar_row type passed to this index
+ * @tparam Index .. the index to be internally utilized.
+ */
+template <typename Row, typename Index>
+class ColumnarIndex;
+
+template <typename Row, unsigned... Columns>
+class ColumnarIndex<Row, index<Columns...>> {
+    using Index = index<Columns...>;
+
+    // a row position exceeding all others, bounding ranges from above
+    static constexpr std::size_t MAX_ROW = ~std::size_t(0);
+
+    // the number of columns stored in each entry
+    enum { width = sizeof...(Columns) };
+
+    /* An entry, holding the indexed columns in the order of the data. */
+    struct entry {
+        RamDomain key[width];
+        std::size_t row;
+    };
+
+    /* Orders entries by their key, and entries of equal keys by their row. */
+    struct comparator {
+        int operator()(const entry& a, const entry& b) const {
+            for (unsigned i = 0; i < width; i++) {
+                if (a.key[i] < b.key[i]) return -1;
+                if (a.key[i] > b.key[i]) return 1;
+            }
+            return (a.row < b.row) ? -1 : ((a.row > b.row) ? 1 : 0);
+        }
+        bool less(const entry& a, const entry& b) const {
+            return operator()(a, b) < 0;
+        }
+        bool equal(const entry& a, const entry& b) const {
+            return operator()(a, b) == 0;
+        }
+    };
+
+    using data_structure =
+            btree_set<entry, comparator, std::allocator<entry>, 256, souffle::detail::linear_search>;
+
+public:
+    /* An iterator over the master copies of the covered tuples. */
+    class iterator : public std::iterator<std::forward_iterator_tag, std::size_t> {
+        typename data_structure::const_iterator cur;
+
+    public:
+        iterator() = default;
+
+        iterator(const typename data_structure::const_iterator& cur) : cur(cur) {}
+
+        std::size_t operator*() const {
+            return (*cur).row;
+        }
+
+        iterator& operator++() {
+            ++cur;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return cur != other.cur;
+        }
+    };
+
+    using operation_hints = typename data_structure::operation_hints;
+
+private:
+    // the enclosed index
+    data_structure data;
+
+    /* creates the entry of a row whose columns from the given position onwards are set to value */
+    static entry toEntry(const Row& r, unsigned length, RamDomain value, std::size_t row) {
+        entry res = {{r.tuple[Columns]...}, row};
+        for (unsigned i = length; i < width; i++) {
+            res.key[i] = value;
+        }
+        return res;
+    }
+
+public:
+    bool empty() const {
+        return data.empty();
+    }
+
+    std::size_t size() const {
+        return data.size();
+    }
+
+    bool insert(const Row& r, operation_hints& hints) {
+        return data.insert(toEntry(r, width, 0, r.row), hints);
+    }
+
+    template <typename SubIndex>
+    range<iterator> equalRange(const Row& key, operation_hints& hints) const {
+        auto low = toEntry(key, SubIndex::size, MIN_RAM_DOMAIN, 0);
+        auto hig = toEntry(key, SubIndex::size, MAX_RAM_DOMAIN, MAX_ROW);
+        return make_range(iterator(data.lower_bound(low, hints)), iterator(data.upper_bound(hig, hints)));
+    }
+
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(const Row& low, const Row& high, operation_hints& hints) const {
+        static_assert(is_range_compatible_with<SubIndex, Column, Index>::value, "Invalid range query!");
+
+        // an empty range if the bounds are crossing
+        if (low.tuple[Column] > high.tuple[Column]) {
+            return make_range(end(), end());
+        }
+
+        auto lowKey = toEntry(low, SubIndex::size + 1, MIN_RAM_DOMAIN, 0);
+        auto higKey = toEntry(high, SubIndex::size + 1, MAX_RAM_DOMAIN, MAX_ROW);
+        return make_range(
+                iterator(data.lower_bound(lowKey, hints)), iterator(data.upper_bound(higKey, hints)));
+    }
+
+    iterator begin() const {
+        return data.begin();
+    }
+
+    iterator end() const {
+        return data.end();
+    }
+
+    void clear() {
+        data.clear();
+    }
+
+    /* Obtains the number of bytes occupied by this index. */
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
+    static void printDescription(std::ostream& out) {
+        out << "columnar-btree-index(" << Index() << ")";
+    }
+
+    void printHintStatistics(std::ostream& out, const std::string& prefix) const {
+        const auto& stats = data.getHintStatistics();
+        out << prefix << "Columnar B-Tree Index: (Hits/Misses/Total)\n";
+        out << prefix << "       Insert: " << stats.inserts.getHits() << "/" << stats.inserts.getMisses()
+            << "/" << stats.inserts.getAccesses() << "\n";
+
+        out << prefix << "  lower bound: " << stats.lower_bound.getHits() << "/"
+            << stats.lower_bound.getMisses() << "/" << stats.lower_bound.getAccesses() << "\n";
+
+        out << prefix << "  upper bound: " << stats.upper_bound.getHits() << "/"
+            << stats.upper_bound.getMisses() << "/" << stats.upper_bound.getAccesses() << "\n";
+    }
+};
+
+/**
+ * An index storing its tuples within compressed leaves. The tuples of a leaf
+ * are kept in the order of the index, each being encoded relative to its
+ * predecessor: columns shared with the predecessor are elided, the first
+ * differing column is encoded as the delta to the value of the predecessor,
+ * and the remaining columns are encoded zig-zag, all using a variable-byte
+ * encoding. Leaves are located through a b-tree over their first tuples and
+ * decompressed while being iterated.
+ *
+ * Tuples sharing leading columns -- like the edges of a graph indexed by
+ * their source -- thus only occupy a few bytes each, at the price of decoding
+ * a leaf on each lookup and of serializing insertions.
+ *
+ * @tparam Tuple .. the type of tuple to be maintained by this index
+ * @tparam Index .. the full index defining the order of the tuples
+ */
+template <typename Tuple, typename Index>
+class CompressedIndex;
+
+template <typename Tuple, unsigned... Columns>
+class CompressedIndex<Tuple, index<Columns...>> {
+    using Index = index<Columns...>;
+
+    static_assert(sizeof...(Columns) == Tuple::arity, "Compressed indices have to be full indices!");
+
+    enum { arity = Tuple::arity };
+
+    // the maximal number of tuples per leaf
+    enum { LEAF_CAPACITY = 128 };
+
+    using udomain = typename std::make_unsigned<RamDomain>::type;
+
+    /* A leaf, holding the encoded tuples of a range of the index. */
+    struct Leaf {
+        std::vector<uint8_t> data;
+        std::size_t size = 0;
+        Leaf* next = nullptr;
+    };
+
+    /* A leaf along with its first tuple, in the order of the index. */
+    struct separator {
+        Tuple key;
+        Leaf* leaf;
+    };
+
+    /* Orders separators descendingly, such that a lower bound yields the last leaf not exceeding a key. */
+    struct separator_comparator {
+        int operator()(const separator& a, const separator& b) const {
+            return (b.key < a.key) ? -1 : ((a.key < b.key) ? 1 : 0);
+        }
+        bool less(const separator& a, const separator& b) const {
+            return b.key < a.key;
+        }
+        bool equal(const separator& a, const separator& b) const {
+            return a.key == b.key;
+        }
+    };
+
+    /* Appends the variable-byte encoding of the given value. */
+    static void putVarint(std::vector<uint8_t>& out, udomain value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    /* Decodes a variable-byte encoded value, advancing the given position. */
+    static udomain getVarint(const uint8_t*& pos) {
+        udomain res = 0;
+        unsigned shift = 0;
+        while (*pos & 0x80) {
+            res |= static_cast<udomain>(*pos++ & 0x7f) << shift;
+            shift += 7;
+        }
+        return res | (static_cast<udomain>(*pos++) << shift);
+    }
+
+    /* Appends the encoding of a tuple relative to its predecessor, both in the order of the index. */
+    static void encode(std::vector<uint8_t>& out, const Tuple& prev, const Tuple& cur) {
+        unsigned shared = 0;
+        while (shared < arity && prev[shared] == cur[shared]) {
+            shared++;
+        }
+        putVarint(out, shared);
+        if (shared == arity) {
+            return;
+        }
+        putVarint(out, static_cast<udomain>(cur[shared]) - static_cast<udomain>(prev[shared]));
+        for (unsigned i = shared + 1; i < arity; i++) {
+            auto value = static_cast<udomain>(cur[i]);
+            putVarint(out, (value << 1) ^ static_cast<udomain>(cur[i] < 0 ? -1 : 0));
+        }
+    }
+
+    /* Decodes the successor of the given tuple, advancing the given position. */
+    static void decode(const uint8_t*& pos, Tuple& cur) {
+        unsigned shared = getVarint(pos);
+        if (shared == arity) {
+            return;
+        }
+        cur[shared] = static_cast<RamDomain>(static_cast<udomain>(cur[shared]) + getVarint(pos));
+        for (unsigned i = shared + 1; i < arity; i++) {
+            udomain value = getVarint(pos);
+            cur[i] = static_cast<RamDomain>((value >> 1) ^ (~(value & 1) + 1));
+        }
+    }
+
+    /* Converts a tuple into the order of the index. */
+    static Tuple orderIn(const Tuple& tuple) {
+        return Tuple{{tuple[Columns]...}};
+    }
+
+    /* Converts a tuple in the order of the index back into its original order. */
+    static void orderOut(const Tuple& ordered, Tuple& res) {
+        const unsigned order[] = {Columns...};
+        for (unsigned i = 0; i < arity; i++) {
+            res[order[i]] = ordered[i];
+        }
+    }
+
+public:
+    /* An iterator decompressing the tuples of the leaves it passes. */
+    class iterator : public std::iterator<std::forward_iterator_tag, Tuple> {
+        friend class CompressedIndex;
+
+        // the current leaf, null for the end
+        const Leaf* leaf = nullptr;
+
+        // the offsets of the encodings of the current and the next tuple within the leaf
+        std::size_t pos = 0;
+        std::size_t next = 0;
+
+        // the current tuple in the order of the index and in its original order
+        Tuple ordered;
+        Tuple value;
+
+        /* Decodes the tuple at the current position. */
+        void load() {
+            const uint8_t* cur = leaf->data.data() + pos;
+            decode(cur, ordered);
+            next = cur - leaf->data.data();
+            orderOut(ordered, value);
+        }
+
+    public:
+        iterator() = default;
+
+        /* Creates an iterator pointing to the first tuple of the given leaf. */
+        iterator(const Leaf* leaf) : leaf(leaf), ordered() {
+            if (leaf) {
+                load();
+            }
+        }
+
+        const Tuple& operator*() const {
+            return value;
+        }
+
+        const Tuple* operator->() const {
+            return &value;
+        }
+
+        iterator& operator++() {
+            if (next < leaf->data.size()) {
+                pos = next;
+                load();
+            } else {
+                *this = iterator(leaf->next);
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return leaf == other.leaf && pos == other.pos;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /* Insertions are serialized and lookups decode a single leaf, thus no hints are maintained. */
+    struct operation_hints {};
+
+private:
+    // the first leaf, null if the index has never been filled
+    Leaf* head = nullptr;
+
+    // the separators of all leaves but the first
+    btree_set<separator, separator_comparator> separators;
+
+    // the number of indexed tuples
+    std::size_t numTuples = 0;
+
+    // the lock serializing insertions
+    Lock insert_lock;
+
+    /* Obtains the leaf which covers the given tuple, given in the order of the index. */
+    Leaf* findLeaf(const Tuple& key) const {
+        auto pos = separators.lower_bound(separator{key, nullptr});
+        return (pos == separators.end()) ? head : (*pos).leaf;
+    }
+
+    /* Obtains the first tuple not less than -- or, if strict, greater than -- the given key. */
+    iterator seek(const Tuple& key, bool strict) const {
+        if (numTuples == 0) {
+            return end();
+        }
+        // later leaves only hold greater tuples, thus the scan ends within the next leaf
+        iterator res(findLeaf(key));
+        while (res.leaf && (res.ordered < key || (strict && res.ordered == key))) {
+            ++res;
+        }
+        return res;
+    }
+
+    /* Splits the given leaf into two halves. */
+    void split(Leaf* leaf) {
+        std::vector<Tuple> tuples;
+        Tuple cur = Tuple();
+        const uint8_t* pos = leaf->data.data();
+        for (std::size_t i = 0; i < leaf->size; i++) {
+            decode(pos, cur);
+            tuples.push_back(cur);
+        }
+
+        std::size_t half = tuples.size() / 2;
+        auto encodeRange = [&](Leaf& res, std::size_t from, std::size_t to) {
+            std::vector<uint8_t> data;
+            Tuple prev = Tuple();
+            for (std::size_t i = from; i < to; i++) {
+                encode(data, prev, tuples[i]);
+                prev = tuples[i];
+            }
+            data.shrink_to_fit();
+            res.data.swap(data);
+            res.size = to - from;
+        };
+
+        auto* second = new Leaf();
+        encodeRange(*second, half, tuples.size());
+        encodeRange(*leaf, 0, half);
+        second->next = leaf->next;
+        leaf->next = second;
+        separators.insert(separator{tuples[half], second});
+    }
+
+public:
+    CompressedIndex() = default;
+
+    CompressedIndex(const CompressedIndex&) = delete;
+
+    CompressedIndex& operator=(const CompressedIndex&) = delete;
+
+    ~CompressedIndex() {
+        clear();
+    }
+
+    bool empty() const {
+        return numTuples == 0;
+    }
+
+    std::size_t size() const {
+        return numTuples;
+    }
+
+    bool insert(const Tuple& tuple, operation_hints&) {
+        auto lease = insert_lock.acquire();
+        Tuple key = orderIn(tuple);
+        if (!head) {
+            head = new Leaf();
+        }
+        Leaf* leaf = findLeaf(key);
+
+        // locate the predecessor and the successor of the new tuple within the leaf
+        const uint8_t* begin = leaf->data.data();
+        const uint8_t* end = begin + leaf->data.size();
+        const uint8_t* pos = begin;
+        Tuple prev = Tuple();
+        while (pos != end) {
+            const uint8_t* cur = pos;
+            Tuple succ = prev;
+            decode(cur, succ);
+            if (succ == key) {
+                return false;
+            }
+            if (key < succ) {
+                break;
+            }
+            prev = succ;
+            pos = cur;
+        }
+
+        // re-encode the successor relative to the new tuple, keeping the remaining encodings
+        std::vector<uint8_t> encoded;
+        encode(encoded, prev, key);
+        const uint8_t* rest = pos;
+        if (pos != end) {
+            Tuple succ = prev;
+            decode(rest, succ);
+            encode(encoded, key, succ);
+        }
+        std::vector<uint8_t> data;
+        data.reserve((pos - begin) + encoded.size() + (end - rest));
+        data.insert(data.end(), begin, pos);
+        data.insert(data.end(), encoded.begin(), encoded.end());
+        data.insert(data.end(), rest, end);
+        leaf->data.swap(data);
+        leaf->size++;
+        numTuples++;
+
+        if (leaf->size > LEAF_CAPACITY) {
+            split(leaf);
+        }
+        return true;
+    }
+
+    void insertAll(const CompressedIndex& other) {
+        operation_hints hints;
+        for (const auto& cur : other) {
+            insert(cur, hints);
+        }
+    }
+
+    bool contains(const Tuple& tuple, operation_hints&) const {
+        Tuple key = orderIn(tuple);
+        iterator pos = seek(key, false);
+        return pos.leaf && pos.ordered == key;
+    }
+
+    template <typename SubIndex>
+    range<iterator> equalRange(const Tuple& key, operation_hints&) const {
+        return make_range(seek(orderIn(lower<Index, SubIndex>(key)), false),
+                seek(orderIn(raise<Index, SubIndex>(key)), true));
+    }
+
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(const Tuple& low, const Tuple& high, operation_hints&) const {
+        static_assert(is_range_compatible_with<SubIndex, Column, Index>::value, "Invalid range query!");
+        using RangeIndex = typename extend<SubIndex, Column>::type;
+
+        // an empty range if the bounds are crossing
+        if (low[Column] > high[Column]) {
+            return make_range(end(), end());
+        }
+
+        return make_range(seek(orderIn(lower<Index, RangeIndex>(low)), false),
+                seek(orderIn(raise<Index, RangeIndex>(high)), true));
     }
 
     iterator begin() const {
-        return index.begin();
+        return (numTuples == 0) ? end() : iterator(head);
     }
 
     iterator end() const {
-        return index.end();
+        return iterator();
     }
 
     void clear() {
-        index.clear();
+        while (head) {
+            Leaf* next = head->next;
+            delete head;
+            head = next;
+        }
+        separators.clear();
+        numTuples = 0;
     }
 
     std::vector<range<iterator>> partition() const {
-        return index.getChunks(400);
+        std::vector<range<iterator>> res;
+        if (numTuples == 0) {
+            return res;
+        }
+        std::size_t step = std::max<std::size_t>(1, (separators.size() + 1) / 400);
+        const Leaf* cur = head;
+        while (cur) {
+            const Leaf* first = cur;
+            for (std::size_t i = 0; cur && i < step; i++) {
+                cur = cur->next;
+            }
+            res.push_back(make_range(iterator(first), iterator(cur)));
+        }
+        return res;
+    }
+
+    /* Obtains the number of bytes occupied by the encoded tuples and their leaves. */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = 0;
+        for (const Leaf* cur = head; cur; cur = cur->next) {
+            res += sizeof(Leaf) + cur->data.capacity();
+        }
+        return res + separators.getMemoryUsage();
     }
 
     static void printDescription(std::ostream& out) {
-        out << "direct-btree-index(" << Index() << ")";
+        out << "compressed-btree-index(" << Index() << ")";
     }
 
     void printHintStatistics(std::ostream& out, const std::string& prefix) const {
-        const auto& stats = index.getHintStatistics();
-        out << prefix << "Direct B-Tree Index: (Hits/Misses/Total)\n";
-        out << prefix << "       Insert: " << stats.inserts.getHits() << "/" << stats.inserts.getMisses()
-            << "/" << stats.inserts.getAccesses() << "\n";
-
-        out << prefix << "     Contains: " << stats.contains.getHits() << "/" << stats.contains.getMisses()
-            << "/" << stats.contains.getAccesses() << "\n";
-
-        out << prefix << "  lower bound: " << stats.lower_bound.getHits() << "/"
-            << stats.lower_bound.getMisses() << "/" << stats.lower_bound.getAccesses() << "\n";
-
-        out << prefix << "  upper bound: " << stats.upper_bound.getHits() << "/"
-            << stats.upper_bound.getMisses() << "/" << stats.upper_bound.getAccesses() << "\n";
+        out << prefix << "Compressed B-Tree Index: " << numTuples << " tuples in "
+            << (head ? separators.size() + 1 : 0) << " leaves\n";
     }
 };
 
 /**
- * A wrapper realizing indirect indices -- by storing pointers to the
- * actually indexed values.
+ * An index for relations exceeding the available memory. Recently inserted
+ * tuples are kept in a b-tree, older ones in a sorted run within a memory-mapped
+ * file of the spill directory. Once the SpillManager asks for memory, the
+ * b-tree is merged with the run into a new run, such that queries only merge
+ * two sorted sequences and the pages of the run are left to the operating
+ * system. Insertions are serialized.
  *
  * @tparam Tuple .. the type of tuple to be maintained by this index
- * @tparam Index .. the index to be internally utilized.
+ * @tparam Index .. the full index defining the order of the tuples
  */
 template <typename Tuple, typename Index>
-struct IndirectIndex {
-    using data_structure = typename std::conditional<(int)(Tuple::arity) == (int)(Index::size),
-            btree_set<const Tuple*, index_utils::deref_compare<typename Index::comparator>>,
-            btree_multiset<const Tuple*, index_utils::deref_compare<typename Index::comparator>>>::type;
+class SpillIndex : private Spillable {
+    using comparator = typename Index::comparator;
 
-    using key_type = typename std::remove_cv<
-            typename std::remove_pointer<typename data_structure::key_type>::type>::type;
+    using buffer_t = btree_set<Tuple, comparator>;
 
-    using iterator = IterDerefWrapper<typename data_structure::const_iterator>;
+    static_assert(sizeof(Tuple) == sizeof(RamDomain) * Tuple::arity, "Tuples have to be stored densely!");
 
-    using operation_hints = typename data_structure::operation_hints;
+    // the number of insertions between two checks of the memory budget
+    enum { CHECK_INTERVAL = 1024 };
+
+    /* The order of tuples as a binary predicate. */
+    struct less {
+        bool operator()(const Tuple& a, const Tuple& b) const {
+            return comparator().less(a, b);
+        }
+    };
+
+public:
+    /* An iterator merging the tuples of the b-tree and the run. */
+    class iterator : public std::iterator<std::forward_iterator_tag, Tuple> {
+        typename buffer_t::const_iterator cur;
+        typename buffer_t::const_iterator end;
+        const Tuple* runCur = nullptr;
+        const Tuple* runEnd = nullptr;
+
+        // whether the current tuple is the one of the run
+        bool inRun = false;
+
+        void select() {
+            inRun = runCur != runEnd && (cur == end || less()(*runCur, *cur));
+        }
+
+    public:
+        iterator() = default;
+
+        iterator(const typename buffer_t::const_iterator& cur, const typename buffer_t::const_iterator& end,
+                const Tuple* runCur, const Tuple* runEnd)
+                : cur(cur), end(end), runCur(runCur), runEnd(runEnd) {
+            select();
+        }
+
+        const Tuple& operator*() const {
+            return inRun ? *runCur : *cur;
+        }
+
+        const Tuple* operator->() const {
+            return &**this;
+        }
+
+        iterator& operator++() {
+            if (inRun) {
+                ++runCur;
+            } else {
+                ++cur;
+            }
+            select();
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur && runCur == other.runCur;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    using operation_hints = typename buffer_t::operation_hints;
 
 private:
-    // the enclosed index
-    data_structure index;
+    // the recently inserted tuples
+    buffer_t buffer;
+
+    // the spilled tuples
+    MappedRun run;
+
+    // the number of indexed tuples
+    std::size_t numTuples = 0;
+
+    // the number of insertions since the memory budget has been checked
+    std::size_t sinceCheck = 0;
+
+    // the lock serializing insertions
+    Lock insert_lock;
+
+    const Tuple* runBegin() const {
+        return reinterpret_cast<const Tuple*>(run.begin());
+    }
+
+    const Tuple* runEnd() const {
+        return reinterpret_cast<const Tuple*>(run.end());
+    }
+
+    /* Obtains the range of tuples between the given bounds. */
+    range<iterator> getRange(const Tuple& low, const Tuple& high, operation_hints& hints) const {
+        auto from = buffer.lower_bound(low, hints);
+        auto to = buffer.upper_bound(high, hints);
+        const Tuple* runFrom = std::lower_bound(runBegin(), runEnd(), low, less());
+        const Tuple* runTo = std::upper_bound(runFrom, runEnd(), high, less());
+        return make_range(iterator(from, to, runFrom, runTo), iterator(to, to, runTo, runTo));
+    }
+
+    /* Merges the b-tree into the run. */
+    void spill() {
+        MappedRun merged;
+        merged.open();
+        for (const auto& cur : *this) {
+            merged.append(&cur[0], Tuple::arity);
+        }
+        merged.seal();
+        run = std::move(merged);
+        buffer.clear();
+        setResidentSize(0);
+        resetAccesses();
+    }
 
 public:
     bool empty() const {
-        return index.empty();
+        return numTuples == 0;
     }
 
     std::size_t size() const {
-        return index.size();
+        return numTuples;
     }
 
-    bool insert(const key_type& key, operation_hints& hints) {
-        // insert the element (insert is synchronized internally)
-        return index.insert(&key, hints);
+    bool insert(const Tuple& key, operation_hints& hints) {
+        auto lease = insert_lock.acquire();
+        if (std::binary_search(runBegin(), runEnd(), key, less()) || !buffer.insert(key, hints)) {
+            return false;
+        }
+        numTuples++;
+
+        // check the memory budget every once in a while, estimating the size of the b-tree
+        if (++sinceCheck == CHECK_INTERVAL) {
+            sinceCheck = 0;
+            setResidentSize(buffer.size() * sizeof(Tuple));
+            if (SpillManager::instance().shouldSpill(*this)) {
+                spill();
+            }
+        }
+        return true;
     }
 
-    void insertAll(const IndirectIndex& other) {
-        // use index's insert-all
-        index.insertAll(other.index);
+    void insertAll(const SpillIndex& other) {
+        operation_hints hints;
+        for (const auto& cur : other) {
+            insert(cur, hints);
+        }
     }
 
-    bool contains(const key_type& key, operation_hints& hints) const {
-        return index.contains(&key, hints);
+    bool contains(const Tuple& key, operation_hints& hints) const {
+        const_cast<SpillIndex*>(this)->touch();
+        return buffer.contains(key, hints) || std::binary_search(runBegin(), runEnd(), key, less());
     }
 
-    iterator find(const key_type& key, operation_hints& hints) const {
-        return index.find(&key, hints);
+    template <typename SubIndex>
+    range<iterator> equalRange(const Tuple& key, operation_hints& hints) const {
+        const_cast<SpillIndex*>(this)->touch();
+        return getRange(lower<Index, SubIndex>(key), raise<Index, SubIndex>(key), hints);
     }
 
-    template <typename SubIndex>
-    range<iterator> equalRange(const key_type& key, operation_hints& hints) const {
-        // more efficient support for full-indices
-        if (int(SubIndex::size) == int(Index::size) && int(Index::size) == int(key_type::arity)) {
-            // in this case there is at most one element with this value
-            auto pos = find(key, hints);
-            auto end = this->end();
-            if (pos != end) {
-                end = pos;
-                ++end;
-            }
-            return make_range(pos, end);
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(const Tuple& low, const Tuple& high, operation_hints& hints) const {
+        static_assert(is_range_compatible_with<SubIndex, Column, Index>::value, "Invalid range query!");
+        using RangeIndex = typename extend<SubIndex, Column>::type;
+
+        // an empty range if the bounds are crossing
+        if (low[Column] > high[Column]) {
+            return make_range(end(), end());
         }
 
-        // compute lower and upper bounds
-        auto low = lower<Index, SubIndex>(key);
-        auto hig = raise<Index, SubIndex>(key);
-        return make_range(
-                derefIter(index.lower_bound(&low, hints)), derefIter(index.upper_bound(&hig, hints)));
+        const_cast<SpillIndex*>(this)->touch();
+        return getRange(lower<Index, RangeIndex>(low), raise<Index, RangeIndex>(high), hints);
     }
 
     iterator begin() const {
-        return index.begin();
+        return iterator(buffer.begin(), buffer.end(), runBegin(), runEnd());
     }
 
     iterator end() const {
-        return index.end();
+        return iterator(buffer.end(), buffer.end(), runEnd(), runEnd());
     }
 
     void clear() {
-        index.clear();
+        buffer.clear();
+        run = MappedRun();
+        numTuples = 0;
+        setResidentSize(0);
     }
 
-    /**
-     * Return a list of iterators, s.t. we can process in parallel.
-     * "an approximation of the number of sub-ranges to be included in the resulting partition."
-     * "The numbers there [400] are not very important, as long as they are large enough (~10x the number of
-     * maximum expected cores)
-     * and not too large, such that processing a fragment lasts less than e.g. 1ms."
-     * @param np the number of iterators to attempt to return, which represents slices of the data structure
-     * @return a vector of these iterator ranges
-     */
     std::vector<range<iterator>> partition() const {
         std::vector<range<iterator>> res;
-        for (const auto& cur : index.getChunks(400)) {
-            res.push_back(make_range(derefIter(cur.begin()), derefIter(cur.end())));
+
+        // split spilled tuples evenly
+        if (buffer.empty()) {
+            std::size_t step = std::max<std::size_t>(1, (runEnd() - runBegin()) / 400);
+            for (const Tuple* cur = runBegin(); cur < runEnd(); cur += step) {
+                const Tuple* next = std::min(cur + step, runEnd());
+                res.push_back(make_range(iterator(buffer.end(), buffer.end(), cur, next),
+                        iterator(buffer.end(), buffer.end(), next, next)));
+            }
+            return res;
+        }
+
+        // otherwise split along the chunks of the b-tree, assigning the spilled tuples in between
+        auto chunks = buffer.getChunks(400);
+        const Tuple* from = runBegin();
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            const auto& chunk = chunks[i];
+            // the spilled tuples preceding the next chunk belong to this one
+            const Tuple* to = runEnd();
+            if (i + 1 < chunks.size()) {
+                to = std::lower_bound(from, runEnd(), *chunk.end(), less());
+            }
+            res.push_back(make_range(iterator(chunk.begin(), chunk.end(), from, to),
+                    iterator(chunk.end(), chunk.end(), to, to)));
+            from = to;
         }
         return res;
     }
 
+    /* Obtains the number of bytes kept in memory, excluding the spilled tuples. */
+    std::size_t getMemoryUsage() const {
+        return buffer.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
-        out << "indirect-btree-index(" << Index() << ")";
+        out << "spill-btree-index(" << Index() << ")";
     }
 
     void printHintStatistics(std::ostream& out, const std::string& prefix) const {
-        const auto& stats = index.getHintStatistics();
-        out << prefix << "Indirect B-Tree Index: (Hits/Misses/Total)\n";
-        out << prefix << "       Insert: " << stats.inserts.getHits() << "/" << stats.inserts.getMisses()
-            << "/" << stats.inserts.getAccesses() << "\n";
-
-        out << prefix << "     Contains: " << stats.contains.getHits() << "/" << stats.contains.getMisses()
-            << "/" << stats.contains.getAccesses() << "\n";
-
-        out << prefix << "  lower bound: " << stats.lower_bound.getHits() << "/"
-            << stats.lower_bound.getMisses() << "/" << stats.lower_bound.getAccesses() << "\n";
-
-        out << prefix << "  upper bound: " << stats.upper_bound.getHits() << "/"
-            << stats.upper_bound.getMisses() << "/" << stats.upper_bound.getAccesses() << "\n";
+        out << prefix << "Spill B-Tree Index: " << buffer.size() << " tuples in memory, "
+            << (runEnd() - runBegin()) << " tuples spilled\n";
     }
 };
 
@@ -854,6 +1939,10 @@ class TrieIndex {
 
     tree_type data;
 
+    // a Bloom filter over the first filterLength columns of the indexed tuples, if non-zero
+    BloomFilter filter;
+    std::size_t filterLength = 0;
+
 public:
     using operation_hints = typename tree_type::op_context;
 
@@ -866,21 +1955,60 @@ public:
     }
 
     bool contains(const tuple_type& tuple, operation_hints& ctxt) const {
-        return data.contains(orderIn(tuple), ctxt);
+        return mayContain(tuple, tuple_type::arity) && data.contains(orderIn(tuple), ctxt);
     }
 
     bool insert(const tuple_type& tuple, operation_hints& ctxt) {
         // the Trie-insert is synchronized internally
-        return data.insert(orderIn(tuple), ctxt);
+        if (!data.insert(orderIn(tuple), ctxt)) {
+            return false;
+        }
+        if (filterLength != 0) {
+            filter.insert(typename Index::hasher()(tuple, filterLength));
+        }
+        return true;
+    }
+
+    /* Removes the given tuple. The Bloom filter keeps its bits, which only admits false positives. */
+    bool erase(const tuple_type& tuple, operation_hints& ctxt) {
+        // the context may reference nested tries released by the erasure
+        ctxt = operation_hints();
+        return data.erase(orderIn(tuple));
     }
 
     void insertAll(const TrieIndex& other) {
         // use trie merge
         data.insertAll(other.data);
+        if (filterLength != 0) {
+            for (const auto& cur : other) {
+                filter.insert(typename Index::hasher()(cur, filterLength));
+            }
+        }
+    }
+
+    /**
+     * Maintains a Bloom filter over the first length columns of this index,
+     * such that lookups of absent keys binding those columns skip the index.
+     */
+    void enableFilter(std::size_t length) {
+        if (filterLength != 0 && filterLength <= length) {
+            return;
+        }
+        filterLength = length;
+        filter.clear();
+        for (const auto& cur : *this) {
+            filter.insert(typename Index::hasher()(cur, length));
+        }
     }
 
     void clear() {
         data.clear();
+        filter.clear();
+    }
+
+    // provides access to the trie storing the tuples in the order of this index
+    const tree_type& getTrie() const {
+        return data;
     }
 
     // ---------------------------------------------
@@ -961,10 +2089,26 @@ public:
     template <typename SubIndex>
     range<iterator> equalRange(const tuple_type& tuple, operation_hints& ctxt) const {
         static_assert(is_compatible_with<SubIndex, Index>::value, "Invalid sub-index query!");
+        // skip the lookup if the tuple is known to be absent
+        if (!mayContain(tuple, SubIndex::size)) {
+            return make_range(end(), end());
+        }
         auto r = data.template getBoundaries<SubIndex::size>(orderIn(tuple), ctxt);
         return make_range(iterator(r.begin()), iterator(r.end()));
     }
 
+    // the range column is not narrowed; the remaining filter of the query covers the bounds
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(
+            const tuple_type& low, const tuple_type& high, operation_hints& ctxt) const {
+        return equalRange<SubIndex>(low, ctxt);
+    }
+
+    /* Obtains the number of bytes occupied by this index. */
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage() + filter.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
         out << "trie-index(" << Index() << ")";
     }
@@ -983,6 +2127,12 @@ public:
     }
 
 private:
+    // determines whether a key binding the first length columns may be present
+    bool mayContain(const tuple_type& key, std::size_t length) const {
+        return filterLength == 0 || length < filterLength ||
+               filter.mayContain(typename Index::hasher()(key, filterLength));
+    }
+
     static tuple_type orderIn(const tuple_type& tuple) {
         tuple_type res;
         order<Index>().order_in(res, tuple);
@@ -1168,6 +2318,18 @@ public:
         return make_range(iterator(r.begin()), iterator(r.end()));
     }
 
+    // the range column is not narrowed; the remaining filter of the query covers the bounds
+    template <typename SubIndex, unsigned Column>
+    range<iterator> lowerUpperRange(
+            const tuple_type& low, const tuple_type& high, operation_hints& ctxt) const {
+        return equalRange<SubIndex>(low, ctxt);
+    }
+
+    /* Obtains the number of bytes occupied by this index. */
+    std::size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
     static void printDescription(std::ostream& out) {
         out << "disjoint-set-index(" << Index() << ")";
     }
@@ -1191,6 +2353,64 @@ private:
 };
 // -------------------------------------------------------------
 
+/* Enables the Bloom filter of the given index structure, if it supports one. */
+template <typename Index>
+auto enable_filter(Index& index, std::size_t length, int) -> decltype(index.enableFilter(length), void()) {
+    index.enableFilter(length);
+}
+
+template <typename Index>
+void enable_filter(Index&, std::size_t, long) {}
+
+/* Fills the given index with the referenced tuples, bulk-loading them if supported by the index structure. */
+template <typename Index, typename T>
+auto load_sorted(Index& index, const std::vector<const T*>& tuples, int)
+        -> decltype(index.loadSorted(tuples), void()) {
+    index.loadSorted(tuples);
+}
+
+template <typename Index, typename T>
+void load_sorted(Index& index, const std::vector<const T*>& tuples, long) {
+    // inserting in order keeps the operation hints effective
+    typename Index::operation_hints hints;
+    for (const T* cur : tuples) {
+        index.insert(*cur, hints);
+    }
+}
+
+/* Removes the given tuple from the given index structure, if it supports erasures. */
+template <typename Index, typename T>
+auto erase_tuple(Index& index, const T& tuple, typename Index::operation_hints& hints, int)
+        -> decltype(index.erase(tuple, hints)) {
+    return index.erase(tuple, hints);
+}
+
+/**
+ * Otherwise the index structure is rebuilt from its remaining tuples, which have to be stored
+ * directly. Structures implying further tuples, like equivalence relations, may imply the
+ * erased tuple again; the result states whether it is gone.
+ */
+template <typename Index, typename T>
+bool erase_tuple(Index& index, const T& tuple, typename Index::operation_hints& hints, long) {
+    if (!index.contains(tuple, hints)) {
+        return false;
+    }
+    std::vector<T> rest;
+    for (const auto& cur : index) {
+        if (!(cur == tuple)) {
+            rest.push_back(cur);
+        }
+    }
+    index.clear();
+    hints = typename Index::operation_hints();
+    for (const auto& cur : rest) {
+        index.insert(cur, hints);
+    }
+    return !index.contains(tuple, hints);
+}
+
+// -------------------------------------------------------------
+
 /* A direct index factory only supporting direct indices */
 template <typename T, typename Index, bool complete>
 struct direct_index_factory;
@@ -1236,6 +2456,12 @@ struct index_factory<T, Index, false> {
     using type = IndirectIndex<T, Index>;
 };
 
+/* A factory selecting columnar indices, for relations storing their tuples column-wise. */
+template <typename T, typename Index, bool>
+struct columnar_index_factory {
+    using type = ColumnarIndex<T, Index>;
+};
+
 // -------------------------------------------------------------
 
 /**
@@ -1282,6 +2508,24 @@ public:
                 typename nested_indices::template iter_type<Index>::type>::type;
     };
 
+    // a utility to verify whether a range query on a column is covered by this or a nested index
+    template <typename Index, unsigned Column>
+    struct is_range_covered {
+        enum {
+            value = is_range_compatible_with<Index, Column, First>::value ||
+                    nested_indices::template is_range_covered<Index, Column>::value
+        };
+    };
+
+    // a type trait to determine the iterator type of a range query, falling back to an equal-range query
+    template <typename Index, unsigned Column>
+    struct range_iter_type {
+        using type = typename std::conditional<is_range_compatible_with<Index, Column, First>::value, iterator,
+                typename std::conditional<nested_indices::template is_range_covered<Index, Column>::value,
+                        typename nested_indices::template range_iter_type<Index, Column>::type,
+                        typename iter_type<Index>::type>::type>::type;
+    };
+
     // an operation context for operations on this index
     struct operation_context {
         // the operation context of this level
@@ -1310,11 +2554,37 @@ public:
         nested.insert(tuple, c.nested);
     }
 
+    // removes the given tuple from all indices storing their tuples directly
+    void erase(const T& tuple, operation_context& c) {
+        erase_tuple(index, tuple, c.ctxt, 0);
+        nested.erase(tuple, c.nested);
+    }
+
     void insertAll(const Indices& other) {
         index.insertAll(other.index);
         nested.insertAll(other.nested);
     }
 
+    /**
+     * Collects tasks filling the indices other than the given primary index with
+     * the referenced tuples, each sorting its own copy of the references. The
+     * tuples have to stay valid until all tasks are completed.
+     */
+    template <typename Primary>
+    void collectLoads(const std::vector<const T*>& tuples, const Primary& primary,
+            std::vector<std::function<void()>>& tasks) {
+        if (!std::is_same<First, Primary>::value) {
+            tasks.push_back([this, &tuples]() {
+                std::vector<const T*> sorted(tuples);
+                typename First::comparator comp;
+                std::sort(sorted.begin(), sorted.end(),
+                        [&](const T* a, const T* b) { return comp.less(*a, *b); });
+                load_sorted(index, sorted, 0);
+            });
+        }
+        nested.collectLoads(tuples, primary, tasks);
+    }
+
     bool contains(const T& tuple, const First&, operation_context& c) const {
         return index.contains(tuple, c.ctxt);
     }
@@ -1347,6 +2617,40 @@ public:
         return nested.template equalRange<Index>(tuple, c.nested);
     }
 
+    // enables a filter on the index answering equal-range queries on the given index
+    template <typename Index>
+    typename std::enable_if<is_compatible_with<Index, First>::value>::type enableFilter() {
+        enable_filter(index, Index::size, 0);
+    }
+
+    template <typename Index>
+    typename std::enable_if<!is_compatible_with<Index, First>::value>::type enableFilter() {
+        nested.template enableFilter<Index>();
+    }
+
+    template <typename Index, unsigned Column>
+    typename std::enable_if<is_range_compatible_with<Index, Column, First>::value,
+            range<typename range_iter_type<Index, Column>::type>>::type
+    lowerUpperRange(const T& low, const T& high, operation_context& c) const {
+        return index.template lowerUpperRange<Index, Column>(low, high, c.ctxt);
+    }
+
+    template <typename Index, unsigned Column>
+    typename std::enable_if<!is_range_compatible_with<Index, Column, First>::value &&
+                                    nested_indices::template is_range_covered<Index, Column>::value,
+            range<typename range_iter_type<Index, Column>::type>>::type
+    lowerUpperRange(const T& low, const T& high, operation_context& c) const {
+        return nested.template lowerUpperRange<Index, Column>(low, high, c.nested);
+    }
+
+    // no index is ordered by the range column => fall back to the equal-range query of the prefix
+    template <typename Index, unsigned Column>
+    typename std::enable_if<!is_range_covered<Index, Column>::value,
+            range<typename range_iter_type<Index, Column>::type>>::type
+    lowerUpperRange(const T& low, const T& high, operation_context& c) const {
+        return equalRange<Index>(low, c);
+    }
+
     void clear() {
         index.clear();
         nested.clear();
@@ -1388,6 +2692,11 @@ public:
         return out;
     }
 
+    // obtains the number of bytes occupied by all indices
+    std::size_t getMemoryUsage() const {
+        return index.getMemoryUsage() + nested.getMemoryUsage();
+    }
+
     void printHintStatistics(std::ostream& out, const std::string& prefix) const {
         out << prefix << "Multi-Index Relation:\n";
         printHintStatisticsInternal(out, prefix + "  ");
@@ -1424,10 +2733,25 @@ public:
         enum { value = false };
     };
 
+    template <typename I, unsigned Column>
+    struct is_range_covered {
+        enum { value = false };
+    };
+
+    template <typename Index, unsigned Column>
+    struct range_iter_type {
+        using type = iterator;
+    };
+
     void insert(const T&, operation_context&) {}
 
+    void erase(const T&, operation_context&) {}
+
     void insertAll(const Indices&) {}
 
+    template <typename Primary>
+    void collectLoads(const std::vector<const T*>&, const Primary&, std::vector<std::function<void()>>&) {}
+
     template <typename Index>
     bool contains(const T&, const Index&, operation_context&) const {
         assert(false && "Requested Index not available!");
@@ -1446,6 +2770,11 @@ public:
         return make_range(0, 0);
     }
 
+    template <typename Index>
+    void enableFilter() {
+        assert(false && "Requested Index not available!");
+    }
+
     void clear() {}
 
     template <typename I>
@@ -1464,6 +2793,10 @@ public:
         return out;
     }
 
+    std::size_t getMemoryUsage() const {
+        return 0;
+    }
+
     void printHintStatisticsInternal(std::ostream&, const std::string&) const {
         // nothing to do here
     }
@@ -20,6 +20,8 @@
 #include "Util.h"
 
 #include <iostream>
+#include <set>
+#include <sstream>
 #include <string>
 
 #include <getopt.h>
@@ -73,12 +75,27 @@ protected:
      */
     size_t stratumIndex;
 
+    /**
+     * serving flag
+     */
+    bool serving;
+
+    /**
+     * socket of the server, empty if requests are not served
+     */
+    std::string socket_name;
+
+    /**
+     * output relations to be computed, all if empty
+     */
+    std::set<std::string> outputs;
+
 public:
     // all argument constructor
     CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, size_t nj,
-            size_t si = (size_t)-1)
+            size_t si = (size_t)-1, bool se = false, const char* sn = "")
             : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj),
-              stratumIndex(si) {}
+              stratumIndex(si), serving(se), socket_name(sn) {}
 
     /**
      * get source code name
@@ -129,6 +146,20 @@ public:
         return stratumIndex;
     }
 
+    /**
+     * get socket of the server, empty if requests are not served
+     */
+    const std::string& getSocketName() const {
+        return socket_name;
+    }
+
+    /**
+     * get output relations to be computed, all if empty
+     */
+    const std::set<std::string>& getOutputs() const {
+        return outputs;
+    }
+
     /**
      * Parses the given command line parameters, handles -h help requests or errors
      * and returns whether the parsing was successful or not.
@@ -153,7 +184,8 @@ public:
 #ifdef _OPENMP
                 {"jobs", true, nullptr, 'j'},
 #endif
-                {"index", true, nullptr, 'i'},
+                {"index", true, nullptr, 'i'}, {"serve", true, nullptr, 's'},
+                {"outputs", true, nullptr, 'o'},
                 // the terminal option -- needs to be null
                 {nullptr, false, nullptr, 0}};
 #pragma GCC diagnostic pop
@@ -162,7 +194,7 @@ public:
         bool ok = true;
 
         int c; /* command-line arguments processing */
-        while ((c = getopt_long(argc, argv, "D:F:hp:j:i:", longOptions, nullptr)) != EOF) {
+        while ((c = getopt_long(argc, argv, "D:F:hp:j:i:s:o:", longOptions, nullptr)) != EOF) {
             switch (c) {
                 /* Fact directories */
                 case 'F':
@@ -206,6 +238,24 @@ public:
                 case 'i':
                     stratumIndex = (size_t)std::stoull(optarg);
                     break;
+                case 's':
+                    if (!serving) {
+                        std::cerr << "\nerror: incremental evaluation was not enabled in compilation\n\n";
+                        printHelpPage(exec_name);
+                        exit(1);
+                    }
+                    socket_name = optarg;
+                    break;
+                case 'o': {
+                    std::stringstream names(optarg);
+                    std::string name;
+                    while (std::getline(names, name, ',')) {
+                        if (!name.empty()) {
+                            outputs.insert(name);
+                        }
+                    }
+                    break;
+                }
                 default:
                     printHelpPage(exec_name);
                     return false;
@@ -254,6 +304,12 @@ private:
 #endif
         std::cerr << "    -i <N>, --index=<N>          -- Specify index of stratum to be executed\n";
         std::cerr << "                                    (or each in order if omitted)\n";
+        if (serving) {
+            std::cerr << "    -s <FILE>, --serve=<FILE>    -- Serve requests on the Unix domain socket\n";
+            std::cerr << "                                    <FILE> after evaluating the program\n";
+        }
+        std::cerr << "    -o <RELS>, --outputs=<RELS>  -- Compute only the given comma-separated\n";
+        std::cerr << "                                    output relations and their dependencies\n";
         std::cerr << "    -h                           -- prints this help page.\n";
         std::cerr << "--------------------------------------------------------------------\n";
         std::cerr << " Copyright (c) 2016 Oracle and/or its affiliates.\n";
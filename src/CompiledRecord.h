@@ -20,6 +20,7 @@
 #include "ParallelUtils.h"
 #include "Util.h"
 
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <unordered_map>
@@ -98,6 +99,9 @@ class RecordMap {
     /** a lock for the pack operation */
     Lock pack_lock;
 
+    /** The number of bytes occupied by this map */
+    std::atomic<std::size_t> bytes{0};
+
 public:
     RecordMap() = default;
 
@@ -127,8 +131,12 @@ public:
 
                 if (index / BLOCK_SIZE == i2r.size()) {
                     i2r.push_back(std::make_unique<block_type>());
+                    bytes += sizeof(block_type);
                 }
 
+                // account for the node of the hash map, holding the tuple, its index and a link
+                bytes += sizeof(tuple_type) + sizeof(RamDomain) + 2 * sizeof(void*);
+
                 // create entry for unpacking
                 auto& list = i2r[index / BLOCK_SIZE];
 
@@ -148,10 +156,18 @@ public:
         // just look up the right spot
         return (*(i2r[index / BLOCK_SIZE]))[index % BLOCK_SIZE];
     }
+
+    /**
+     * Obtains the number of bytes occupied by this map.
+     */
+    std::size_t getMemoryUsage() const {
+        return bytes;
+    }
 };
 
 /**
- * The static access function for record of a certain type.
+ * The static access function for record of a certain type, shared by the
+ * whole process.
  */
 template <typename Tuple>
 RecordMap<Tuple>& getRecordMap() {
@@ -160,6 +176,65 @@ RecordMap<Tuple>& getRecordMap() {
 }
 }  // namespace detail
 
+/**
+ * The records of a program instance, holding a record map for each of the
+ * given arities. Unlike the functions pack and unpack, which share their maps
+ * with the whole process, instances of programs evaluated concurrently keep
+ * their records apart.
+ */
+template <unsigned... Arities>
+class RecordTable;
+
+template <>
+class RecordTable<> {
+protected:
+    // anchor of the overloads obtaining the map of a tuple type
+    void getMap() const;
+
+public:
+    std::size_t getMemoryUsage() const {
+        return 0;
+    }
+};
+
+template <unsigned First, unsigned... Rest>
+class RecordTable<First, Rest...> : public RecordTable<Rest...> {
+    using tuple_type = ram::Tuple<RamDomain, First>;
+
+    detail::RecordMap<tuple_type> map;
+
+protected:
+    using RecordTable<Rest...>::getMap;
+
+    detail::RecordMap<tuple_type>& getMap(const tuple_type*) {
+        return map;
+    }
+
+public:
+    /**
+     * Packs the given tuple -- and may create a new reference if necessary.
+     */
+    template <typename Tuple>
+    RamDomain pack(const Tuple& tuple) {
+        return getMap(static_cast<const Tuple*>(nullptr)).pack(tuple);
+    }
+
+    /**
+     * Obtains the tuple addressed by the given reference.
+     */
+    template <typename Tuple>
+    const Tuple& unpack(RamDomain ref) {
+        return getMap(static_cast<const Tuple*>(nullptr)).unpack(ref);
+    }
+
+    /**
+     * Obtains the number of bytes occupied by the records of all arities.
+     */
+    std::size_t getMemoryUsage() const {
+        return map.getMemoryUsage() + RecordTable<Rest...>::getMemoryUsage();
+    }
+};
+
 template <typename Tuple>
 RamDomain pack(const Tuple& tuple) {
     return detail::getRecordMap<Tuple>().pack(tuple);
@@ -19,12 +19,18 @@
 
 #include "CompiledIndexUtils.h"
 #include "CompiledTuple.h"
+#include "MemoryUsage.h"
 #include "ParallelUtils.h"
 #include "RamTypes.h"
 #include "Table.h"
 #include "Util.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
@@ -80,6 +86,21 @@ struct Brie;
  */
 struct EqRel;
 
+/**
+ * A setup storing tuples column-wise, such that indices only hold their key columns.
+ */
+struct Columnar;
+
+/**
+ * A setup utilizing b-tree indices with compressed leaves for relations exclusively.
+ */
+struct Compressed;
+
+/**
+ * A setup utilizing b-tree indices spilling their tuples into memory-mapped files if short of memory.
+ */
+struct Spill;
+
 /**
  * A setup utilizing hash based data structures exclusively (STL unordered set and multiset).
  */
@@ -183,6 +204,68 @@ struct EqRel {
     using relation = detail::SingleIndexTypeRelation<eqrel_index_factory, arity, Indices...>;
 };
 
+// -------------------------------------------------------------
+//                  Columnar Setup Implementation
+// -------------------------------------------------------------
+
+namespace detail {
+
+/**
+ * A relation storing the columns of its tuples once, in a column-oriented
+ * store, while indices only hold the columns they are ordered by.
+ */
+template <unsigned arity, typename... Indices>
+class ColumnarRelation;
+}  // namespace detail
+
+/**
+ * A setup storing tuples column-wise, such that indices only hold their key columns.
+ */
+struct Columnar {
+    // determines the relation implementation for a given use case
+    template <unsigned arity, typename... Indices>
+    using relation = typename std::conditional<arity == 0, detail::AutoRelation<0>,
+            detail::ColumnarRelation<arity, Indices...>>::type;
+};
+
+// -------------------------------------------------------------
+//                  Compressed Setup Implementation
+// -------------------------------------------------------------
+
+/**
+ * A setup utilizing b-tree indices with compressed leaves for relations exclusively.
+ */
+struct Compressed {
+    // a index factory selecting in any case a compressed index
+    template <typename Tuple, typename Index, bool>
+    struct compressed_index_factory {
+        using type = typename index_utils::CompressedIndex<Tuple, Index>;
+    };
+
+    // determines the relation implementation for a given use case
+    template <unsigned arity, typename... Indices>
+    using relation = detail::SingleIndexTypeRelation<compressed_index_factory, arity, Indices...>;
+};
+
+// -------------------------------------------------------------
+//                  Spill Setup Implementation
+// -------------------------------------------------------------
+
+/**
+ * A setup utilizing b-tree indices spilling their tuples into memory-mapped files if short of memory.
+ */
+struct Spill {
+    // a index factory selecting in any case a spilling index
+    template <typename Tuple, typename Index, bool>
+    struct spill_index_factory {
+        using type = typename index_utils::SpillIndex<Tuple, Index>;
+    };
+
+    // determines the relation implementation for a given use case
+    template <unsigned arity, typename... Indices>
+    using relation = detail::SingleIndexTypeRelation<spill_index_factory, arity, Indices...>;
+};
+
 // -------------------------------------------------------------
 //                  Generic Setup Implementation
 // -------------------------------------------------------------
@@ -258,6 +341,46 @@ struct RelationBase {
         return static_cast<Derived*>(this)->insert(tuple, ctxt);
     }
 
+    // -- erase wrapper --
+
+    template <typename... Args>
+    bool erase(Args... args) {
+        RamDomain data[arity] = {RamDomain(args)...};
+        return static_cast<Derived*>(this)->erase(reinterpret_cast<const tuple_type&>(data));
+    }
+
+    bool erase(const tuple_type& tuple) {
+        typename Derived::operation_context ctxt;
+        return static_cast<Derived*>(this)->erase(tuple, ctxt);
+    }
+
+    /* Removes all tuples of the given relation from this relation. */
+    template <typename Other>
+    void eraseAll(const Other& other) {
+        if (static_cast<const void*>(&other) == static_cast<const void*>(this)) {
+            static_cast<Derived*>(this)->purge();
+            return;
+        }
+        typename Derived::operation_context ctxt;
+        for (const auto& cur : other) {
+            static_cast<Derived*>(this)->erase(cur, ctxt);
+        }
+    }
+
+    // -- filter wrapper --
+
+    /* Requests a Bloom filter for lookups on the given index; ignored if not supported. */
+    template <typename Index>
+    void enableFilter() {}
+
+    // -- deferred indices --
+
+    /* Restricts subsequent insertions to the primary index; ignored if not supported. */
+    void deferIndices() {}
+
+    /* Builds the indices skipped since deferIndices() was called from the primary index. */
+    void buildIndices() {}
+
     // -- IO --
 
     /* Provides a description of the internal organization of this relation. */
@@ -286,6 +409,47 @@ private:
     }
 };
 
+/**
+ * Fills the indices of the given collection other than the primary index with the
+ * referenced tuples. Each index is sorted and bulk-loaded by its own thread, rather
+ * than receiving the tuples through individual insertions.
+ */
+template <typename Indices, typename Primary, typename Tuple>
+void loadIndices(Indices& indices, const Primary& primary, const std::vector<const Tuple*>& tuples) {
+    std::vector<std::function<void()>> tasks;
+    indices.collectLoads(tuples, primary, tasks);
+    if (tasks.size() == 1) {
+        tasks[0]();
+        return;
+    }
+    PARALLEL_START
+    pfor(std::size_t i = 0; i < tasks.size(); i++) {
+        tasks[i]();
+    }
+    PARALLEL_END
+}
+
+/**
+ * Rebuilds the given relation from those of its tuples not satisfying the given predicate.
+ * This serves relations storing their tuples in append-only tables, which do not support
+ * the erasure of single tuples.
+ */
+template <typename Rel, typename Pred>
+void rebuildWithout(Rel& rel, const Pred& erased) {
+    std::vector<typename Rel::tuple_type> rest;
+    rest.reserve(rel.size());
+    for (const auto& cur : rel) {
+        if (!erased(cur)) {
+            rest.push_back(cur);
+        }
+    }
+    rel.purge();
+    typename Rel::operation_context ctxt;
+    for (const auto& cur : rest) {
+        rel.insert(cur, ctxt);
+    }
+}
+
 /**
  * The most generic implementation of a relation supporting arbitrary arities > 0 and
  * consistent lists of indices.
@@ -335,6 +499,9 @@ private:
     // the lock utilized to synchronize inserts
     Lock insert_lock;
 
+    // whether insertions are restricted to the primary index
+    bool deferred = false;
+
     /* A utility to check whether a certain index is covered by this relation. */
     template <typename Index>
     struct covered {
@@ -347,6 +514,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::erase;
     using base::insert;
 
     // --- most general implementation ---
@@ -389,7 +557,9 @@ public:
         }
 
         // insert into remaining indices (and primary again but the context will make it quick)
-        indices.insert(*masterCopy, context);
+        if (!deferred) {
+            indices.insert(*masterCopy, context);
+        }
 
         // new element has been added
         return true;
@@ -400,6 +570,20 @@ public:
         data.extend(other.data);
     }
 
+    /* Removes the given tuple. The table does not support erasures, thus this relation is rebuilt. */
+    bool erase(const tuple_type& tuple, operation_context& context) {
+        if (!contains(tuple, context)) return false;
+        rebuildWithout(*this, [&](const tuple_type& cur) { return cur == tuple; });
+        context = operation_context();
+        return true;
+    }
+
+    /* Removes all tuples of the given relation, rebuilding this relation once. */
+    template <typename Other>
+    void eraseAll(const Other& other) {
+        rebuildWithout(*this, [&](const tuple_type& cur) { return other.contains(cur); });
+    }
+
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, arity, Idxs...>& other) {
         operation_context context;
@@ -408,6 +592,25 @@ public:
         }
     }
 
+    /* Restricts subsequent insertions to the primary index, until buildIndices() is called. */
+    void deferIndices() {
+        deferred = true;
+    }
+
+    /* Builds the remaining indices from the stored tuples in bulk. */
+    void buildIndices() {
+        if (!deferred) {
+            return;
+        }
+        deferred = false;
+        std::vector<const tuple_type*> tuples;
+        tuples.reserve(size());
+        for (const tuple_type& cur : data) {
+            tuples.push_back(&cur);
+        }
+        loadIndices(indices, primary_index(), tuples);
+    }
+
     template <typename Index>
     auto scan() const -> decltype(indices.scan(Index())) {
         return indices.scan(Index());
@@ -428,6 +631,16 @@ public:
         return indices.template equalRange<Index>(value, context);
     }
 
+    // filters lookups on the given index, and existence checks if it is a full index
+    template <typename Index>
+    void enableFilter() {
+        static_assert(covered<Index>::value, "Addressing uncovered index!");
+        indices.template enableFilter<Index>();
+        if (int(Index::size) == int(arity)) {
+            index_utils::enable_filter(indices.getIndex(primary_index()), arity, 0);
+        }
+    }
+
     template <unsigned... Columns>
     range<typename indices_t::template iter_type<index<Columns...>>::type> equalRange(
             const tuple_type& value) const {
@@ -440,6 +653,15 @@ public:
         return equalRange<index<Columns...>>(value, ctxt);
     }
 
+    // -- lower/upper range wrapper --
+
+    template <typename Index, unsigned Column>
+    range<typename indices_t::template range_iter_type<Index, Column>::type> lowerUpperRange(
+            const tuple_type& low, const tuple_type& high, operation_context& context) const {
+        static_assert(covered<Index>::value, "Addressing uncovered index!");
+        return indices.template lowerUpperRange<Index, Column>(low, high, context);
+    }
+
     iterator begin() const {
         return data.begin();
     }
@@ -465,6 +687,11 @@ public:
         return out;
     }
 
+    /* Obtains the number of bytes occupied by this relation. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + data.getMemoryUsage() + indices.getMemoryUsage();
+    }
+
     /* Prints a summary of the hint statistic of this relation */
     void printHintStatistics(std::ostream& out, const std::string& prefix = "") const {
         indices.printHintStatistics(out, prefix);
@@ -508,6 +735,9 @@ private:
     // all other indices
     indices_t indices;
 
+    // whether insertions are restricted to the primary index
+    bool deferred = false;
+
 public:
     /* iterator type */
     using iterator = decltype(indices.getIndex(primary_index()).begin());
@@ -518,6 +748,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::erase;
     using base::insert;
 
     // --- most general implementation ---
@@ -542,7 +773,9 @@ public:
         // insert in primary index first ...
         if (indices.getIndex(primary_index()).insert(tuple, context.getForIndex(primary_index()))) {
             // and if new, to all other indices
-            indices.insert(tuple, context);
+            if (!deferred) {
+                indices.insert(tuple, context);
+            }
             // this was a new element
             return true;
         }
@@ -550,9 +783,26 @@ public:
         return false;
     }
 
+    bool erase(const tuple_type& tuple, operation_context& context) {
+        // erase from the primary index first ...
+        if (!index_utils::erase_tuple(indices.getIndex(primary_index()), tuple,
+                    context.getForIndex(primary_index()), 0)) {
+            return false;
+        }
+        // and if present, from all other indices
+        if (!deferred) {
+            indices.erase(tuple, context);
+        }
+        return true;
+    }
+
     void insertAll(const DirectIndexedRelation& other) {
         // merge indices using index-specific implementation
-        indices.insertAll(other.indices);
+        if (deferred) {
+            indices.getIndex(primary_index()).insertAll(other.indices.getIndex(primary_index()));
+        } else {
+            indices.insertAll(other.indices);
+        }
     }
 
     template <typename Setup, typename... Idxs>
@@ -563,6 +813,27 @@ public:
         }
     }
 
+    /* Restricts subsequent insertions to the primary index, until buildIndices() is called. */
+    void deferIndices() {
+        deferred = true;
+    }
+
+    /* Builds the remaining indices from the primary index in bulk. */
+    void buildIndices() {
+        if (!deferred) {
+            return;
+        }
+        deferred = false;
+        // the primary index may not provide stable references to its tuples
+        std::vector<tuple_type> copies(begin(), end());
+        std::vector<const tuple_type*> tuples;
+        tuples.reserve(copies.size());
+        for (const tuple_type& cur : copies) {
+            tuples.push_back(&cur);
+        }
+        loadIndices(indices, primary_index(), tuples);
+    }
+
     template <typename Index>
     auto scan() const -> decltype(indices.scan(Index())) {
         return indices.scan(Index());
@@ -580,6 +851,15 @@ public:
         return indices.template equalRange<Index>(value, context);
     }
 
+    // filters lookups on the given index, and existence checks if it is a full index
+    template <typename Index>
+    void enableFilter() {
+        indices.template enableFilter<Index>();
+        if (int(Index::size) == int(arity)) {
+            index_utils::enable_filter(indices.getIndex(primary_index()), arity, 0);
+        }
+    }
+
     template <unsigned... Columns>
     auto equalRange(const tuple_type& value) const
             -> decltype(this->template equalRange<index<Columns...>>(value)) {
@@ -592,6 +872,18 @@ public:
         return equalRange<index<Columns...>>(value, ctxt);
     }
 
+    template <typename Index, unsigned Column>
+    range<typename indices_t::template range_iter_type<Index, Column>::type> lowerUpperRange(
+            const tuple_type& low, const tuple_type& high, operation_context& context) const {
+        return indices.template lowerUpperRange<Index, Column>(low, high, context);
+    }
+
+    // obtains the trie maintained by the given full trie index
+    template <typename Index>
+    auto getTrie() const -> decltype(indices.getIndex(Index()).getTrie()) {
+        return indices.getIndex(Index()).getTrie();
+    }
+
     auto begin() const -> decltype(indices.getIndex(primary_index()).begin()) {
         return indices.getIndex(primary_index()).begin();
     }
@@ -616,6 +908,11 @@ public:
         return out;
     }
 
+    /* Obtains the number of bytes occupied by this relation. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + indices.getMemoryUsage();
+    }
+
     /* Prints a summary of the hint statistic of this relation */
     void printHintStatistics(std::ostream& out, const std::string& prefix = "") const {
         indices.printHintStatistics(out, prefix);
@@ -754,6 +1051,12 @@ public:
         return res;
     }
 
+    bool erase(const tuple_type& = tuple_type(), const operation_context& = operation_context()) {
+        bool res = present;
+        present = false;
+        return res;
+    }
+
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, 0, Idxs...>& other) {
         present = present || other.present;
@@ -808,6 +1111,11 @@ public:
         return out << "Nullary Relation";
     }
 
+    /* Obtains the number of bytes occupied by this relation. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this);
+    }
+
     /* Prints a summary of the hint statistic of this relation */
     void printHintStatistics(std::ostream& out, const std::string& prefix = "") const {
         out << prefix << " -- no hints used in nullary relation --\n";
@@ -843,6 +1151,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::erase;
     using base::insert;
 
     using operation_context = typename table_t::operation_hints;
@@ -873,6 +1182,10 @@ public:
         return data.insert(tuple, ctxt);
     }
 
+    bool erase(const tuple_type& tuple, operation_context& ctxt) {
+        return index_utils::erase_tuple(data, tuple, ctxt, 0);
+    }
+
     void insertAll(const SingleIndexRelation& other) {
         data.insertAll(other.data);
     }
@@ -912,6 +1225,23 @@ private:
                 iterator_utils::filter_iterator<iterator, I>(end(), end(), value));
     }
 
+    template <typename I, unsigned Column>
+    typename std::enable_if<index_utils::is_compatible_with<I, Index>::value &&
+                                    index_utils::is_range_compatible_with<I, Column, primary_index_t>::value,
+            range<iterator>>::type
+    lowerUpperRangeInternal(const tuple_type& low, const tuple_type& high, operation_context& ctxt) const {
+        return data.template lowerUpperRange<I, Column>(low, high, ctxt);
+    }
+
+    template <typename I, unsigned Column>
+    auto lowerUpperRangeInternal(const tuple_type& low, const tuple_type&, operation_context& ctxt) const ->
+            typename std::enable_if<!(index_utils::is_compatible_with<I, Index>::value &&
+                                            index_utils::is_range_compatible_with<I, Column,
+                                                    primary_index_t>::value),
+                    decltype(this->equalRangeInternal<I>(low, ctxt))>::type {
+        return equalRangeInternal<I>(low, ctxt);
+    }
+
 public:
     template <typename I>
     auto equalRange(const tuple_type& value, operation_context& ctxt) const
@@ -938,6 +1268,27 @@ public:
         return equalRange<index<Columns...>>(value, ctxt);
     }
 
+    template <typename I, unsigned Column>
+    auto lowerUpperRange(const tuple_type& low, const tuple_type& high, operation_context& ctxt) const
+            -> decltype(this->lowerUpperRangeInternal<I, Column>(low, high, ctxt)) {
+        return lowerUpperRangeInternal<I, Column>(low, high, ctxt);
+    }
+
+    // filters lookups on the given index; scans of uncovered indices are not filtered
+    template <typename I>
+    void enableFilter() {
+        if (index_utils::is_compatible_with<I, Index>::value) {
+            index_utils::enable_filter(data, I::size, 0);
+        }
+    }
+
+    // obtains the trie maintained by the given full trie index
+    template <typename I, typename T = table_t>
+    auto getTrie() const -> decltype(std::declval<const T&>().getTrie()) {
+        static_assert(std::is_same<I, primary_index_t>::value, "Trie of non-maintained index requested!");
+        return data.getTrie();
+    }
+
     iterator begin() const {
         return data.begin();
     }
@@ -961,6 +1312,11 @@ public:
         return out;
     }
 
+    /* Obtains the number of bytes occupied by this relation. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + data.getMemoryUsage();
+    }
+
     /* Prints a summary of the hint statistic of this relation */
     void printHintStatistics(std::ostream& out, const std::string& prefix = "") const {
         data.printHintStatistics(out, prefix);
@@ -1036,10 +1392,18 @@ public:
         // nothing to do here
     }
 
+    void erase(const tuple_type&) {
+        // nothing to do here
+    }
+
     void clear() {
         // nothing to do here
     }
 
+    std::size_t getMemoryUsage() const {
+        return 0;
+    }
+
     range<tuple_type*> equal_range(const tuple_type&) const {
         assert(false && "Missing index!");
         return {nullptr, nullptr};
@@ -1142,11 +1506,27 @@ public:
         nested.insert(element);
     }
 
+    void erase(const tuple_type& element) {
+        // partial indices may store other tuples of the same key
+        auto range = data.equal_range(element);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (*it == element) {
+                data.erase(it);
+                break;
+            }
+        }
+        nested.erase(element);
+    }
+
     void clear() {
         data.clear();
         nested.clear();
     }
 
+    std::size_t getMemoryUsage() const {
+        return config::getMemoryUsage(data) + nested.getMemoryUsage();
+    }
+
     iterator begin() const {
         return data.begin();
     }
@@ -1190,6 +1570,7 @@ public:
 
     // import generic signatures from the base class
     using base::contains;
+    using base::erase;
     using base::insert;
 
     // the empty operation context (no data needed)
@@ -1220,6 +1601,13 @@ public:
         return true;
     }
 
+    bool erase(const tuple_type& tuple, operation_context&) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!contains(tuple)) return false;
+        indices.erase(tuple);
+        return true;
+    }
+
     template <typename Setup, typename... Idxs>
     void insertAll(const Relation<Setup, arity, Idxs...>& other) {
         for (const tuple_type& cur : other) {
@@ -1256,6 +1644,19 @@ public:
         return indices.template equal_range<index<Columns...>>(value);
     }
 
+    // hash-based indices do not support range queries => an unrestricted range query is a scan
+    template <typename I, unsigned Column>
+    typename std::enable_if<I::size == 0, range<iterator>>::type lowerUpperRange(
+            const tuple_type&, const tuple_type&, operation_context&) const {
+        return scan<I>();
+    }
+
+    template <typename I, unsigned Column>
+    auto lowerUpperRange(const tuple_type& low, const tuple_type&, operation_context&) const ->
+            typename std::enable_if<I::size != 0, decltype(indices.template equal_range<I>(low))>::type {
+        return indices.template equal_range<I>(low);
+    }
+
     iterator begin() const {
         return getMainIndex().begin();
     }
@@ -1296,6 +1697,11 @@ public:
         return out;
     }
 
+    /* Obtains the number of bytes occupied by this relation. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + indices.getMemoryUsage();
+    }
+
 private:
     main_index_type& getMainIndex() {
         return indices.template get<full_index>();
@@ -1344,6 +1750,11 @@ struct std_set_config {
     const char* getName() {
         return "std::set";
     }
+
+    template <typename Set>
+    static std::size_t getMemoryUsage(const Set& set) {
+        return getTreeMemoryUsage(set);
+    }
 };
 
 // ------------------------------------------------------------------------------------------
@@ -1404,9 +1815,573 @@ struct std_unordered_config {
     const char* getName() {
         return "std::unordered_set";
     }
+
+    template <typename Set>
+    static std::size_t getMemoryUsage(const Set& set) {
+        return getHashMemoryUsage(set);
+    }
+};
+
+// ------------------------------------------------------------------------------------------
+//                                     ColumnarRelation
+// ------------------------------------------------------------------------------------------
+
+/**
+ * A store keeping tuples column-wise. Tuples are appended to blocks holding
+ * the values of each column contiguously. Each column of a block is encoded
+ * using the narrowest of 8, 16, 32 or 64 bits per value sufficient for the
+ * values stored in it, and is re-encoded using a wider format once a value
+ * exceeding its range is appended. Columns holding small numbers, symbols of
+ * a small symbol table or flags thus occupy a fraction of the space of their
+ * RamDomain representation, which they are widened to when being read.
+ *
+ * A tuple is identified by its position within the store, which remains
+ * valid until the store is cleared.
+ *
+ * @tparam Tuple .. the type of tuple stored
+ */
+template <typename Tuple>
+class ColumnStore {
+public:
+    // the number of tuples per block
+    enum { BLOCK_SIZE = 1024 };
+
+    // the arity of the stored tuples
+    enum { arity = Tuple::arity };
+
+private:
+    /* The values of a column within a block, encoded using width bytes each. */
+    struct Column {
+        std::unique_ptr<char[]> data;
+        unsigned width = 0;
+    };
+
+    /* A block of tuples, stored column by column. */
+    struct Block {
+        Column columns[arity];
+    };
+
+    // the blocks holding the columns of the stored tuples
+    std::vector<std::unique_ptr<Block>> blocks;
+
+    // the number of stored tuples
+    std::size_t numTuples = 0;
+
+    // the number of bytes occupied by the encoded columns
+    std::size_t columnBytes = 0;
+
+    /* Determines whether the given value is within the range of type T. */
+    template <typename T>
+    static bool fits(RamDomain value) {
+        return std::numeric_limits<T>::min() <= value && value <= std::numeric_limits<T>::max();
+    }
+
+    /* Obtains the number of bytes required to encode the given value. */
+    static unsigned getWidth(RamDomain value) {
+        if (fits<std::int8_t>(value)) return 1;
+        if (fits<std::int16_t>(value)) return 2;
+        if (fits<std::int32_t>(value)) return 4;
+        return sizeof(RamDomain);
+    }
+
+    /* Decodes the i-th value of the given column. */
+    static RamDomain read(const Column& column, std::size_t i) {
+        switch (column.width) {
+            case 1:
+                return reinterpret_cast<const std::int8_t*>(column.data.get())[i];
+            case 2:
+                return reinterpret_cast<const std::int16_t*>(column.data.get())[i];
+            case 4:
+                return reinterpret_cast<const std::int32_t*>(column.data.get())[i];
+            default:
+                return reinterpret_cast<const RamDomain*>(column.data.get())[i];
+        }
+    }
+
+    /* Encodes the i-th value of the given column, which has to be wide enough. */
+    static void write(Column& column, std::size_t i, RamDomain value) {
+        switch (column.width) {
+            case 1:
+                reinterpret_cast<std::int8_t*>(column.data.get())[i] = value;
+                break;
+            case 2:
+                reinterpret_cast<std::int16_t*>(column.data.get())[i] = value;
+                break;
+            case 4:
+                reinterpret_cast<std::int32_t*>(column.data.get())[i] = value;
+                break;
+            default:
+                reinterpret_cast<RamDomain*>(column.data.get())[i] = value;
+        }
+    }
+
+    /* Re-encodes the first count values of the given column using width bytes each. */
+    void widen(Column& column, unsigned width, std::size_t count) {
+        Column res;
+        res.data.reset(new char[width * BLOCK_SIZE]);
+        res.width = width;
+        for (std::size_t i = 0; i < count; i++) {
+            write(res, i, read(column, i));
+        }
+        columnBytes += (width - column.width) * BLOCK_SIZE;
+        column = std::move(res);
+    }
+
+public:
+    /**
+     * An iterator over stored tuples, given an iterator over their positions.
+     * Tuples are assembled from their columns when first dereferenced.
+     */
+    template <typename Iter>
+    class iterator : public std::iterator<std::forward_iterator_tag, Tuple> {
+        const ColumnStore* store = nullptr;
+        Iter cur;
+        mutable Tuple value;
+        mutable bool loaded = false;
+
+    public:
+        iterator() = default;
+
+        iterator(const ColumnStore* store, const Iter& cur) : store(store), cur(cur) {}
+
+        const Tuple& operator*() const {
+            if (!loaded) {
+                store->load(*cur, value);
+                loaded = true;
+            }
+            return value;
+        }
+
+        const Tuple* operator->() const {
+            return &**this;
+        }
+
+        iterator& operator++() {
+            ++cur;
+            loaded = false;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return cur != other.cur;
+        }
+    };
+
+    /* An iterator over the positions of the stored tuples, in the order of their insertion. */
+    class position_iterator : public std::iterator<std::forward_iterator_tag, std::size_t> {
+        std::size_t pos = 0;
+
+    public:
+        position_iterator() = default;
+
+        position_iterator(std::size_t pos) : pos(pos) {}
+
+        std::size_t operator*() const {
+            return pos;
+        }
+
+        position_iterator& operator++() {
+            ++pos;
+            return *this;
+        }
+
+        bool operator==(const position_iterator& other) const {
+            return pos == other.pos;
+        }
+
+        bool operator!=(const position_iterator& other) const {
+            return pos != other.pos;
+        }
+    };
+
+    /*
+     * A reference to a tuple, being either the position of a stored tuple or, for
+     * lookups, the address of a row-wise tuple. The lowest bit, which is clear for
+     * any address of a value, marks stored tuples.
+     */
+    struct reference {
+        std::uintptr_t value;
+
+        static reference stored(std::size_t pos) {
+            return reference{(static_cast<std::uintptr_t>(pos) << 1) | 1};
+        }
+
+        static reference lookup(const Tuple& tuple) {
+            return reference{reinterpret_cast<std::uintptr_t>(&tuple[0])};
+        }
+    };
+
+    /* Lexicographical order on referenced tuples, decoding stored tuples from the given store. */
+    class comparator {
+        const ColumnStore* store;
+
+        RamDomain get(const reference& ref, unsigned column) const {
+            if (ref.value & 1) {
+                return store->get(ref.value >> 1, column);
+            }
+            return reinterpret_cast<const RamDomain*>(ref.value)[column];
+        }
+
+    public:
+        comparator(const ColumnStore* store = nullptr) : store(store) {}
+
+        int operator()(const reference& a, const reference& b) const {
+            for (unsigned i = 0; i < arity; i++) {
+                RamDomain x = get(a, i);
+                RamDomain y = get(b, i);
+                if (x < y) return -1;
+                if (x > y) return 1;
+            }
+            return 0;
+        }
+        bool less(const reference& a, const reference& b) const {
+            return operator()(a, b) < 0;
+        }
+        bool equal(const reference& a, const reference& b) const {
+            return operator()(a, b) == 0;
+        }
+    };
+
+    ColumnStore() = default;
+
+    ColumnStore(const ColumnStore&) = delete;
+
+    ColumnStore& operator=(const ColumnStore&) = delete;
+
+    bool empty() const {
+        return numTuples == 0;
+    }
+
+    std::size_t size() const {
+        return numTuples;
+    }
+
+    /* Adds the given tuple, returning its position. Not thread-safe. */
+    std::size_t append(const Tuple& tuple) {
+        std::size_t offset = numTuples % BLOCK_SIZE;
+        if (offset == 0) {
+            blocks.push_back(std::make_unique<Block>());
+        }
+        Block& block = *blocks.back();
+        for (unsigned i = 0; i < arity; i++) {
+            Column& column = block.columns[i];
+            unsigned width = getWidth(tuple[i]);
+            if (width > column.width) {
+                widen(column, width, offset);
+            }
+            write(column, offset, tuple[i]);
+        }
+        return numTuples++;
+    }
+
+    /* Obtains the given column of the tuple stored at the given position. */
+    RamDomain get(std::size_t pos, unsigned column) const {
+        return read(blocks[pos / BLOCK_SIZE]->columns[column], pos % BLOCK_SIZE);
+    }
+
+    /* Assembles the tuple stored at the given position. */
+    void load(std::size_t pos, Tuple& tuple) const {
+        const Block& block = *blocks[pos / BLOCK_SIZE];
+        for (unsigned i = 0; i < arity; i++) {
+            tuple[i] = read(block.columns[i], pos % BLOCK_SIZE);
+        }
+    }
+
+    position_iterator begin() const {
+        return position_iterator(0);
+    }
+
+    position_iterator end() const {
+        return position_iterator(numTuples);
+    }
+
+    /* Splits the stored tuples into ranges of whole blocks, for parallel processing. */
+    std::vector<range<position_iterator>> partition(std::size_t np) const {
+        std::vector<range<position_iterator>> res;
+        std::size_t step = std::max<std::size_t>(1, (blocks.size() + np - 1) / np) * BLOCK_SIZE;
+        for (std::size_t i = 0; i < numTuples; i += step) {
+            res.push_back(make_range(
+                    position_iterator(i), position_iterator(std::min<std::size_t>(i + step, numTuples))));
+        }
+        return res;
+    }
+
+    void clear() {
+        blocks.clear();
+        numTuples = 0;
+        columnBytes = 0;
+    }
+
+    /* Obtains the number of bytes occupied by the stored columns. */
+    std::size_t getMemoryUsage() const {
+        return columnBytes;
+    }
+};
+
+/**
+ * A relation storing its tuples column-wise within a ColumnStore. Indices only
+ * hold the columns they are ordered by, along with the position of the tuple,
+ * and existence checks are served by a b-tree over tuple positions comparing
+ * the stored columns. Columns never looked up are thus stored once instead of
+ * once per index, at the price of assembling tuples from their columns when
+ * they are enumerated.
+ *
+ * @tparam arity .. the arity of the resulting relation
+ * @tparam Indices .. the indices to be maintained on top
+ */
+template <unsigned arity, typename... Indices>
+class ColumnarRelation : public RelationBase<arity, ColumnarRelation<arity, Indices...>> {
+    // shortcut for the base class
+    using base = RelationBase<arity, ColumnarRelation<arity, Indices...>>;
+
+public:
+    /* The type of tuple stored in this relation. */
+    using tuple_type = typename base::tuple_type;
+
+private:
+    using store_t = ColumnStore<tuple_type>;
+
+    using row_type = index_utils::columnar_row<tuple_type>;
+
+    // obtain type of index collection
+    using indices_t = index_utils::Indices<row_type, index_utils::columnar_index_factory, Indices...>;
+
+    // the set of stored tuples, utilized for existence checks
+    using primary_t = btree_set<typename store_t::reference, typename store_t::comparator>;
+
+    // the columns of the stored tuples
+    store_t store;
+
+    // the positions of all stored tuples
+    primary_t primary{typename store_t::comparator(&store)};
+
+    // all indices
+    indices_t indices;
+
+    // the lock utilized to synchronize inserts
+    Lock insert_lock;
+
+    /* A utility to check whether a certain index is covered by this relation. */
+    template <typename Index>
+    struct covered {
+        enum { value = indices_t::template is_covered<Index>::value };
+    };
+
+    /* The iterator type of queries on the given index. */
+    template <typename Index>
+    using iter_type =
+            typename store_t::template iterator<typename indices_t::template iter_type<Index>::type>;
+
+    /* The iterator type of range queries on the given index. */
+    template <typename Index, unsigned Column>
+    using range_iter_type = typename store_t::template iterator<
+            typename indices_t::template range_iter_type<Index, Column>::type>;
+
+    /* Converts a range of tuple positions to a range of tuples. */
+    template <typename Iter>
+    range<typename store_t::template iterator<Iter>> toTuples(const range<Iter>& r) const {
+        using iter = typename store_t::template iterator<Iter>;
+        return make_range(iter(&store, r.begin()), iter(&store, r.end()));
+    }
+
+public:
+    /* The iterator type to be utilized for relation scans. */
+    using iterator = typename store_t::template iterator<typename store_t::position_iterator>;
+
+    /* The context information to be utilized by operations on this relation. */
+    struct operation_context {
+        typename primary_t::operation_hints primary;
+        typename indices_t::operation_context indices;
+    };
+
+    // import generic signatures from the base class
+    using base::contains;
+    using base::erase;
+    using base::insert;
+
+    ColumnarRelation() = default;
+
+    ColumnarRelation(const ColumnarRelation&) = delete;
+
+    // --- most general implementation ---
+
+    operation_context createContext() {
+        return operation_context();
+    }
+
+    bool empty() const {
+        return store.empty();
+    }
+
+    std::size_t size() const {
+        return store.size();
+    }
+
+    bool contains(const tuple_type& tuple, operation_context& context) const {
+        return primary.contains(store_t::reference::lookup(tuple), context.primary);
+    }
+
+    bool insert(const tuple_type& tuple, operation_context& context) {
+        std::size_t row;
+        {
+            // acquire exclusive access to the store
+            auto lease = insert_lock.acquire();
+
+            // if already present => skip
+            if (contains(tuple, context)) return false;
+
+            // add the columns to the store and the tuple to the primary index
+            row = store.append(tuple);
+            primary.insert(store_t::reference::stored(row), context.primary);
+        }
+
+        // insert into the remaining indices
+        indices.insert(row_type{tuple, row}, context.indices);
+        return true;
+    }
+
+    /* Removes the given tuple. The store does not support erasures, thus this relation is rebuilt. */
+    bool erase(const tuple_type& tuple, operation_context& context) {
+        if (!contains(tuple, context)) return false;
+        rebuildWithout(*this, [&](const tuple_type& cur) { return cur == tuple; });
+        context = operation_context();
+        return true;
+    }
+
+    /* Removes all tuples of the given relation, rebuilding this relation once. */
+    template <typename Other>
+    void eraseAll(const Other& other) {
+        rebuildWithout(*this, [&](const tuple_type& cur) { return other.contains(cur); });
+    }
+
+    template <typename Setup, typename... Idxs>
+    void insertAll(const Relation<Setup, arity, Idxs...>& other) {
+        operation_context context;
+        for (const tuple_type& cur : other) {
+            insert(cur, context);
+        }
+    }
+
+    // -- equal range wrapper --
+
+    template <typename Index>
+    range<iter_type<Index>> equalRange(const tuple_type& value) const {
+        operation_context ctxt;
+        return equalRange<Index>(value, ctxt);
+    }
+
+    template <typename Index>
+    range<iter_type<Index>> equalRange(const tuple_type& value, operation_context& context) const {
+        static_assert(covered<Index>::value, "Addressing uncovered index!");
+        return toTuples(indices.template equalRange<Index>(row_type{value, 0}, context.indices));
+    }
+
+    template <unsigned... Columns>
+    range<iter_type<index<Columns...>>> equalRange(const tuple_type& value) const {
+        return equalRange<index<Columns...>>(value);
+    }
+
+    template <unsigned... Columns, typename Context>
+    range<iter_type<index<Columns...>>> equalRange(const tuple_type& value, Context& ctxt) const {
+        return equalRange<index<Columns...>>(value, ctxt);
+    }
+
+    // -- lower/upper range wrapper --
+
+    template <typename Index, unsigned Column>
+    range<range_iter_type<Index, Column>> lowerUpperRange(
+            const tuple_type& low, const tuple_type& high, operation_context& context) const {
+        static_assert(covered<Index>::value, "Addressing uncovered index!");
+        return toTuples(indices.template lowerUpperRange<Index, Column>(
+                row_type{low, 0}, row_type{high, 0}, context.indices));
+    }
+
+    iterator begin() const {
+        return iterator(&store, store.begin());
+    }
+
+    iterator end() const {
+        return iterator(&store, store.end());
+    }
+
+    void purge() {
+        primary.clear();
+        indices.clear();
+        store.clear();
+    }
+
+    std::vector<range<iterator>> partition() const {
+        std::vector<range<iterator>> res;
+        for (const auto& cur : store.partition(400)) {
+            res.push_back(toTuples(cur));
+        }
+        return res;
+    }
+
+    /* Prints a description of the internal structure of this relation. */
+    std::ostream& printDescription(std::ostream& out = std::cout) const {
+        out << "ColumnarRelation of arity=" << arity << " with indices [ ";
+        indices.printDescription(out);
+        out << " ]";
+        return out;
+    }
+
+    /* Obtains the number of bytes occupied by this relation. */
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + store.getMemoryUsage() + primary.getMemoryUsage() + indices.getMemoryUsage();
+    }
+
+    /* Prints a summary of the hint statistic of this relation */
+    void printHintStatistics(std::ostream& out, const std::string& prefix = "") const {
+        indices.printHintStatistics(out, prefix);
+    }
 };
 
 }  // end of namespace detail
 
+// ------------------------------------------------------------------------------------------
+//                                  Hash Join Table
+// ------------------------------------------------------------------------------------------
+
+/**
+ * A transient hash table over the tuples of a relation, keyed by the columns
+ * of the given index. It is built once on the smaller input of a hash join
+ * and probed by the tuples of the larger one.
+ *
+ * @tparam arity .. the arity of the hashed relation
+ * @tparam Index .. the join columns of the hashed relation
+ */
+template <unsigned arity, typename Index>
+class HashJoinTable {
+    using tuple_type = Tuple<RamDomain, arity>;
+
+    using table_type =
+            std::unordered_multiset<tuple_type, detail::tuple_hasher<Index>, detail::tuple_equal<Index>>;
+
+    table_type data;
+
+public:
+    using iterator = typename table_type::const_iterator;
+
+    /* Adds all tuples of the given relation to this table. */
+    template <typename Relation>
+    void insertAll(const Relation& rel) {
+        data.reserve(data.size() + rel.size());
+        for (const auto& cur : rel) {
+            data.insert(cur);
+        }
+    }
+
+    /* Obtains all tuples agreeing with the given key on the join columns. */
+    range<iterator> equalRange(const tuple_type& key) const {
+        auto res = data.equal_range(key);
+        return make_range(res.first, res.second);
+    }
+};
+
 }  // end of namespace ram
 }  // end of namespace souffle
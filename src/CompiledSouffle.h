@@ -25,6 +25,7 @@
 #include "souffle/IODirectives.h"
 #include "souffle/IOSystem.h"
 #include "souffle/Logger.h"
+#include "souffle/MemoryPlacement.h"
 #include "souffle/ParallelUtils.h"
 #include "souffle/ProfileEvent.h"
 #include "souffle/RamTypes.h"
@@ -46,6 +47,7 @@
 #include <memory>
 #include <regex>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -61,6 +63,118 @@ inline souffle::SouffleProgram* getInstance(const char* p) {
 }
 }
 
+namespace detail {
+
+// a list of indices of a relation
+template <typename... Indices>
+struct index_list {};
+
+template <typename... Lists>
+struct join_index_lists {
+    using type = index_list<>;
+};
+
+template <typename... A>
+struct join_index_lists<index_list<A...>> {
+    using type = index_list<A...>;
+};
+
+template <typename... A, typename... B, typename... Rest>
+struct join_index_lists<index_list<A...>, index_list<B...>, Rest...> {
+    using type = typename join_index_lists<index_list<A..., B...>, Rest...>::type;
+};
+
+// determines whether a relation supports looking up tuples by the given index
+template <typename RelType, typename Index, typename = void>
+struct supports_lookup : std::false_type {};
+
+template <typename RelType, typename Index>
+using lookup_result = decltype(std::declval<const RelType&>().template equalRange<Index>(
+        std::declval<const typename RelType::tuple_type&>()));
+
+template <typename RelType, typename Index>
+struct supports_lookup<RelType, Index,
+        typename std::enable_if<!std::is_void<lookup_result<RelType, Index>>::value>::type>
+        : std::true_type {};
+
+// the non-empty prefixes of an index up to the given length supported by a relation, the shortest first
+template <typename RelType, typename Index, unsigned Length = Index::size>
+struct index_prefixes {
+    using prefix = typename ram::index_utils::get_prefix<Length, Index>::type;
+    using type = typename join_index_lists<typename index_prefixes<RelType, Index, Length - 1>::type,
+            typename std::conditional<supports_lookup<RelType, prefix>::value, index_list<prefix>,
+                    index_list<>>::type>::type;
+};
+
+template <typename RelType, typename Index>
+struct index_prefixes<RelType, Index, 0> {
+    using type = index_list<>;
+};
+
+// the prefixes of all indices of a relation, by which its tuples may be looked up
+template <typename RelType>
+struct lookup_indices {
+    using type = index_list<>;
+};
+
+template <typename Setup, unsigned arity, typename... Indices>
+struct lookup_indices<ram::Relation<Setup, arity, Indices...>> {
+    using type = typename join_index_lists<
+            typename index_prefixes<ram::Relation<Setup, arity, Indices...>, Indices>::type...>::type;
+};
+
+// the set of columns covered by an index
+template <typename Index>
+struct column_mask;
+
+template <>
+struct column_mask<ram::index<>> {
+    static constexpr SearchColumns value = 0;
+};
+
+template <unsigned First, unsigned... Rest>
+struct column_mask<ram::index<First, Rest...>> {
+    static constexpr SearchColumns value =
+            (SearchColumns(1) << First) | column_mask<ram::index<Rest...>>::value;
+};
+
+// selects, among a list of indices, the longest one covering only bound columns
+template <typename List>
+struct lookup_index_search;
+
+template <>
+struct lookup_index_search<index_list<>> {
+    static void find(SearchColumns, int, int&, int&) {}
+
+    template <typename Wrapper>
+    static Relation::iterator_range apply(
+            const Wrapper& wrapper, int, const typename Wrapper::tuple_type& key, SearchColumns columns) {
+        return wrapper.scanRange(key, columns);
+    }
+};
+
+template <typename First, typename... Rest>
+struct lookup_index_search<index_list<First, Rest...>> {
+    static void find(SearchColumns columns, int pos, int& best, int& bestSize) {
+        if ((column_mask<First>::value & ~columns) == 0 && int(First::size) > bestSize) {
+            best = pos;
+            bestSize = First::size;
+        }
+        lookup_index_search<index_list<Rest...>>::find(columns, pos + 1, best, bestSize);
+    }
+
+    template <typename Wrapper>
+    static Relation::iterator_range apply(
+            const Wrapper& wrapper, int pos, const typename Wrapper::tuple_type& key, SearchColumns columns) {
+        if (pos == 0) {
+            return wrapper.template indexedRange<First>(key, columns & ~column_mask<First>::value);
+        }
+        return lookup_index_search<index_list<Rest...>>::apply(wrapper, pos - 1, key, columns);
+    }
+};
+
+}  // namespace detail
+
 /**
  * Relation wrapper used internally in the generated Datalog program
  */
@@ -102,7 +216,84 @@ private:
         }
     };
 
+    // iterates over the tuples of a range agreeing with a key on the given columns
+    template <typename Iter>
+    class range_wrapper : public iterator_base {
+        Iter it;
+        Iter last;
+        TupleType key;
+        SearchColumns columns;
+        tuple t;
+
+        // skips the tuples disagreeing with the key
+        void skip() {
+            for (; columns != 0 && !(it == last); ++it) {
+                const auto& cur = *it;
+                size_t i = 0;
+                while (i < Arity && (((columns >> i) & 1) == 0 || cur[i] == key[i])) {
+                    i++;
+                }
+                if (i == Arity) {
+                    return;
+                }
+            }
+        }
+
+    public:
+        range_wrapper(uint32_t arg_id, const Relation* rel, const Iter& first, const Iter& last,
+                const TupleType& key, SearchColumns columns)
+                : iterator_base(arg_id), it(first), last(last), key(key), columns(columns), t(rel) {
+            skip();
+        }
+        void operator++() override {
+            ++it;
+            skip();
+        }
+        tuple& operator*() override {
+            t.rewind();
+            for (size_t i = 0; i < Arity; i++) {
+                t[i] = (*it)[i];
+            }
+            return t;
+        }
+        iterator_base* clone() const override {
+            return new range_wrapper(*this);
+        }
+
+    protected:
+        bool equal(const iterator_base& o) const override {
+            const auto* casted = dynamic_cast<const range_wrapper*>(&o);
+            return casted != nullptr && it == casted->it;
+        }
+    };
+
+    // the prefixes of indices by which tuples may be looked up
+    using lookup_indices = typename detail::lookup_indices<RelType>::type;
+
+    template <typename List>
+    friend struct detail::lookup_index_search;
+
+    // looks up the tuples agreeing with the key on the given index, filtering the remaining columns
+    template <typename Index>
+    iterator_range indexedRange(const TupleType& key, SearchColumns columns) const {
+        auto res = relation.template equalRange<Index>(key);
+        using Iter = typename std::decay<decltype(res.begin())>::type;
+        return iterator_range(
+                iterator(new range_wrapper<Iter>(id, this, res.begin(), res.end(), key, columns)),
+                iterator(new range_wrapper<Iter>(id, this, res.end(), res.end(), key, columns)));
+    }
+
+    // scans all tuples for those agreeing with the key on the given columns
+    iterator_range scanRange(const TupleType& key, SearchColumns columns) const {
+        using Iter = typename RelType::iterator;
+        return iterator_range(
+                iterator(new range_wrapper<Iter>(id, this, relation.begin(), relation.end(), key, columns)),
+                iterator(new range_wrapper<Iter>(id, this, relation.end(), relation.end(), key, columns)));
+    }
+
 public:
+    using tuple_type = TupleType;
+
     RelationWrapper(RelType& r, SymbolTable& s, std::string name, const std::array<const char*, Arity>& t,
             const std::array<const char*, Arity>& n)
             : relation(r), symTable(s), name(std::move(name)), tupleType(t), tupleName(n) {}
@@ -128,6 +319,69 @@ public:
         }
         return relation.contains(t);
     }
+    bool erase(const tuple& arg) override {
+        TupleType t;
+        assert(arg.size() == Arity && "wrong tuple arity");
+        for (size_t i = 0; i < Arity; i++) {
+            t[i] = arg[i];
+        }
+        return relation.erase(t);
+    }
+    void purge() override {
+        relation.purge();
+    }
+    void insertAll(const RamDomain* rows, size_t count) override {
+        // batches outweighing the relation obtain its secondary indices in bulk
+        bool bulk = count >= relation.size();
+        if (bulk) {
+            relation.deferIndices();
+        }
+        auto ctxt = relation.createContext();
+        TupleType t;
+        for (size_t i = 0; i < count; i++, rows += Arity) {
+            for (size_t j = 0; j < Arity; j++) {
+                t[j] = rows[j];
+            }
+            relation.insert(t, ctxt);
+        }
+        if (bulk) {
+            relation.buildIndices();
+        }
+    }
+    size_t exportAll(RamDomain* rows, size_t capacity) const override {
+        size_t n = 0;
+        for (auto it = relation.begin(); n < capacity && it != relation.end(); ++it, ++n) {
+            const auto& cur = *it;
+            for (size_t j = 0; j < Arity; j++) {
+                rows[n * Arity + j] = cur[j];
+            }
+        }
+        return n;
+    }
+    size_t exportColumns(RamDomain* const* columns, size_t capacity) const override {
+        size_t n = 0;
+        for (auto it = relation.begin(); n < capacity && it != relation.end(); ++it, ++n) {
+            const auto& cur = *it;
+            for (size_t j = 0; j < Arity; j++) {
+                columns[j][n] = cur[j];
+            }
+        }
+        return n;
+    }
+    iterator_range equalRange(const tuple& pattern, SearchColumns columns) const override {
+        TupleType key;
+        assert(pattern.size() == Arity && "wrong tuple arity");
+        for (size_t i = 0; i < Arity; i++) {
+            key[i] = pattern[i];
+        }
+        int best = -1;
+        int bestSize = 0;
+        detail::lookup_index_search<lookup_indices>::find(columns, 0, best, bestSize);
+        if (best < 0) {
+            return scanRange(key, columns);
+        }
+        return detail::lookup_index_search<lookup_indices>::apply(*this, best, key, columns);
+    }
     bool isInput() const override {
         return IsInputRel;
     }
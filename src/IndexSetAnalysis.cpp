@@ -136,12 +136,37 @@ const MaxMatching::Matchings& MaxMatching::solve() {
 
 /** map the keys in the key set to lexicographical order */
 void IndexSet::solve() {
-    if (searches.empty()) {
-        return;
+    solveSearches();
+    addRequiredOrders();
+}
+
+void IndexSet::addRequiredOrders() {
+    const int arity = relation.getArity();
+    for (const auto& order : required) {
+        // check whether one of the computed orders extends to the required order
+        bool covered = std::any_of(orders.begin(), orders.end(), [&](const LexicographicalOrder& cur) {
+            LexicographicalOrder full = cur;
+            for (int i = 0; i < arity; i++) {
+                if (std::find(cur.begin(), cur.end(), i) == cur.end()) {
+                    full.push_back(i);
+                }
+            }
+            return full == order;
+        });
+        if (covered) {
+            continue;
+        }
+
+        // add order with a pseudo chain
+        orders.push_back(order);
+        chainToOrder.push_back(Chain());
     }
+}
 
+void IndexSet::solveSearches() {
     bool isHashsetUsed = [&](const RamRelation& rrel) {
-        if (rrel.isBTree() || rrel.isRbtset() || rrel.isBrie() || rrel.isEqRel()) {
+        if (rrel.isBTree() || rrel.isRbtset() || rrel.isBrie() || rrel.isEqRel() || rrel.isColumnar() ||
+                rrel.isCompressed() || rrel.isSpill()) {
             return false;
         }
 
@@ -155,7 +180,19 @@ void IndexSet::solve() {
     // check whether one of the naive indexers should be used
     // two conditions: either set by environment or relation is a hash map
     static const char ENV_NAIVE_INDEX[] = "SOUFFLE_USE_NAIVE_INDEX";
-    if (isHashsetUsed || std::getenv(ENV_NAIVE_INDEX)) {
+    bool isNaive = isHashsetUsed || std::getenv(ENV_NAIVE_INDEX);
+
+    // range searches are only served by ordered indexes whose chains place the
+    // range column directly after the indexed columns
+    if (!isNaive) {
+        searches.insert(rangeSearches.begin(), rangeSearches.end());
+    }
+
+    if (searches.empty()) {
+        return;
+    }
+
+    if (isNaive) {
         static bool first = true;
 
         // print a warning - only the first time
@@ -300,6 +337,12 @@ void IndexSetAnalysis::run(const RamTranslationUnit& translationUnit) {
         if (const auto* scan = dynamic_cast<const RamScan*>(&node)) {
             IndexSet& indexes = getIndexes(scan->getRelation());
             indexes.addSearch(scan->getRangeQueryColumns());
+            indexes.addRangeSearch(scan->getRangeQueryColumns(), scan->getRangeColumn());
+        } else if (const auto* join = dynamic_cast<const RamLeapfrogJoin*>(&node)) {
+            for (size_t i = 0; i < join->getRelations().size(); i++) {
+                IndexSet& indexes = getIndexes(*join->getRelations()[i]);
+                indexes.addRequiredOrder(join->getOrder(i));
+            }
         } else if (const auto* agg = dynamic_cast<const RamAggregate*>(&node)) {
             IndexSet& indexes = getIndexes(agg->getRelation());
             indexes.addSearch(agg->getRangeQueryColumns());
@@ -20,6 +20,7 @@
 #include "RamAnalysis.h"
 #include "RamRelation.h"
 #include "RamTypes.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <functional>
@@ -109,6 +110,8 @@ protected:
     using SearchSet = std::set<SearchColumns>;
 
     SearchSet searches;           // set of search patterns on table
+    SearchSet rangeSearches;      // set of search patterns extended by a range column
+    OrderCollection required;     // full lexicographical orders required by operations
     OrderCollection orders;       // collection of lexicographical orders
     ChainOrderMap chainToOrder;   // maps order index to set of searches covered by chain
     MaxMatching matching;         // matching problem for finding minimal number of orders
@@ -123,6 +126,26 @@ public:
             searches.insert(cols);
         }
     }
+
+    /** Add new key extended by a column that is bounded by a range */
+    inline void addRangeSearch(SearchColumns cols, int column) {
+        if (column >= 0) {
+            rangeSearches.insert(cols | (1 << column));
+        }
+    }
+
+    /** Add a full lexicographical order that has to be maintained */
+    inline void addRequiredOrder(const LexicographicalOrder& order) {
+        if (std::find(required.begin(), required.end(), order) == required.end()) {
+            required.push_back(order);
+        }
+    }
+
+    /** Get orders that have to be maintained */
+    const OrderCollection& getRequiredOrders() const {
+        return required;
+    }
+
     /** Get relation */
     const RamRelation& getRelation() const {
         return relation;
@@ -173,6 +196,12 @@ public:
     }
 
 protected:
+    /** map the keys in the key set to lexicographical orders covering them */
+    void solveSearches();
+
+    /** add the required orders not covered by the computed orders */
+    void addRequiredOrders();
+
     /** count the number of bits in key */
     // TODO: replace by intrinsic of GCC
     static size_t card(SearchColumns cols) {
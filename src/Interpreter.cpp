@@ -25,6 +25,7 @@
 #include "LogStatement.h"
 #include "Logger.h"
 #include "Macro.h"
+#include "MemoryPlacement.h"
 #include "ParallelUtils.h"
 #include "ProfileEvent.h"
 #include "RamNode.h"
@@ -33,6 +34,7 @@
 #include "RamVisitor.h"
 #include "ReadStream.h"
 #include "SignalHandler.h"
+#include "SpillStorage.h"
 #include "SymbolTable.h"
 #include "TernaryFunctorOps.h"
 #include "UnaryFunctorOps.h"
@@ -43,11 +45,13 @@
 #include <cstdlib>
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <regex>
 #include <stdexcept>
 #include <typeinfo>
+#include <unordered_set>
 #include <utility>
 
 namespace souffle {
@@ -251,6 +255,10 @@ bool Interpreter::evalCond(const RamCondition& cond, const InterpreterContext& c
                     tuple[i] = (values[i]) ? interpreter.evalVal(*values[i], ctxt) : MIN_RAM_DOMAIN;
                 }
 
+                // consult the filter of the total index before searching it
+                if (arity > 0 && !rel.getFilteredIndex(ne.getKey())->mayContain(tuple, arity)) {
+                    return true;
+                }
                 return !rel.exists(tuple);
             }
 
@@ -262,8 +270,11 @@ bool Interpreter::evalCond(const RamCondition& cond, const InterpreterContext& c
                 high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
             }
 
-            // obtain index
-            auto idx = rel.getIndex(ne.getKey());
+            // obtain index, skipping the search if the filter rules out the key
+            auto idx = rel.getFilteredIndex(ne.getKey());
+            if (!idx->mayContain(low, __builtin_popcountll(ne.getKey()))) {
+                return true;
+            }
             auto range = idx->lowerUpperBound(low, high);
             return range.first == range.second;  // if there are none => done
         }
@@ -372,7 +383,8 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             const InterpreterRelation& rel = interpreter.getRelation(scan.getRelation());
 
             // process full scan if no index is given
-            if (scan.getRangeQueryColumns() == 0) {
+            int rangeColumn = scan.getRangeColumn();
+            if (scan.getRangeQueryColumns() == 0 && rangeColumn < 0) {
                 // if scan is not binding anything => check for emptiness
                 if (scan.isPureExistenceCheck() && !rel.empty()) {
                     visitSearch(scan);
@@ -403,7 +415,31 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             }
 
             // obtain index
-            auto idx = rel.getIndex(scan.getRangeQueryColumns(), nullptr);
+            InterpreterIndex* idx;
+            if (rangeColumn >= 0) {
+                // narrow the range by the bounds of the range column
+                if (RamValue* lowerBound = scan.getLowerBounds()[rangeColumn]) {
+                    low[rangeColumn] = interpreter.evalVal(*lowerBound, ctxt);
+                }
+                if (RamValue* upperBound = scan.getUpperBounds()[rangeColumn]) {
+                    hig[rangeColumn] = interpreter.evalVal(*upperBound, ctxt);
+                }
+                if (low[rangeColumn] > hig[rangeColumn]) {
+                    return;
+                }
+                idx = rel.getRangeIndex(scan.getRangeQueryColumns(), rangeColumn);
+            } else if (scan.isPureExistenceCheck()) {
+                // existence checks skip the search if the filter rules out the key
+                idx = rel.getFilteredIndex(scan.getRangeQueryColumns());
+                if (!idx->mayContain(low, __builtin_popcountll(scan.getRangeQueryColumns()))) {
+                    if (Global::config().has("profile") && !scan.getProfileText().empty()) {
+                        interpreter.frequencies[scan.getProfileText()][interpreter.getIterationNumber()]++;
+                    }
+                    return;
+                }
+            } else {
+                idx = rel.getIndex(scan.getRangeQueryColumns(), nullptr);
+            }
 
             // get iterator range
             auto range = idx->lowerUpperBound(low, hig);
@@ -427,6 +463,165 @@ void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args)
             }
         }
 
+        void visitLeapfrogJoin(const RamLeapfrogJoin& join) override {
+            // obtain the indexes ordering the joined relations by their join variables
+            auto rels = join.getRelations();
+            std::vector<InterpreterIndex*> indexes;
+            std::vector<std::vector<RamDomain>> tuples;
+            for (size_t i = 0; i < rels.size(); i++) {
+                const InterpreterRelation& rel = interpreter.getRelation(*rels[i]);
+                if (rel.empty()) {
+                    return;
+                }
+                std::vector<unsigned char> order;
+                for (int column : join.getOrder(i)) {
+                    order.push_back(column);
+                }
+                indexes.push_back(rel.getIndex(InterpreterIndexOrder(order)));
+                tuples.push_back(std::vector<RamDomain>(rel.getArity()));
+            }
+
+            // bind join variables one after another
+            leapfrog(join, indexes, tuples, 0);
+        }
+
+        /**
+         * Binds the given join variable to all values contained in the
+         * relations covering it and continues with the next variable.
+         */
+        void leapfrog(const RamLeapfrogJoin& join, const std::vector<InterpreterIndex*>& indexes,
+                std::vector<std::vector<RamDomain>>& tuples, size_t var) {
+            // if all variables are bound => process nested operation
+            if (var == join.getNumVariables()) {
+                for (size_t i = 0; i < tuples.size(); i++) {
+                    ctxt[join.getBaseLevel() + i] = tuples[i].data();
+                }
+                visitSearch(join);
+                return;
+            }
+
+            // collect relations covering the current variable
+            std::vector<size_t> atoms;
+            for (size_t i = 0; i < tuples.size(); i++) {
+                if (join.getColumn(i, var) >= 0) {
+                    atoms.push_back(i);
+                }
+            }
+
+            RamDomain value = MIN_RAM_DOMAIN;
+            while (true) {
+                // advance value until all covering relations agree on it
+                bool stable = false;
+                while (!stable) {
+                    stable = true;
+                    for (size_t i : atoms) {
+                        RamDomain cur = value;
+                        if (!seek(join, *indexes[i], tuples[i], i, var, cur)) {
+                            return;
+                        }
+                        if (cur != value) {
+                            value = cur;
+                            stable = false;
+                        }
+                    }
+                }
+
+                // bind variable and process next one
+                for (size_t i : atoms) {
+                    tuples[i][join.getColumn(i, var)] = value;
+                }
+                leapfrog(join, indexes, tuples, var + 1);
+
+                // move on to the next value
+                if (value == MAX_RAM_DOMAIN) {
+                    return;
+                }
+                value++;
+            }
+        }
+
+        /**
+         * Obtains the smallest value >= the given value of the column binding
+         * the given variable among the tuples matching the variables bound so far.
+         */
+        bool seek(const RamLeapfrogJoin& join, const InterpreterIndex& index, const std::vector<RamDomain>& tuple,
+                size_t rel, size_t var, RamDomain& value) {
+            auto arity = tuple.size();
+            RamDomain low[arity];
+            RamDomain hig[arity];
+            const auto& vars = join.getVariables(rel);
+            for (size_t i = 0; i < arity; i++) {
+                if (vars[i] < var) {
+                    low[i] = tuple[i];
+                    hig[i] = tuple[i];
+                } else {
+                    low[i] = MIN_RAM_DOMAIN;
+                    hig[i] = MAX_RAM_DOMAIN;
+                }
+            }
+            int column = join.getColumn(rel, var);
+            low[column] = value;
+
+            auto range = index.lowerUpperBound(low, hig);
+            if (range.first == range.second) {
+                return false;
+            }
+            value = (*range.first)[column];
+            return true;
+        }
+
+        void visitHashJoin(const RamHashJoin& join) override {
+            const InterpreterRelation& left = interpreter.getRelation(join.getLeftRelation());
+            const InterpreterRelation& right = interpreter.getRelation(join.getRightRelation());
+            if (left.empty() || right.empty()) {
+                return;
+            }
+
+            // build the hash table on the smaller relation and probe it with the larger one
+            bool hashLeft = left.size() <= right.size();
+            const InterpreterRelation& build = hashLeft ? left : right;
+            const InterpreterRelation& probe = hashLeft ? right : left;
+            const auto& buildKeys = hashLeft ? join.getLeftKeys() : join.getRightKeys();
+            const auto& probeKeys = hashLeft ? join.getRightKeys() : join.getLeftKeys();
+            size_t buildLevel = hashLeft ? join.getLeftLevel() : join.getLevel();
+            size_t probeLevel = hashLeft ? join.getLevel() : join.getLeftLevel();
+
+            auto hash = [&](const RamDomain* tuple) {
+                std::size_t res = 0;
+                for (size_t column : buildKeys) {
+                    res ^= std::hash<RamDomain>()(tuple[column]) + 0x9e3779b9 + (res << 6) + (res >> 2);
+                }
+                return res;
+            };
+            auto equal = [&](const RamDomain* a, const RamDomain* b) {
+                for (size_t column : buildKeys) {
+                    if (a[column] != b[column]) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            std::unordered_multiset<const RamDomain*, decltype(hash), decltype(equal)> table(
+                    build.size(), hash, equal);
+            for (const RamDomain* cur : build) {
+                table.insert(cur);
+            }
+
+            // probe hash table
+            RamDomain key[build.getArity()];
+            for (const RamDomain* cur : probe) {
+                for (size_t i = 0; i < probeKeys.size(); i++) {
+                    key[buildKeys[i]] = cur[probeKeys[i]];
+                }
+                ctxt[probeLevel] = cur;
+                auto range = table.equal_range(key);
+                for (auto it = range.first; it != range.second; ++it) {
+                    ctxt[buildLevel] = *it;
+                    visitSearch(join);
+                }
+            }
+        }
+
         void visitLookup(const RamLookup& lookup) override {
             // get reference
             RamDomain ref = ctxt[lookup.getReferenceLevel()][lookup.getReferencePosition()];
@@ -648,6 +843,7 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
             interpreter.resetIterationNumber();
             while (visit(loop.getBody())) {
                 interpreter.incIterationNumber();
+                interpreter.checkMemoryLimit();
             }
             interpreter.resetIterationNumber();
             return true;
@@ -669,7 +865,9 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
 
         bool visitStratum(const RamStratum& stratum) override {
             // TODO (lyndonhenry): should enable strata as subprograms for interpreter here
-            return visit(stratum.getBody());
+            bool res = visit(stratum.getBody());
+            interpreter.checkMemoryLimit();
+            return res;
         }
 
         bool visitCreate(const RamCreate& create) override {
@@ -705,6 +903,8 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
 
         bool visitLoad(const RamLoad& load) override {
             try {
+                // input relations are read by all threads, thus spread across all NUMA nodes
+                MemoryPlacement::InterleaveScope interleave(Global::config().has("interleave-inputs"));
                 InterpreterRelation& relation = interpreter.getRelation(load.getRelation());
                 std::unique_ptr<ReadStream> reader = IOSystem::getInstance().getReader(
                         load.getRelation().getSymbolMask(), interpreter.getSymbolTable(),
@@ -767,6 +967,20 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
             return true;
         }
 
+        bool visitErase(const RamErase& erase) override {
+            // get involved relation
+            InterpreterRelation& src = interpreter.getRelation(erase.getSourceRelation());
+            InterpreterRelation& trg = interpreter.getRelation(erase.getTargetRelation());
+
+            // erase all elements
+            for (const RamDomain* tuple : src) {
+                trg.erase(tuple);
+            }
+
+            // done
+            return true;
+        }
+
         bool visitSwap(const RamSwap& swap) override {
             interpreter.swapRelation(swap.getFirstRelation(), swap.getSecondRelation());
             return true;
@@ -787,6 +1001,59 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
     StatementEvaluator(*this).visit(stmt);
 }
 
+/** Report the memory used by the relations, the symbol table and the records */
+MemoryReport Interpreter::getMemoryReport() {
+    MemoryReport res;
+    for (const auto& cur : environment) {
+        res.add(cur.first, cur.second->getMemoryUsage());
+    }
+    res.add("@symbol-table", getSymbolTable().getMemoryUsage());
+    res.add("@records", getRecordMemoryUsage());
+    return res;
+}
+
+/** Drop secondary indices, or abort, if the memory limit is exceeded */
+void Interpreter::checkMemoryLimit() {
+    if (!memoryLimit.isDue()) {
+        return;
+    }
+    MemoryReport report = getMemoryReport();
+    if (!memoryLimit.isExceeded(report)) {
+        return;
+    }
+
+    // drop the secondary indices of the largest relations first, they are rebuilt on demand
+    std::vector<std::pair<size_t, InterpreterRelation*>> candidates;
+    for (const auto& cur : environment) {
+        candidates.emplace_back(cur.second->getSecondaryIndexMemoryUsage(), cur.second);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<size_t, InterpreterRelation*>& a,
+                    const std::pair<size_t, InterpreterRelation*>& b) { return a.first > b.first; });
+    size_t excess = report.getTotal() - memoryLimit.getLimit();
+    size_t dropped = 0;
+    for (const auto& cur : candidates) {
+        if (dropped >= excess || cur.first == 0) {
+            break;
+        }
+        cur.second->dropSecondaryIndices();
+        dropped += cur.first;
+    }
+
+    report = getMemoryReport();
+    if (!memoryLimit.isExceeded(report)) {
+        if (Global::config().has("verbose")) {
+            std::cout << "Dropped " << MemoryReport::formatBytes(dropped)
+                      << " of secondary indices to meet the memory limit\n";
+        }
+        return;
+    }
+    std::cerr << "Error: memory limit of " << MemoryReport::formatBytes(memoryLimit.getLimit())
+              << " exceeded\n";
+    report.print(std::cerr);
+    exit(1);
+}
+
 /** Execute main program of a translation unit */
 void Interpreter::executeMain() {
     SignalHandler::instance()->set();
@@ -795,6 +1062,22 @@ void Interpreter::executeMain() {
     }
     const RamStatement& main = *translationUnit.getP().getMain();
 
+    // configure the memory budget of spilling relations
+    if (Global::config().has("spill-budget")) {
+        SpillManager::instance().setBudget(std::stoull(Global::config().get("spill-budget")) << 20);
+    }
+    if (Global::config().has("spill-dir")) {
+        SpillManager::instance().setDirectory(Global::config().get("spill-dir"));
+    }
+    if (Global::config().has("memory-limit")) {
+        memoryLimit = MemoryLimit(std::stoull(Global::config().get("memory-limit")) << 20);
+    }
+
+    // keep the threads on the NUMA nodes hosting the memory they allocate
+    if (Global::config().has("pin-threads")) {
+        MemoryPlacement::instance().pinThreads();
+    }
+
     if (!Global::config().has("profile")) {
         evalStmt(main);
     } else {
@@ -835,9 +1118,12 @@ void Interpreter::executeSubroutine(const RamStatement& stmt, const std::vector<
     ctxt.setReturnErrors(returnErrors);
     ctxt.setArguments(arguments);
 
-    // run subroutine
-    const RamOperation& op = static_cast<const RamInsert&>(stmt).getOperation();
-    evalOp(op, ctxt);
+    // run subroutine, either a search for subproofs or a statement of incremental updates
+    if (auto insert = dynamic_cast<const RamInsert*>(&stmt)) {
+        evalOp(insert->getOperation(), ctxt);
+    } else {
+        evalStmt(stmt);
+    }
 }
 
 }  // end of namespace souffle
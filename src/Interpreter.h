@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include "Global.h"
 #include "InterpreterContext.h"
 #include "InterpreterRelation.h"
+#include "MemoryUsage.h"
 #include "RamCondition.h"
 #include "RamRelation.h"
 #include "RamStatement.h"
@@ -62,6 +64,9 @@ private:
     /** iteration number (in a fix-point calculation) */
     size_t iteration;
 
+    /** limit on the memory of relations, symbols and records */
+    MemoryLimit memoryLimit;
+
 protected:
     /** Evaluate value */
     RamDomain evalVal(const RamValue& value, const InterpreterContext& ctxt = InterpreterContext());
@@ -105,13 +110,34 @@ protected:
         iteration = 0;
     }
 
+    /** Collect the memory occupied by relations, symbols and records */
+    MemoryReport getMemoryReport();
+
+    /**
+     * Enforce the memory limit, if a check is due. Secondary indices of the largest
+     * relations are dropped first; if this is insufficient, the evaluation is aborted
+     * with a report of the largest consumers.
+     *
+     * precondition: no relation is in use
+     */
+    void checkMemoryLimit();
+
     /** Create relation */
     void createRelation(const RamRelation& id) {
         auto pos = environment.find(id.getName());
         InterpreterRelation* res = nullptr;
         assert(pos == environment.end());
         if (!id.isEqRel()) {
-            res = new InterpreterRelation(id.getArity());
+            // columnar relations keep a single copy of their tuples, referred to by all indices
+            bool columnar = id.isColumnar();
+            // spilling relations keep their tuples in files if short of memory
+            bool spill = id.isSpill();
+            if (!id.isBTree() && !id.isRbtset() && !id.isHashset() && !id.isBrie() && !id.isCompressed() &&
+                    !columnar && !spill) {
+                columnar = Global::config().get("data-structure") == "columnar";
+                spill = Global::config().get("data-structure") == "spill";
+            }
+            res = new InterpreterRelation(id.getArity(), columnar, spill);
         } else {
             res = new InterpreterEqRelation(id.getArity());
         }
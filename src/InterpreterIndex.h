@@ -18,10 +18,18 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #include "BTree.h"
+#include "BloomFilter.h"
 #include "RamTypes.h"
+#include "SpillStorage.h"
 #include "Util.h"
 
 namespace souffle {
@@ -132,57 +140,101 @@ public:
     }
 };
 
-/* B-Tree indexes as default implementation for indexes */
+/**
+ * The interface of the indexes of the interpreter. Indexes are created via
+ * createInterpreterIndex(), which chooses an implementation specialised for
+ * the arity of the indexed relation.
+ */
 class InterpreterIndex {
-protected:
-    /* lexicographical comparison operation on two tuple pointers */
-    struct comparator {
-        const InterpreterIndexOrder& order;
+public:
+    /* the state of an iteration, interpreted by the implementation of the index */
+    struct cursor {
+        void* words[6];
+    };
 
-        /* constructor to initialize state */
-        comparator(const InterpreterIndexOrder& order) : order(order) {}
+    /*
+     * An iterator over the tuples of the index. The iterator refers to the tuple it
+     * points to, such that iterators are compared by the addressed tuple; the
+     * end-iterator of every range addresses no tuple.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, const RamDomain*> {
+        const InterpreterIndex* index = nullptr;
+        cursor pos;
+        const RamDomain* value = nullptr;
 
-        /* comparison function */
-        int operator()(const RamDomain* x, const RamDomain* y) const {
-            for (size_t i = 0; i < order.size(); i++) {
-                if (x[order[i]] < y[order[i]]) {
-                    return -1;
-                }
-                if (x[order[i]] > y[order[i]]) {
-                    return 1;
-                }
-            }
-            return 0;
-        }
+    public:
+        iterator() = default;
 
-        /* less comparison */
-        bool less(const RamDomain* x, const RamDomain* y) const {
-            return operator()(x, y) < 0;
+        iterator(const InterpreterIndex* index, const cursor& pos, const RamDomain* value)
+                : index(index), pos(pos), value(value) {}
+
+        const RamDomain* operator*() const {
+            return value;
         }
 
-        /* equal comparison */
-        bool equal(const RamDomain* x, const RamDomain* y) const {
-            for (size_t i = 0; i < order.size(); i++) {
-                if (x[order[i]] != y[order[i]]) {
-                    return false;
-                }
-            }
-            return true;
+        iterator& operator++() {
+            value = index->advance(pos);
+            return *this;
         }
-    };
 
-    /* btree for storing tuple pointers with a given lexicographical order */
-    using index_set = btree_multiset<const RamDomain*, comparator, std::allocator<const RamDomain*>, 512>;
+        bool operator==(const iterator& other) const {
+            return value == other.value;
+        }
 
-public:
-    using iterator = index_set::iterator;
+        bool operator!=(const iterator& other) const {
+            return value != other.value;
+        }
+    };
 
 private:
     const InterpreterIndexOrder theOrder;  // retain the index order used to construct an object of this class
-    index_set set;                         // set storing tuple pointers of table
+
+    /* filter over the first filterLength columns of the order, disabled if filterLength is zero */
+    BloomFilter filter;
+    std::atomic<std::size_t> filterLength;
+
+    /* hashes the first length columns of the order of the given tuple */
+    uint64_t hash(const RamDomain* tuple, std::size_t length) const {
+        uint64_t res = 0;
+        for (size_t i = 0; i < length; i++) {
+            res = BloomFilter::combine(res, tuple[theOrder[i]]);
+        }
+        return res;
+    }
+
+protected:
+    /* adds a tuple to the underlying data structure */
+    virtual void insertTuple(const RamDomain* tuple) = 0;
+
+    /* check whether tuple exists in the underlying data structure */
+    virtual bool containsTuple(const RamDomain* tuple) const = 0;
+
+    /* removes a tuple from the underlying data structure, returning whether it existed */
+    virtual bool eraseTuple(const RamDomain* tuple) = 0;
+
+    /* accounts for a tuple moved to another address, referred to by entries not copying it */
+    virtual void moveTuple(const RamDomain* from, const RamDomain* to) = 0;
+
+    /* removes all tuples from the underlying data structure */
+    virtual void clearTuples() = 0;
+
+    /*
+     * positions the cursor at the first tuple not less than low and records the end of
+     * the range of tuples not greater than high; a null bound covers the whole index.
+     * Returns the first tuple of the range, or null if it is empty.
+     */
+    virtual const RamDomain* seek(cursor& pos, const RamDomain* low, const RamDomain* high) const = 0;
+
+    /* moves the cursor to the next tuple of its range, returning null at the end */
+    virtual const RamDomain* advance(cursor& pos) const = 0;
+
+    /* determines the number of bytes occupied by the underlying data structure */
+    virtual std::size_t getTupleMemoryUsage() const = 0;
 
 public:
-    InterpreterIndex(InterpreterIndexOrder order) : theOrder(std::move(order)), set(comparator(theOrder)) {}
+    explicit InterpreterIndex(InterpreterIndexOrder order) : theOrder(std::move(order)), filterLength(0) {}
+
+    virtual ~InterpreterIndex() = default;
 
     const InterpreterIndexOrder& order() const {
         return theOrder;
@@ -194,7 +246,10 @@ public:
      * precondition: tuple does not exist in the index
      */
     void insert(const RamDomain* tuple) {
-        set.insert(tuple);
+        insertTuple(tuple);
+        if (std::size_t length = filterLength.load(std::memory_order_relaxed)) {
+            filter.insert(hash(tuple, length));
+        }
     }
 
     /**
@@ -204,25 +259,75 @@ public:
      */
     template <class Iter>
     void insert(const Iter& a, const Iter& b) {
-        set.insert(a, b);
+        for (Iter it = a; it != b; ++it) {
+            insert(*it);
+        }
     };
 
+    /**
+     * remove tuple from the index, returning whether it existed; the filter keeps
+     * its hash, which only admits false positives
+     *
+     * precondition: no concurrent operations on the index
+     */
+    bool erase(const RamDomain* tuple) {
+        return eraseTuple(tuple);
+    }
+
+    /**
+     * move a tuple of the index to another address, holding the same values
+     *
+     * precondition: no concurrent operations on the index
+     */
+    void move(const RamDomain* from, const RamDomain* to) {
+        moveTuple(from, to);
+    }
+
+    /**
+     * maintain a Bloom filter over the first length columns of the order
+     *
+     * precondition: no concurrent inserts or lookups; a filter, once enabled, is kept
+     */
+    void enableFilter(std::size_t length) {
+        if (filterLength.load(std::memory_order_relaxed) != 0) {
+            return;
+        }
+        cursor pos;
+        for (const RamDomain* cur = seek(pos, nullptr, nullptr); cur; cur = advance(pos)) {
+            filter.insert(hash(cur, length));
+        }
+        filterLength.store(length, std::memory_order_release);
+    }
+
+    /** check whether the filter of the index is enabled */
+    bool hasFilter() const {
+        return filterLength.load(std::memory_order_acquire) != 0;
+    }
+
+    /** check whether a tuple whose first length columns of the order are bound may exist in the index */
+    bool mayContain(const RamDomain* value, std::size_t length) const {
+        std::size_t filtered = filterLength.load(std::memory_order_acquire);
+        return filtered == 0 || length < filtered || filter.mayContain(hash(value, filtered));
+    }
+
     /** check whether tuple exists in index */
-    bool exists(const RamDomain* value) {
-        return set.find(value) != set.end();
+    bool exists(const RamDomain* value) const {
+        return containsTuple(value);
+    }
+
+    /** determine the number of bytes occupied by the index, including its filter */
+    std::size_t getMemoryUsage() const {
+        return getTupleMemoryUsage() + filter.getMemoryUsage();
     }
 
     /** purge all hashes of index */
     void purge() {
-        set.clear();
+        clearTuples();
+        filter.clear();
     }
 
     /** enables the index to be printed */
-    void print(std::ostream& out) const {
-        set.printStats(out);
-        out << "\n";
-        set.printTree(out);
-    }
+    virtual void print(std::ostream& out) const = 0;
 
     /** return start and end iterator of an equal range */
     inline std::pair<iterator, iterator> equalRange(const RamDomain* value) const {
@@ -231,13 +336,567 @@ public:
 
     /** return start and end iterator of a range */
     inline std::pair<iterator, iterator> lowerUpperBound(const RamDomain* low, const RamDomain* high) const {
-        return std::pair<iterator, iterator>(set.lower_bound(low), set.upper_bound(high));
+        cursor pos;
+        const RamDomain* first = seek(pos, low, high);
+        return std::pair<iterator, iterator>(iterator(this, pos, first), indexEnd());
     }
 
     // TODO: remove this temporary method
     iterator indexEnd() const {
-        return set.end();
+        return iterator();
+    }
+};
+
+/**
+ * The common implementation of indexes storing entries of type Entry in a b-tree.
+ * The Derived class converts tuples to entries and back via its toEntry() and
+ * static toTuple() members.
+ */
+template <typename Derived, typename Entry, typename Comparator, unsigned blockSize,
+        typename SearchStrategy = typename detail::default_strategy<Entry>::type>
+class InterpreterBTreeIndex : public InterpreterIndex {
+protected:
+    /* btree for storing entries with a given lexicographical order */
+    using index_set = btree_multiset<Entry, Comparator, std::allocator<Entry>, blockSize, SearchStrategy>;
+
+    /* the range of entries covered by a cursor */
+    struct range {
+        typename index_set::iterator cur;
+        typename index_set::iterator end;
+    };
+
+    static_assert(sizeof(range) <= sizeof(cursor), "Cursor too small for index range!");
+    static_assert(std::is_trivially_copyable<typename index_set::iterator>::value,
+            "Index iterators must be trivially copyable!");
+
+    index_set set;  // set storing the entries of the tuples of table
+
+    InterpreterBTreeIndex(InterpreterIndexOrder order, const Comparator& comp)
+            : InterpreterIndex(std::move(order)), set(comp) {}
+
+    const Derived& derived() const {
+        return static_cast<const Derived&>(*this);
+    }
+
+    void insertTuple(const RamDomain* tuple) override {
+        set.insert(derived().toEntry(tuple));
+    }
+
+    bool containsTuple(const RamDomain* tuple) const override {
+        return set.contains(derived().toEntry(tuple));
+    }
+
+    bool eraseTuple(const RamDomain* tuple) override {
+        return set.erase(derived().toEntry(tuple));
+    }
+
+    void moveTuple(const RamDomain* from, const RamDomain* to) override {
+        // only entries referring to the tuple rather than copying it are replaced
+        auto entry = derived().toEntry(from);
+        if (Derived::toTuple(entry) == from) {
+            set.erase(entry);
+            set.insert(derived().toEntry(to));
+        }
+    }
+
+    void clearTuples() override {
+        set.clear();
+    }
+
+    const RamDomain* seek(cursor& pos, const RamDomain* low, const RamDomain* high) const override {
+        range* r = new (&pos) range();
+        if (low) {
+            r->cur = set.lower_bound(derived().toEntry(low));
+            r->end = set.upper_bound(derived().toEntry(high));
+        } else {
+            r->cur = set.begin();
+            r->end = set.end();
+        }
+        return (r->cur != r->end) ? Derived::toTuple(*r->cur) : nullptr;
+    }
+
+    const RamDomain* advance(cursor& pos) const override {
+        range* r = reinterpret_cast<range*>(&pos);
+        ++r->cur;
+        return (r->cur != r->end) ? Derived::toTuple(*r->cur) : nullptr;
+    }
+
+    std::size_t getTupleMemoryUsage() const override {
+        return set.getMemoryUsage();
+    }
+
+public:
+    void print(std::ostream& out) const override {
+        set.printStats(out);
+        out << "\n";
+        set.printTree(out);
+    }
+};
+
+namespace detail {
+
+/* The entry of a tuple of the given arity, stored completely within an index */
+template <std::size_t Arity>
+struct interpreter_entry {
+    RamDomain data[Arity];
+
+    friend std::ostream& operator<<(std::ostream& out, const interpreter_entry& e) {
+        out << "[";
+        for (std::size_t i = 0; i < Arity; i++) {
+            out << ((i > 0) ? "," : "") << e.data[i];
+        }
+        return out << "]";
+    }
+};
+
+/* lexicographical comparison operation on entries of the given arity */
+template <std::size_t Arity>
+struct interpreter_comparator {
+    unsigned char columns[Arity];
+
+    /* constructor to initialize state */
+    explicit interpreter_comparator(const InterpreterIndexOrder& order) {
+        assert(order.size() == Arity && "index order must be complete");
+        for (std::size_t i = 0; i < Arity; i++) {
+            columns[i] = order[i];
+        }
+    }
+
+    /* comparison function */
+    int operator()(const interpreter_entry<Arity>& x, const interpreter_entry<Arity>& y) const {
+        for (std::size_t i = 0; i < Arity; i++) {
+            if (x.data[columns[i]] < y.data[columns[i]]) {
+                return -1;
+            }
+            if (x.data[columns[i]] > y.data[columns[i]]) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /* less comparison */
+    bool less(const interpreter_entry<Arity>& x, const interpreter_entry<Arity>& y) const {
+        for (std::size_t i = 0; i < Arity; i++) {
+            if (x.data[columns[i]] != y.data[columns[i]]) {
+                return x.data[columns[i]] < y.data[columns[i]];
+            }
+        }
+        return false;
+    }
+
+    /* equal comparison */
+    bool equal(const interpreter_entry<Arity>& x, const interpreter_entry<Arity>& y) const {
+        for (std::size_t i = 0; i < Arity; i++) {
+            if (x.data[i] != y.data[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}  // end of namespace detail
+
+/**
+ * An index over tuples of a fixed arity. Tuples are stored within the entries of
+ * the index and compared along a fixed number of columns, such that comparisons
+ * are unrolled by the compiler and scans are sequential walks over the leaves.
+ * Nodes hold 64 entries regardless of the arity, such that scans over wide tuples
+ * do not spend their time moving between nodes.
+ */
+template <std::size_t Arity>
+class SpecialisedInterpreterIndex
+        : public InterpreterBTreeIndex<SpecialisedInterpreterIndex<Arity>, detail::interpreter_entry<Arity>,
+                  detail::interpreter_comparator<Arity>, 64 * sizeof(detail::interpreter_entry<Arity>),
+                  detail::linear_search> {
+    using entry = detail::interpreter_entry<Arity>;
+    using base = InterpreterBTreeIndex<SpecialisedInterpreterIndex<Arity>, entry,
+            detail::interpreter_comparator<Arity>, 64 * sizeof(entry), detail::linear_search>;
+
+public:
+    explicit SpecialisedInterpreterIndex(const InterpreterIndexOrder& order)
+            : base(order, detail::interpreter_comparator<Arity>(order)) {}
+
+    /* creates the entry of the given tuple */
+    entry toEntry(const RamDomain* tuple) const {
+        entry res;
+        std::copy(tuple, tuple + Arity, res.data);
+        return res;
+    }
+
+    /* obtains the tuple represented by the given entry */
+    static const RamDomain* toTuple(const entry& e) {
+        return e.data;
+    }
+};
+
+namespace detail {
+
+/* the number of values stored within each entry of a generic index */
+enum { INLINE_COLUMNS = 2 };
+
+/*
+ * An entry of a generic index. Tuples of at most INLINE_COLUMNS values are stored
+ * completely within the entry. For larger tuples the entry stores the leading columns
+ * of the order along with a pointer to the tuple, such that most comparisons do not
+ * have to access the tuple.
+ */
+struct generic_entry {
+    RamDomain data[INLINE_COLUMNS];
+    const RamDomain* tuple;
+
+    /* obtains the tuple represented by this entry */
+    const RamDomain* get() const {
+        return (tuple) ? tuple : data;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const generic_entry& e) {
+        return out << e.get();
+    }
+};
+
+/* lexicographical comparison operation on two entries of a generic index */
+struct generic_comparator {
+    InterpreterIndexOrder order;
+
+    // whether tuples are stored within entries
+    bool inlined;
+
+    /* constructor to initialize state */
+    generic_comparator(InterpreterIndexOrder order, bool inlined)
+            : order(std::move(order)), inlined(inlined) {}
+
+    /* comparison function */
+    int operator()(const generic_entry& x, const generic_entry& y) const {
+        size_t size = order.size();
+        if (inlined) {
+            for (size_t i = 0; i < size; i++) {
+                if (x.data[order[i]] < y.data[order[i]]) {
+                    return -1;
+                }
+                if (x.data[order[i]] > y.data[order[i]]) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+        size_t stored = std::min<size_t>(size, INLINE_COLUMNS);
+        for (size_t i = 0; i < stored; i++) {
+            if (x.data[i] < y.data[i]) {
+                return -1;
+            }
+            if (x.data[i] > y.data[i]) {
+                return 1;
+            }
+        }
+        for (size_t i = stored; i < size; i++) {
+            if (x.tuple[order[i]] < y.tuple[order[i]]) {
+                return -1;
+            }
+            if (x.tuple[order[i]] > y.tuple[order[i]]) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /* less comparison */
+    bool less(const generic_entry& x, const generic_entry& y) const {
+        return operator()(x, y) < 0;
+    }
+
+    /* equal comparison */
+    bool equal(const generic_entry& x, const generic_entry& y) const {
+        return operator()(x, y) == 0;
+    }
+};
+
+}  // end of namespace detail
+
+/**
+ * An index over tuples of any arity, serving as the fallback for arities without
+ * a specialised index.
+ */
+class GenericInterpreterIndex : public InterpreterBTreeIndex<GenericInterpreterIndex, detail::generic_entry,
+                                        detail::generic_comparator, 1024> {
+    using entry = detail::generic_entry;
+
+    const size_t arity;  // the arity of the indexed tuples
+
+    /* determines whether tuples are stored within the entries of the index */
+    bool isInlined() const {
+        return arity <= detail::INLINE_COLUMNS;
+    }
+
+public:
+    GenericInterpreterIndex(const InterpreterIndexOrder& order, size_t arity)
+            : InterpreterBTreeIndex(
+                      order, detail::generic_comparator(order, arity <= detail::INLINE_COLUMNS)),
+              arity(arity) {}
+
+    /* creates the entry of the given tuple */
+    entry toEntry(const RamDomain* tuple) const {
+        entry res;
+        if (isInlined()) {
+            for (size_t i = 0; i < detail::INLINE_COLUMNS; i++) {
+                res.data[i] = (i < arity) ? tuple[i] : 0;
+            }
+            res.tuple = nullptr;
+            return res;
+        }
+        size_t stored = std::min<size_t>(order().size(), detail::INLINE_COLUMNS);
+        for (size_t i = 0; i < detail::INLINE_COLUMNS; i++) {
+            res.data[i] = (i < stored) ? tuple[order()[i]] : 0;
+        }
+        res.tuple = tuple;
+        return res;
+    }
+
+    /* obtains the tuple represented by the given entry */
+    static const RamDomain* toTuple(const entry& e) {
+        return e.get();
     }
 };
 
+namespace detail {
+
+/* lexicographical comparison operation on tuples referred to by pointers */
+struct pointer_comparator {
+    InterpreterIndexOrder order;
+
+    /* constructor to initialize state */
+    explicit pointer_comparator(InterpreterIndexOrder order) : order(std::move(order)) {}
+
+    /* comparison function */
+    int operator()(const RamDomain* x, const RamDomain* y) const {
+        for (size_t i = 0; i < order.size(); i++) {
+            if (x[order[i]] < y[order[i]]) {
+                return -1;
+            }
+            if (x[order[i]] > y[order[i]]) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /* less comparison */
+    bool less(const RamDomain* x, const RamDomain* y) const {
+        return operator()(x, y) < 0;
+    }
+
+    /* equal comparison */
+    bool equal(const RamDomain* x, const RamDomain* y) const {
+        return operator()(x, y) == 0;
+    }
+};
+
+}  // end of namespace detail
+
+/**
+ * An index of relations exceeding the available memory. Recently inserted tuples
+ * are referred to by a b-tree, older ones are copied into a sorted run within a
+ * memory-mapped file. Once the SpillManager asks for memory, the b-tree is merged
+ * with the run into a new run, such that ranges merge two sorted sequences.
+ */
+class SpillInterpreterIndex : public InterpreterIndex, private Spillable {
+    using index_set = btree_set<const RamDomain*, detail::pointer_comparator>;
+
+    // the number of insertions between two checks of the memory budget
+    enum { CHECK_INTERVAL = 1024 };
+
+    /* the range of tuples covered by a cursor */
+    struct range {
+        index_set::iterator cur;
+        index_set::iterator end;
+        const RamDomain* runCur;
+        const RamDomain* runEnd;
+    };
+
+    static_assert(sizeof(range) <= sizeof(cursor), "Cursor too small for index range!");
+
+    const size_t arity;  // the arity of the indexed tuples
+
+    detail::pointer_comparator comp;
+
+    index_set set;  // the recently inserted tuples
+
+    MappedRun run;  // the spilled tuples, stored with a stride of the arity
+
+    size_t sinceCheck = 0;  // the number of insertions since the budget has been checked
+
+    /* obtains the first spilled tuple not less than (or, if upper, greater than) the given one */
+    const RamDomain* runBound(const RamDomain* tuple, bool upper) const {
+        const RamDomain* first = run.begin();
+        size_t count = (run.end() - run.begin()) / arity;
+        while (count > 0) {
+            size_t step = count / 2;
+            const RamDomain* mid = first + step * arity;
+            int res = comp(mid, tuple);
+            if (res < 0 || (upper && res == 0)) {
+                first = mid + arity;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    /* obtains the smaller head of the two sequences of the range, or null if exhausted */
+    static const RamDomain* head(const range& r, const detail::pointer_comparator& comp) {
+        if (r.runCur != r.runEnd && (r.cur == r.end || comp.less(r.runCur, *r.cur))) {
+            return r.runCur;
+        }
+        return (r.cur != r.end) ? *r.cur : nullptr;
+    }
+
+    /* merges the b-tree into the run */
+    void spill() {
+        MappedRun merged;
+        merged.open();
+        cursor pos;
+        for (const RamDomain* cur = seek(pos, nullptr, nullptr); cur; cur = advance(pos)) {
+            merged.append(cur, arity);
+        }
+        merged.seal();
+        run = std::move(merged);
+        set.clear();
+        setResidentSize(0);
+        resetAccesses();
+    }
+
+protected:
+    void insertTuple(const RamDomain* tuple) override {
+        set.insert(tuple);
+
+        // check the memory budget every once in a while, counting the referenced tuples
+        if (++sinceCheck == CHECK_INTERVAL) {
+            sinceCheck = 0;
+            setResidentSize(set.size() * (arity + 1) * sizeof(RamDomain));
+            if (SpillManager::instance().shouldSpill(*this)) {
+                spill();
+            }
+        }
+    }
+
+    bool containsTuple(const RamDomain* tuple) const override {
+        const_cast<SpillInterpreterIndex*>(this)->touch();
+        if (set.contains(tuple)) {
+            return true;
+        }
+        const RamDomain* pos = runBound(tuple, false);
+        return pos != run.end() && comp.equal(pos, tuple);
+    }
+
+    bool eraseTuple(const RamDomain* tuple) override {
+        if (set.erase(tuple)) {
+            return true;
+        }
+        const RamDomain* pos = runBound(tuple, false);
+        if (pos == run.end() || !comp.equal(pos, tuple)) {
+            return false;
+        }
+        // runs are immutable, thus the remaining spilled tuples are written anew
+        MappedRun rest;
+        rest.open();
+        for (const RamDomain* cur = run.begin(); cur != run.end(); cur += arity) {
+            if (cur != pos) {
+                rest.append(cur, arity);
+            }
+        }
+        rest.seal();
+        run = std::move(rest);
+        return true;
+    }
+
+    void moveTuple(const RamDomain* from, const RamDomain* to) override {
+        // spilled tuples are copies, recently inserted ones are referred to
+        if (set.erase(from)) {
+            set.insert(to);
+        }
+    }
+
+    void clearTuples() override {
+        set.clear();
+        run = MappedRun();
+        setResidentSize(0);
+    }
+
+    std::size_t getTupleMemoryUsage() const override {
+        // spilled tuples are paged out by the operating system
+        return set.getMemoryUsage();
+    }
+
+    const RamDomain* seek(cursor& pos, const RamDomain* low, const RamDomain* high) const override {
+        const_cast<SpillInterpreterIndex*>(this)->touch();
+        range* r = new (&pos) range();
+        if (low) {
+            r->cur = set.lower_bound(low);
+            r->end = set.upper_bound(high);
+            r->runCur = runBound(low, false);
+            r->runEnd = runBound(high, true);
+        } else {
+            r->cur = set.begin();
+            r->end = set.end();
+            r->runCur = run.begin();
+            r->runEnd = run.end();
+        }
+        return head(*r, comp);
+    }
+
+    const RamDomain* advance(cursor& pos) const override {
+        range* r = reinterpret_cast<range*>(&pos);
+        if (head(*r, comp) == r->runCur) {
+            r->runCur += arity;
+        } else {
+            ++r->cur;
+        }
+        return head(*r, comp);
+    }
+
+public:
+    SpillInterpreterIndex(const InterpreterIndexOrder& order, size_t arity)
+            : InterpreterIndex(order), arity(arity), comp(order), set(comp) {}
+
+    void print(std::ostream& out) const override {
+        out << "Spill Index: " << set.size() << " tuples in memory, " << (run.end() - run.begin()) / arity
+            << " tuples spilled\n";
+    }
+};
+
+/**
+ * Creates an index of the given order over tuples of the given arity, utilizing
+ * a specialised implementation for common arities. Compact indexes do not copy
+ * the indexed tuples but only their leading columns, referring to the tuples
+ * stored by the relation otherwise.
+ */
+inline std::unique_ptr<InterpreterIndex> createInterpreterIndex(
+        const InterpreterIndexOrder& order, size_t arity, bool compact = false) {
+    if (compact) {
+        return std::make_unique<GenericInterpreterIndex>(order, arity);
+    }
+    switch (arity) {
+        case 1:
+            return std::make_unique<SpecialisedInterpreterIndex<1>>(order);
+        case 2:
+            return std::make_unique<SpecialisedInterpreterIndex<2>>(order);
+        case 3:
+            return std::make_unique<SpecialisedInterpreterIndex<3>>(order);
+        case 4:
+            return std::make_unique<SpecialisedInterpreterIndex<4>>(order);
+        case 5:
+            return std::make_unique<SpecialisedInterpreterIndex<5>>(order);
+        case 6:
+            return std::make_unique<SpecialisedInterpreterIndex<6>>(order);
+        case 7:
+            return std::make_unique<SpecialisedInterpreterIndex<7>>(order);
+        case 8:
+            return std::make_unique<SpecialisedInterpreterIndex<8>>(order);
+        default:
+            return std::make_unique<GenericInterpreterIndex>(order, arity);
+    }
+}
+
 }  // end of namespace souffle
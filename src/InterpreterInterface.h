@@ -16,12 +16,18 @@
 
 #pragma once
 
+#include "IOSystem.h"
 #include "Interpreter.h"
 #include "RamVisitor.h"
 #include "SouffleInterface.h"
+#include "StratumAnalysis.h"
 
+#include <algorithm>
 #include <array>
+#include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace souffle {
 
@@ -124,6 +130,48 @@ protected:
         }
     };
 
+    /**
+     * Iterator wrapper class for ranges of an index
+     */
+    class range_iterator_base : public Relation::iterator_base {
+    private:
+        const InterpreterRelInterface* ramRelationInterface;
+        InterpreterIndex::iterator it;
+        tuple tup;
+
+    public:
+        range_iterator_base(
+                uint32_t arg_id, const InterpreterRelInterface* r, const InterpreterIndex::iterator& i)
+                : Relation::iterator_base(arg_id), ramRelationInterface(r), it(i), tup(r) {}
+        ~range_iterator_base() override = default;
+
+        /** Increment iterator */
+        void operator++() override {
+            ++it;
+        }
+
+        /** Get current tuple */
+        tuple& operator*() override {
+            tup.rewind();
+            for (size_t i = 0; i < ramRelationInterface->getArity(); i++) {
+                tup[i] = (*it)[i];
+            }
+            return tup;
+        }
+
+        /** Clone iterator */
+        iterator_base* clone() const override {
+            return new InterpreterRelInterface::range_iterator_base(getId(), ramRelationInterface, it);
+        }
+
+    protected:
+        /** Check equivalence */
+        bool equal(const Relation::iterator_base& o) const override {
+            const auto* iter = dynamic_cast<const InterpreterRelInterface::range_iterator_base*>(&o);
+            return iter != nullptr && ramRelationInterface == iter->ramRelationInterface && it == iter->it;
+        }
+    };
+
 public:
     InterpreterRelInterface(InterpreterRelation& r, SymbolTable& s, std::string n, std::vector<std::string> t,
             std::vector<std::string> an, bool rInput, bool rOutput, uint32_t i)
@@ -141,6 +189,65 @@ public:
         return relation.exists(convertTupleToNums(t));
     }
 
+    /** Erase tuple */
+    bool erase(const tuple& t) override {
+        std::vector<RamDomain> values(t.size());
+        for (size_t i = 0; i < t.size(); i++) {
+            values[i] = t[i];
+        }
+        return relation.erase(values.data());
+    }
+
+    /** Remove all tuples */
+    void purge() override {
+        relation.purge();
+    }
+
+    /** Insert tuples stored one after another */
+    void insertAll(const RamDomain* rows, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            relation.insert(rows + i * getArity());
+        }
+    }
+
+    /** Copy tuples into an array, one after another */
+    size_t exportAll(RamDomain* rows, size_t capacity) const override {
+        const size_t arity = getArity();
+        size_t n = 0;
+        for (auto it = relation.begin(); n < capacity && it != relation.end(); ++it, ++n) {
+            std::copy(*it, *it + arity, rows + n * arity);
+        }
+        return n;
+    }
+
+    /** Copy tuples into an array per attribute */
+    size_t exportColumns(RamDomain* const* columns, size_t capacity) const override {
+        size_t n = 0;
+        for (auto it = relation.begin(); n < capacity && it != relation.end(); ++it, ++n) {
+            for (size_t j = 0; j < getArity(); j++) {
+                columns[j][n] = (*it)[j];
+            }
+        }
+        return n;
+    }
+
+    /** Tuples agreeing with the pattern on the given columns, obtained from an index on these columns */
+    iterator_range equalRange(const tuple& pattern, SearchColumns columns) const override {
+        if (columns == 0 || getArity() == 0) {
+            return iterator_range(begin(), end());
+        }
+        std::vector<RamDomain> low(getArity(), MIN_RAM_DOMAIN);
+        std::vector<RamDomain> high(getArity(), MAX_RAM_DOMAIN);
+        for (size_t i = 0; i < getArity(); i++) {
+            if ((columns >> i) & 1) {
+                low[i] = high[i] = pattern[i];
+            }
+        }
+        auto res = relation.getIndex(columns)->lowerUpperBound(low.data(), high.data());
+        return iterator_range(iterator(new range_iterator_base(id, this, res.first)),
+                iterator(new range_iterator_base(id, this, res.second)));
+    }
+
     /** Iterator to first tuple */
     iterator begin() const override {
         return InterpreterRelInterface::iterator(
@@ -236,9 +343,32 @@ public:
             InterpreterRelInterface* interface = new InterpreterRelInterface(interpreterRel, symTable,
                     rel.getName(), types, attrNames, rel.isInput(), rel.isOutput(), id);
             interfaces.push_back(interface);
-            addRelation(rel.getName(), interface, rel.isInput(), rel.isOutput());
+            if (rel.isTemp()) {
+                addTempRelation(rel.getName(), interface);
+            } else {
+                addRelation(rel.getName(), interface, rel.isInput(), rel.isOutput());
+            }
             id++;
         }
+
+        // Register strata for the selection of outputs and incremental updates
+        const auto* analysis = interp.getTranslationUnit().getAnalysis<StratumAnalysis>();
+        auto getNames = [](const std::set<RamRelation>& rels) {
+            std::set<std::string> names;
+            for (const RamRelation& rel : rels) {
+                names.insert(rel.getName());
+            }
+            return names;
+        };
+        visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
+            // strata without an update subroutine are computed anew by incremental updates
+            bool maintained = prog.getSubroutines().count("update_" + std::to_string(stratum.getIndex())) > 0;
+            addStratum(stratum.getIndex(), getNames(analysis->getDependencies(stratum.getIndex())),
+                    getNames(analysis->getComputedRelations(stratum.getIndex())), maintained);
+        });
+        if (Global::config().has("incremental")) {
+            setIncremental();
+        }
     }
     ~InterpreterProgInterface() override {
         for (auto* interface : interfaces) {
@@ -252,8 +382,20 @@ public:
     /** Load data, run program instance, store data: not implemented */
     void runAll(std::string, std::string, size_t) override {}
 
-    /** Load input data: not implemented */
-    void loadAll(std::string) override {}
+    /** Load input data */
+    void loadAll(std::string inputDirectory) override {
+        visitDepthFirst(*(prog.getMain()), [&](const RamLoad& load) {
+            IODirectives ioDirectives = load.getIODirectives();
+            if (!inputDirectory.empty() && ioDirectives.getIOType() == "file" &&
+                    ioDirectives.getFileName().front() != '/') {
+                ioDirectives.setFileName(inputDirectory + "/" + ioDirectives.getFileName());
+            }
+            IOSystem::getInstance()
+                    .getReader(load.getRelation().getSymbolMask(), symTable, ioDirectives,
+                            Global::config().has("provenance"))
+                    ->readAll(exec.getRelation(load.getRelation()));
+        });
+    }
 
     /** Print output data: not implemented */
     void printAll(std::string) override {}
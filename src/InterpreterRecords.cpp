@@ -15,6 +15,7 @@
  ***********************************************************************/
 
 #include "InterpreterRecords.h"
+#include "MemoryUsage.h"
 #include <cassert>
 #include <limits>
 #include <map>
@@ -73,6 +74,20 @@ public:
         return index;
     }
 
+    /**
+     * Estimates the number of bytes occupied by this map.
+     */
+    size_t getMemoryUsage() const {
+        size_t res;
+#pragma omp critical(record_pack)
+        {
+            // each tuple is stored twice, as a key of the ordered map and as an element of the list
+            res = getTreeMemoryUsage(r2i) + i2r.capacity() * sizeof(vector<RamDomain>) +
+                  (r2i.size() + i2r.size()) * arity * sizeof(RamDomain);
+        }
+        return res;
+    }
+
     /**
      * Obtains a pointer to the tuple addressed by the given index.
      */
@@ -86,12 +101,19 @@ public:
     }
 };
 
+/**
+ * The static container of the record maps of all arities -- filled on demand.
+ */
+map<int, RecordMap>& getMaps() {
+    static map<int, RecordMap> maps;
+    return maps;
+}
+
 /**
  * The static access function for record maps of certain arities.
  */
 RecordMap& getForArity(int arity) {
-    // the static container -- filled on demand
-    static map<int, RecordMap> maps;
+    auto& maps = getMaps();
 
     // get container if present
     auto pos = maps.find(arity);
@@ -115,6 +137,14 @@ RamDomain* unpack(RamDomain ref, int arity) {
     return getForArity(arity).unpack(ref);
 }
 
+size_t getRecordMemoryUsage() {
+    size_t res = 0;
+    for (const auto& cur : getMaps()) {
+        res += cur.second.getMemoryUsage();
+    }
+    return res;
+}
+
 RamDomain getNull() {
     return 0;
 }
@@ -18,6 +18,8 @@
 
 #include "RamTypes.h"
 
+#include <cstddef>
+
 namespace souffle {
 
 /**
@@ -30,6 +32,11 @@ RamDomain pack(RamDomain* tuple, int arity);
  */
 RamDomain* unpack(RamDomain ref, int arity);
 
+/**
+ * Obtains the number of bytes occupied by the records of all arities.
+ */
+std::size_t getRecordMemoryUsage();
+
 /**
  * Obtains the null-reference constant.
  */
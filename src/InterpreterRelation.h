@@ -19,6 +19,7 @@
 #include "InterpreterIndex.h"
 #include "ParallelUtils.h"
 #include "RamTypes.h"
+#include "SpillStorage.h"
 
 #include <deque>
 #include <map>
@@ -35,13 +36,30 @@ private:
     /** Arity of relation */
     const size_t arity;
 
+    /** Whether indices refer to the stored tuples rather than copying them */
+    const bool columnar;
+
     /** Size of blocks containing tuples */
     static const int BLOCK_SIZE = 1024;
 
     /** Number of tuples in relation */
     size_t num_tuples;
 
-    std::deque<std::unique_ptr<RamDomain[]>> blockList;
+    /** Releases blocks allocated on the heap; blocks of the arena are released by the arena */
+    struct block_deleter {
+        bool owned;
+
+        void operator()(RamDomain* block) const {
+            if (owned) {
+                delete[] block;
+            }
+        }
+    };
+
+    std::deque<std::unique_ptr<RamDomain[], block_deleter>> blockList;
+
+    /** File-backed memory for the blocks of relations spilling to disk, null otherwise */
+    std::unique_ptr<MappedArena> arena;
 
     /** List of indices */
     mutable std::map<InterpreterIndexOrder, std::unique_ptr<InterpreterIndex>> indices;
@@ -49,11 +67,17 @@ private:
     /** Total index for existence checks */
     mutable InterpreterIndex* totalIndex;
 
+    /** The stored tuples ordered by their values, locating erased tuples; created by the first erasure */
+    using slot_set = btree_set<const RamDomain*, detail::pointer_comparator>;
+    std::unique_ptr<slot_set> slots;
+
     /** Lock for parallel execution */
     mutable Lock lock;
 
 public:
-    InterpreterRelation(size_t relArity) : arity(relArity), num_tuples(0), totalIndex(nullptr) {}
+    InterpreterRelation(size_t relArity, bool columnar = false, bool spill = false)
+            : arity(relArity), columnar(columnar), num_tuples(0),
+              arena(spill ? std::make_unique<MappedArena>() : nullptr), totalIndex(nullptr) {}
 
     InterpreterRelation(const InterpreterRelation& other) = delete;
 
@@ -94,7 +118,12 @@ public:
         int tupleIndex = (num_tuples % (BLOCK_SIZE / arity)) * arity;
 
         if (tupleIndex == 0) {
-            blockList.push_back(std::make_unique<RamDomain[]>(BLOCK_SIZE));
+            if (arena) {
+                auto* block = static_cast<RamDomain*>(arena->allocate(BLOCK_SIZE * sizeof(RamDomain)));
+                blockList.emplace_back(block, block_deleter{false});
+            } else {
+                blockList.emplace_back(new RamDomain[BLOCK_SIZE](), block_deleter{true});
+            }
         }
 
         RamDomain* newTuple = &blockList[blockIndex][tupleIndex];
@@ -106,6 +135,9 @@ public:
         for (const auto& cur : indices) {
             cur.second->insert(newTuple);
         }
+        if (slots) {
+            slots->insert(newTuple);
+        }
 
         // increment relation size
         num_tuples++;
@@ -126,15 +158,123 @@ public:
         }
     }
 
+    /**
+     * Erase tuple, returning whether it existed. The last stored tuple takes the place
+     * of the erased one, such that tuples remain stored contiguously.
+     *
+     * precondition: no concurrent operations on the relation
+     */
+    virtual bool erase(const RamDomain* tuple) {
+        if (arity == 0) {
+            bool existed = num_tuples > 0;
+            num_tuples = 0;
+            return existed;
+        }
+        if (!exists(tuple)) {
+            return false;
+        }
+
+        // locate the stored tuples by their values
+        if (!slots) {
+            InterpreterIndexOrder order;
+            for (size_t i = 0; i < arity; i++) {
+                order.append(i);
+            }
+            slots = std::make_unique<slot_set>(detail::pointer_comparator(order));
+            for (const RamDomain* cur : *this) {
+                slots->insert(cur);
+            }
+        }
+        auto* hole = const_cast<RamDomain*>(*slots->find(tuple));
+
+        // the given tuple may be stored by this relation, thus indices are updated before moving tuples
+        for (const auto& cur : indices) {
+            cur.second->erase(tuple);
+        }
+        slots->erase(hole);
+
+        size_t last = num_tuples - 1;
+        size_t blockIndex = last / (BLOCK_SIZE / arity);
+        size_t tupleIndex = (last % (BLOCK_SIZE / arity)) * arity;
+        RamDomain* lastTuple = &blockList[blockIndex][tupleIndex];
+        if (lastTuple != hole) {
+            std::copy(lastTuple, lastTuple + arity, hole);
+            for (const auto& cur : indices) {
+                cur.second->move(lastTuple, hole);
+            }
+            slots->erase(lastTuple);
+            slots->insert(hole);
+        }
+        if (tupleIndex == 0) {
+            blockList.pop_back();
+        }
+        num_tuples--;
+        return true;
+    }
+
+    /** Erase tuple via arguments */
+    template <typename... Args>
+    bool erase(RamDomain first, Args... rest) {
+        RamDomain tuple[] = {first, RamDomain(rest)...};
+        return erase(tuple);
+    }
+
     /** Purge table */
     void purge() {
         blockList.clear();
+        if (arena) {
+            arena->clear();
+        }
         for (const auto& cur : indices) {
             cur.second->purge();
         }
+        slots.reset();
         num_tuples = 0;
     }
 
+    /** Determine the number of bytes occupied by the tuples and indices of the relation */
+    size_t getMemoryUsage() const {
+        // blocks of spilling relations are paged out by the operating system
+        size_t res = sizeof(*this) + (arena ? 0 : blockList.size() * BLOCK_SIZE * sizeof(RamDomain));
+        auto lease = lock.acquire();
+        (void)lease;
+        for (const auto& cur : indices) {
+            res += cur.second->getMemoryUsage();
+        }
+        return res;
+    }
+
+    /** Determine the number of bytes occupied by indices other than the one for existence checks */
+    size_t getSecondaryIndexMemoryUsage() const {
+        size_t res = 0;
+        auto lease = lock.acquire();
+        (void)lease;
+        for (const auto& cur : indices) {
+            if (cur.second.get() != totalIndex) {
+                res += cur.second->getMemoryUsage();
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Drop all indices other than the one for existence checks, releasing their memory.
+     * Indices are rebuilt from the stored tuples once requested again.
+     *
+     * precondition: no index of the relation is in use
+     */
+    void dropSecondaryIndices() {
+        auto lease = lock.acquire();
+        (void)lease;
+        for (auto it = indices.begin(); it != indices.end();) {
+            if (it->second.get() != totalIndex) {
+                it = indices.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
     /** get index for a given set of keys using a cached index as a helper. Keys are encoded as bits for each
      * column */
     InterpreterIndex* getIndex(const SearchColumns& key, InterpreterIndex* cachedIndex) const {
@@ -187,6 +327,52 @@ public:
         return getIndex(order);
     }
 
+    /**
+     * get index for a given set of keys that is further ordered by the given
+     * column, so that bounds on this column restrict the range of the index.
+     */
+    InterpreterIndex* getRangeIndex(const SearchColumns& key, unsigned char column) const {
+        assert(!(key & (1 << column)) && "range column must not be a key");
+
+        // convert to order
+        InterpreterIndexOrder order;
+        for (size_t k = 1, i = 0; i < getArity(); i++, k *= 2) {
+            if (key & k) {
+                order.append(i);
+            }
+        }
+
+        // see whether there is an order with a matching prefix followed by the column
+        InterpreterIndex* res = nullptr;
+        {
+            auto lease = lock.acquire();
+            (void)lease;
+
+            for (auto it = indices.begin(); !res && it != indices.end(); ++it) {
+                if (order.isCompatible(it->first) && it->first.size() > order.size() &&
+                        it->first[order.size()] == column) {
+                    res = it->second.get();
+                }
+            }
+        }
+        // if found, use compatible index
+        if (res) {
+            return res;
+        }
+
+        // extend index to full index
+        order.append(column);
+        for (size_t i = 0; i < getArity(); i++) {
+            if (!order.covers(i)) {
+                order.append(i);
+            }
+        }
+        assert(order.isComplete());
+
+        // get a new index
+        return getIndex(order);
+    }
+
     /** get index for a given order. Keys are encoded as bits for each column */
     InterpreterIndex* getIndex(const InterpreterIndexOrder& order) const {
         // TODO: improve index usage by re-using indices with common prefix
@@ -197,7 +383,11 @@ public:
             auto pos = indices.find(order);
             if (pos == indices.end()) {
                 std::unique_ptr<InterpreterIndex>& newIndex = indices[order];
-                newIndex = std::make_unique<InterpreterIndex>(order);
+                if (arena) {
+                    newIndex = std::make_unique<SpillInterpreterIndex>(order, arity);
+                } else {
+                    newIndex = createInterpreterIndex(order, arity, columnar);
+                }
                 newIndex->insert(this->begin(), this->end());
                 res = newIndex.get();
             } else {
@@ -207,6 +397,20 @@ public:
         return res;
     }
 
+    /**
+     * get index for a given set of keys maintaining a Bloom filter over the key columns, such
+     * that lookups of absent keys can be answered without searching the index.
+     */
+    InterpreterIndex* getFilteredIndex(const SearchColumns& key) const {
+        InterpreterIndex* res = getIndex(key);
+        if (!res->hasFilter()) {
+            auto lease = lock.acquire();
+            (void)lease;
+            res->enableFilter(__builtin_popcountll(key));
+        }
+        return res;
+    }
+
     /** Obtains a full index-key for this relation */
     SearchColumns getTotalIndexKey() const {
         return (1 << (getArity())) - 1;
@@ -332,6 +536,25 @@ public:
         }
     }
 
+    /** Erase tuple; the remaining tuples are closed anew, which may imply the erased one again */
+    bool erase(const RamDomain* tuple) override {
+        if (!exists(tuple)) {
+            return false;
+        }
+        RamDomain erased[2] = {tuple[0], tuple[1]};
+        std::vector<RamDomain> rest;
+        for (const RamDomain* cur : *this) {
+            if (cur[0] != erased[0] || cur[1] != erased[1]) {
+                rest.insert(rest.end(), cur, cur + 2);
+            }
+        }
+        purge();
+        for (size_t i = 0; i < rest.size(); i += 2) {
+            insert(&rest[i]);
+        }
+        return !exists(erased);
+    }
+
     /** Find the new knowledge generated by inserting a tuple */
     std::vector<RamDomain*> extend(const RamDomain* tuple) override {
         std::vector<RamDomain*> newTuples;
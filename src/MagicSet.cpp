@@ -20,12 +20,14 @@
 #include "AstNode.h"
 #include "AstProgram.h"
 #include "AstRelation.h"
+#include "AstSizeAnalysis.h"
 #include "AstTransforms.h"
 #include "AstTranslationUnit.h"
 #include "BinaryConstraintOps.h"
 #include "Global.h"
 #include "IODirectives.h"
 #include "SrcLocation.h"
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -399,27 +401,28 @@ std::set<AstRelationIdentifier> addForwardDependencies(
     }
 }
 
-// ensures that every relation not specified by the magic-transform option
-// is ignored by the transformation
-std::set<AstRelationIdentifier> addIgnoredRelations(
-        const AstProgram* program, std::set<AstRelationIdentifier> relations) {
+// finds the relations named by the magic-transform option
+std::set<AstRelationIdentifier> getSpecifiedRelations(const AstProgram* program) {
     // get a set of all relations specified by the option
     std::set<std::string> specifiedRelations = split(Global::config().get("magic-transform"), ',');
 
     // if a star was used as a relation, then magic set will be performed for all nodes
-    if (contains(specifiedRelations, "*")) {
-        return relations;
-    }
+    bool all = contains(specifiedRelations, "*");
 
     // find all specified relations
     std::set<AstRelationIdentifier> targetRelations;
     for (AstRelation* rel : program->getRelations()) {
         std::string mainName = rel->getName().getNames()[0];
-        if (contains(specifiedRelations, mainName)) {
+        if (all || contains(specifiedRelations, mainName)) {
             targetRelations.insert(rel->getName());
         }
     }
+    return targetRelations;
+}
 
+// ensures that every relation not targeted by the transformation is ignored by it
+std::set<AstRelationIdentifier> addIgnoredRelations(const AstProgram* program,
+        std::set<AstRelationIdentifier> relations, std::set<AstRelationIdentifier> targetRelations) {
     // add all backward-dependencies to the list of relations to transform;
     // if we want to magic transform 'a', then we also have to magic transform
     // every relation that (directly or indirectly) uses 'a' in its clauses
@@ -705,93 +708,12 @@ BindingStore bindComposites(const AstProgram* program) {
     return compositeBindings;
 }
 
-// runs the adornment algorithm on an input program
-// Adornment algorithm:
-
-// Let P be the set of all adorned predicates (initially empty)
-// Let D' be the set of all adorned clauses (initially empty)
-// Let S be the set of all seen predicate adornments
-
-// Get the program
-// Get the query
-// Adorn the query based on boundness, and add it to P and S
-// While P is not empty
-// -- Pop the first atom out, call it R^c, where c is the adornment
-// -- For every clause Q defining R:
-// -- -- Adorn Q using R^c based on the SIPS chosen
-// -- -- Add the adorned clause to D'
-// -- -- If the body of the adorned clause contains an
-//        unseen predicate adornment, add it to S and P
-
-// Output: D' [the set of all adorned clauses]
-void Adornment::run(const AstTranslationUnit& translationUnit) {
-    // -------------
-    // --- Setup ---
-    // -------------
-    const AstProgram* program = translationUnit.getProgram();
+// adorns the clauses reachable from each output query, where ignored predicates are not adorned
+std::vector<std::vector<AdornedClause>> adornQueries(const AstProgram* program,
+        const std::vector<AstRelationIdentifier>& outputQueries, const std::set<AstRelationIdentifier>& edb,
+        const std::set<AstRelationIdentifier>& ignored, BindingStore& compositeBindings) {
+    std::vector<std::vector<AdornedClause>> result;
 
-    // normalises and tracks bindings of composite arguments (namely records and functors)
-    BindingStore compositeBindings = bindComposites(program);
-
-    // set up IDB/EDB and the output queries
-    std::vector<AstRelationIdentifier> outputQueries;
-    std::vector<std::vector<AdornedClause>> adornedProgram;
-
-    // sort out the relations in the program into EDB/IDB and find computed relations
-    for (AstRelation* rel : program->getRelations()) {
-        AstRelationIdentifier relName = rel->getName();
-
-        // find computed relations for the topdown part
-        if (rel->isComputed()) {
-            outputQueries.push_back(rel->getName());
-            adornmentRelations.push_back(rel->getName());  // add relation to adornment
-        }
-
-        // check whether edb or idb
-        bool is_edb = true;
-        for (AstClause* clause : rel->getClauses()) {
-            if (!clause->isFact()) {
-                is_edb = false;
-                break;
-            }
-        }
-
-        if (is_edb) {
-            adornmentEdb.insert(relName);
-        } else {
-            adornmentIdb.insert(relName);
-        }
-    }
-
-    // find all negated literals
-    visitDepthFirst(*program,
-            [&](const AstNegation& negation) { negatedAtoms.insert(negation.getAtom()->getName()); });
-
-    // add the relations needed for negated relations to be computed
-    negatedAtoms = addForwardDependencies(program, negatedAtoms);
-
-    // find atoms that should be ignored
-    for (AstRelation* rel : program->getRelations()) {
-        for (AstClause* clause : rel->getClauses()) {
-            // ignore atoms that have rules containing aggregators
-            if (containsAggregators(clause)) {
-                ignoredAtoms.insert(clause->getHead()->getName());
-            }
-
-            // ignore all atoms used inside an aggregator within the clause
-            ignoredAtoms = addAggregators(clause, ignoredAtoms);
-        }
-    }
-
-    // find atoms that should be ignored based on magic-transform option
-    ignoredAtoms = addIgnoredRelations(program, ignoredAtoms);
-
-    // if a relation is ignored, then all the atoms in its bodies need to be ignored
-    ignoredAtoms = addForwardDependencies(program, ignoredAtoms);
-
-    // -----------------
-    // --- Adornment ---
-    // -----------------
     // begin adornment algorithm
     // adornment is performed for each output query separately
     for (auto outputQuery : outputQueries) {
@@ -813,7 +735,7 @@ void Adornment::run(const AstTranslationUnit& translationUnit) {
             currentPredicates.erase(currentPredicates.begin());
 
             // don't bother adorning ignored predicates
-            if (contains(ignoredAtoms, currPredicate.getName())) {
+            if (contains(ignored, currPredicate.getName())) {
                 continue;
             }
 
@@ -866,7 +788,7 @@ void Adornment::run(const AstTranslationUnit& translationUnit) {
 
                 while (atomsAdorned < atomsTotal) {
                     // get the next body atom to adorn based on our SIPS
-                    int currIndex = getNextAtomSIPS(atoms, boundArgs, adornmentEdb, compositeBindings);
+                    int currIndex = getNextAtomSIPS(atoms, boundArgs, edb, compositeBindings);
                     AstAtom* currAtom = atoms[currIndex];
                     AstRelationIdentifier atomName = currAtom->getName();
 
@@ -900,9 +822,206 @@ void Adornment::run(const AstTranslationUnit& translationUnit) {
         }
 
         // add the list of adorned clauses matching the current output relation
-        adornmentClauses.push_back(adornedClauses);
+        result.push_back(adornedClauses);
     }
 
+    return result;
+}
+
+// Selects the relations worth transforming, given the adornments induced by the output queries if
+// all relations were transformed. A relation pays off if each of its adornments binds a column, and
+// the demanded tuples along with the magic tuples restricting them are estimated to be a fraction
+// of the relation computed in full.
+std::set<AstRelationIdentifier> selectMagicRelations(const AstTranslationUnit& translationUnit,
+        const std::vector<std::vector<AdornedClause>>& adornedProgram,
+        const std::set<AstRelationIdentifier>& edb, const std::set<AstRelationIdentifier>& excluded) {
+    // the factor by which the estimated cost of the transformation has to undercut the full relation
+    const double overhead = 2;
+
+    const AstProgram* program = translationUnit.getProgram();
+    const auto* sizes = translationUnit.getAnalysis<RelationSizeAnalysis>();
+
+    // the number of distinct combinations of values of the bound columns of an adorned predicate
+    auto getBindings = [&](const AdornedPredicate& pred) {
+        std::string adornment = pred.getAdornment();
+        double res = 1;
+        for (size_t i = 0; i < adornment.size(); i++) {
+            if (adornment[i] == 'b') {
+                res *= sizes->getDistinct(pred.getName(), i);
+            }
+        }
+        return res;
+    };
+
+    // estimate the bindings demanded of each adorned predicate, propagated from the output queries
+    // along the order of the atoms chosen by the SIPS; a few rounds account for recursive demand
+    std::map<AdornedPredicate, double> demand;
+    for (int round = 0; round < 3; round++) {
+        for (const std::vector<AdornedClause>& adornedClauses : adornedProgram) {
+            for (const AdornedClause& adornedClause : adornedClauses) {
+                AstClause* clause = adornedClause.getClause();
+                std::string headAdornment = adornedClause.getHeadAdornment();
+                AdornedPredicate head(clause->getHead()->getName(), headAdornment);
+                double bindings = (demand.count(head) > 0) ? demand[head] : 1;
+
+                std::set<std::string> boundArgs;
+                std::vector<AstArgument*> headArguments = clause->getHead()->getArguments();
+                for (size_t i = 0; i < headArguments.size(); i++) {
+                    if (headAdornment[i] == 'b') {
+                        boundArgs.insert(getString(headArguments[i]));
+                    }
+                }
+
+                std::vector<AstAtom*> atoms = clause->getAtoms();
+                std::vector<std::string> bodyAdornment = adornedClause.getBodyAdornment();
+                std::vector<unsigned int> ordering = adornedClause.getOrdering();
+                std::vector<size_t> order(atoms.size());
+                for (size_t i = 0; i < atoms.size(); i++) {
+                    order[ordering[i]] = i;
+                }
+                for (size_t i : order) {
+                    AdornedPredicate pred(atoms[i]->getName(), bodyAdornment[i]);
+                    demand[pred] = std::max(demand[pred], std::min(bindings, getBindings(pred)));
+                    bindings *= sizes->getMatches(*atoms[i], boundArgs);
+                    visitDepthFirst(
+                            *atoms[i], [&](const AstVariable& var) { boundArgs.insert(var.getName()); });
+                }
+            }
+        }
+    }
+
+    // collect the adornments of each relation
+    std::map<AstRelationIdentifier, std::vector<AdornedPredicate>> adornments;
+    for (const auto& cur : demand) {
+        adornments[cur.first.getName()].push_back(cur.first);
+    }
+
+    std::set<AstRelationIdentifier> result;
+    for (const auto& cur : adornments) {
+        const AstRelation* rel = program->getRelation(cur.first);
+        if (contains(edb, cur.first) || contains(excluded, cur.first) || rel->isComputed()) {
+            continue;
+        }
+        double size = sizes->getSize(cur.first);
+        double cost = 0;
+        bool restricted = true;
+        for (const AdornedPredicate& pred : cur.second) {
+            if (pred.getAdornment().find('b') == std::string::npos) {
+                // the relation is computed in full anyway
+                restricted = false;
+                break;
+            }
+            double bindings = demand[pred];
+            double tuples = std::min(size, bindings * size / std::max(1.0, getBindings(pred)));
+            cost += bindings * rel->clauseSize() + tuples;
+        }
+        if (restricted && overhead * cost < size) {
+            result.insert(cur.first);
+        }
+    }
+    return result;
+}
+
+// runs the adornment algorithm on an input program
+// Adornment algorithm:
+
+// Let P be the set of all adorned predicates (initially empty)
+// Let D' be the set of all adorned clauses (initially empty)
+// Let S be the set of all seen predicate adornments
+
+// Get the program
+// Get the query
+// Adorn the query based on boundness, and add it to P and S
+// While P is not empty
+// -- Pop the first atom out, call it R^c, where c is the adornment
+// -- For every clause Q defining R:
+// -- -- Adorn Q using R^c based on the SIPS chosen
+// -- -- Add the adorned clause to D'
+// -- -- If the body of the adorned clause contains an
+//        unseen predicate adornment, add it to S and P
+
+// Output: D' [the set of all adorned clauses]
+void Adornment::run(const AstTranslationUnit& translationUnit) {
+    // -------------
+    // --- Setup ---
+    // -------------
+    const AstProgram* program = translationUnit.getProgram();
+
+    // normalises and tracks bindings of composite arguments (namely records and functors)
+    BindingStore compositeBindings = bindComposites(program);
+
+    // set up IDB/EDB and the output queries
+    std::vector<AstRelationIdentifier> outputQueries;
+
+    // sort out the relations in the program into EDB/IDB and find computed relations
+    for (AstRelation* rel : program->getRelations()) {
+        AstRelationIdentifier relName = rel->getName();
+
+        // find computed relations for the topdown part
+        if (rel->isComputed()) {
+            outputQueries.push_back(rel->getName());
+            adornmentRelations.push_back(rel->getName());  // add relation to adornment
+        }
+
+        // check whether edb or idb
+        bool is_edb = true;
+        for (AstClause* clause : rel->getClauses()) {
+            if (!clause->isFact()) {
+                is_edb = false;
+                break;
+            }
+        }
+
+        if (is_edb) {
+            adornmentEdb.insert(relName);
+        } else {
+            adornmentIdb.insert(relName);
+        }
+    }
+
+    // find all negated literals
+    visitDepthFirst(*program,
+            [&](const AstNegation& negation) { negatedAtoms.insert(negation.getAtom()->getName()); });
+
+    // add the relations needed for negated relations to be computed
+    negatedAtoms = addForwardDependencies(program, negatedAtoms);
+
+    // find atoms that should be ignored
+    for (AstRelation* rel : program->getRelations()) {
+        for (AstClause* clause : rel->getClauses()) {
+            // ignore atoms that have rules containing aggregators
+            if (containsAggregators(clause)) {
+                ignoredAtoms.insert(clause->getHead()->getName());
+            }
+
+            // ignore all atoms used inside an aggregator within the clause
+            ignoredAtoms = addAggregators(clause, ignoredAtoms);
+        }
+    }
+
+    // find atoms that should be ignored based on magic-transform option
+    std::set<AstRelationIdentifier> targetRelations = getSpecifiedRelations(program);
+    if (contains(split(Global::config().get("magic-transform"), ','), "auto")) {
+        // adorn the program as if all relations were transformed, to find those worth transforming
+        std::set<AstRelationIdentifier> excluded = addForwardDependencies(program, ignoredAtoms);
+        excluded.insert(negatedAtoms.begin(), negatedAtoms.end());
+        std::vector<std::vector<AdornedClause>> adornedProgram =
+                adornQueries(program, outputQueries, adornmentEdb, excluded, compositeBindings);
+        for (const AstRelationIdentifier& rel :
+                selectMagicRelations(translationUnit, adornedProgram, adornmentEdb, excluded)) {
+            targetRelations.insert(rel);
+        }
+    }
+    ignoredAtoms = addIgnoredRelations(program, ignoredAtoms, targetRelations);
+
+    // if a relation is ignored, then all the atoms in its bodies need to be ignored
+    ignoredAtoms = addForwardDependencies(program, ignoredAtoms);
+
+    // -----------------
+    // --- Adornment ---
+    // -----------------
+    adornmentClauses = adornQueries(program, outputQueries, adornmentEdb, ignoredAtoms, compositeBindings);
+
     this->bindings = std::move(compositeBindings);
 }
 
@@ -0,0 +1,306 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MemoryPlacement.h
+ *
+ * Placement of the memory of data structures on the NUMA nodes of the
+ * machine, and of the threads evaluating a program on its CPUs.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle {
+
+/**
+ * The placement of large memory regions and of threads on a NUMA machine.
+ *
+ * Regions are bound to the node of the allocating thread, such that a data
+ * structure filled by several threads keeps the parts of each thread close to
+ * it. While an interleaving scope is active, regions are spread across all
+ * nodes instead; this suits data read by all threads, like input relations.
+ * Regions of at least the size of a huge page are aligned to huge pages and
+ * advised to be backed by them, saving TLB misses on large structures.
+ *
+ * The topology is obtained from sysfs and the binding is applied via the
+ * mbind system call, thus no NUMA library is required. On machines with a
+ * single node, or if the binding fails, regions are placed by the kernel.
+ */
+class MemoryPlacement {
+public:
+    /** The size of huge pages */
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2 << 20;
+
+private:
+    // the minimal size of regions mapped directly, smaller ones are obtained from the heap
+    static constexpr std::size_t MIN_MAPPED_SIZE = 64 << 10;
+
+    // memory policies of the mbind system call
+    static constexpr int MPOL_PREFERRED_MODE = 1;
+    static constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+    // the NUMA node of each CPU
+    std::vector<int> cpuNodes;
+
+    // the CPUs of each NUMA node
+    std::vector<std::vector<int>> nodeCpus;
+
+    // the number of active interleaving scopes
+    std::atomic<int> interleaving;
+
+    MemoryPlacement() : interleaving(0) {
+#ifdef __linux__
+        if (DIR* dir = opendir("/sys/devices/system/node")) {
+            while (struct dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                    continue;
+                }
+                std::size_t node = std::stoul(name.substr(4));
+                if (node >= nodeCpus.size()) {
+                    nodeCpus.resize(node + 1);
+                }
+                std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+                std::string list;
+                std::getline(file, list);
+                nodeCpus[node] = parseCpuList(list);
+                for (int cpu : nodeCpus[node]) {
+                    if (cpu >= (int)cpuNodes.size()) {
+                        cpuNodes.resize(cpu + 1, 0);
+                    }
+                    cpuNodes[cpu] = node;
+                }
+            }
+            closedir(dir);
+        }
+#endif
+        if (nodeCpus.empty()) {
+            nodeCpus.resize(1);
+        }
+    }
+
+    // parses a list of CPUs of the form 0-3,8,10-11
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> res;
+        std::stringstream in(list);
+        std::string range;
+        while (std::getline(in, range, ',')) {
+            if (range.empty() || !isdigit(range[0])) {
+                continue;
+            }
+            std::size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                res.push_back(cpu);
+            }
+        }
+        return res;
+    }
+
+    // binds the given region to the nodes of the given mask, ignoring failures
+    void bind(void* addr, std::size_t bytes, int mode, const std::vector<unsigned long>& mask) const {
+#if defined(__linux__) && defined(SYS_mbind)
+        const std::size_t bits = 8 * sizeof(unsigned long);
+        syscall(SYS_mbind, addr, bytes, mode, mask.data(), mask.size() * bits + 1, 0);
+#endif
+    }
+
+    // obtains the mask of the given node, or of all nodes if negative
+    std::vector<unsigned long> getNodeMask(int node) const {
+        const std::size_t bits = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> mask(nodeCpus.size() / bits + 1, 0);
+        for (std::size_t cur = 0; cur < nodeCpus.size(); cur++) {
+            if ((node < 0 && !nodeCpus[cur].empty()) || (int)cur == node) {
+                mask[cur / bits] |= 1ul << (cur % bits);
+            }
+        }
+        return mask;
+    }
+
+    // rounds the given size of a mapped region up to the granularity of its pages
+    static std::size_t getMappedSize(std::size_t bytes) {
+        std::size_t page = bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : sysconf(_SC_PAGESIZE);
+        return (bytes + page - 1) & ~(page - 1);
+    }
+
+public:
+    /** Obtains the placement of this process */
+    static MemoryPlacement& instance() {
+        static MemoryPlacement placement;
+        return placement;
+    }
+
+    /** Obtains the number of NUMA nodes, including nodes without CPUs */
+    int getNumNodes() const {
+        return nodeCpus.size();
+    }
+
+    /** Obtains the NUMA node of the CPU executing the calling thread */
+    int getCurrentNode() const {
+        if (nodeCpus.size() == 1) {
+            return 0;
+        }
+        int cpu = sched_getcpu();
+        return (cpu >= 0 && cpu < (int)cpuNodes.size()) ? cpuNodes[cpu] : 0;
+    }
+
+    /**
+     * Obtains a region of the given size, placed on the given node unless an
+     * interleaving scope is active. The region has to be released via deallocate.
+     */
+    void* allocate(std::size_t bytes, int node) {
+        if (bytes < MIN_MAPPED_SIZE) {
+            void* res = malloc(bytes);
+            if (!res) {
+                throw std::bad_alloc();
+            }
+            return res;
+        }
+
+        std::size_t size = getMappedSize(bytes);
+        bool huge = size >= HUGE_PAGE_SIZE;
+
+        // over-allocate huge regions to trim them to an aligned range
+        std::size_t mapped = huge ? size + HUGE_PAGE_SIZE : size;
+        void* region = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        char* res = static_cast<char*>(region);
+        if (huge) {
+            char* aligned = reinterpret_cast<char*>(
+                    (reinterpret_cast<std::uintptr_t>(res) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+            if (aligned != res) {
+                munmap(res, aligned - res);
+            }
+            if (aligned + size != res + mapped) {
+                munmap(aligned + size, res + mapped - (aligned + size));
+            }
+            res = aligned;
+#ifdef MADV_HUGEPAGE
+            madvise(res, size, MADV_HUGEPAGE);
+#endif
+        }
+
+        // the binding takes effect when pages are touched first, thus prior to any write
+        if (nodeCpus.size() > 1) {
+            if (interleaving > 0) {
+                bind(res, size, MPOL_INTERLEAVE_MODE, getNodeMask(-1));
+            } else {
+                bind(res, size, MPOL_PREFERRED_MODE, getNodeMask(node));
+            }
+        }
+        return res;
+    }
+
+    /** Releases a region of the given size obtained via allocate */
+    void deallocate(void* region, std::size_t bytes) {
+        if (bytes < MIN_MAPPED_SIZE) {
+            free(region);
+        } else {
+            munmap(region, getMappedSize(bytes));
+        }
+    }
+
+    /**
+     * Pins the threads of OpenMP to the NUMA nodes in a round-robin fashion, such
+     * that the memory a thread places on its node stays local to it. Threads are
+     * pinned to all CPUs of their node rather than a single CPU, thus threads of
+     * nested parallel regions inheriting the affinity are not serialized.
+     */
+    void pinThreads() const {
+#if defined(_OPENMP) && defined(__linux__)
+        // only consider the CPUs this process may run on
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return;
+        }
+        std::vector<cpu_set_t> sets;
+        for (const auto& cpus : nodeCpus) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            bool empty = true;
+            for (int cpu : cpus) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                    CPU_SET(cpu, &set);
+                    empty = false;
+                }
+            }
+            if (!empty) {
+                sets.push_back(set);
+            }
+        }
+        if (sets.size() < 2) {
+            return;
+        }
+#pragma omp parallel
+        {
+            const cpu_set_t& set = sets[omp_get_thread_num() % sets.size()];
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+#endif
+    }
+
+    /**
+     * A scope during which regions are interleaved across all nodes, rather than
+     * being placed on the node of the allocating thread. This applies to the
+     * allocations of all threads.
+     */
+    class InterleaveScope {
+        // whether interleaving is enabled by this scope
+        bool enabled;
+
+    public:
+        explicit InterleaveScope(bool enabled = true) : enabled(enabled) {
+            if (enabled) {
+                instance().interleaving++;
+            }
+        }
+
+        InterleaveScope(const InterleaveScope&) = delete;
+
+        InterleaveScope& operator=(const InterleaveScope&) = delete;
+
+        ~InterleaveScope() {
+            if (enabled) {
+                instance().interleaving--;
+            }
+        }
+    };
+};
+
+}  // end of namespace souffle
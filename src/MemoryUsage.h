@@ -0,0 +1,154 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MemoryUsage.h
+ *
+ * Utilities accounting for the memory occupied by the data structures of a
+ * program and enforcing a limit on it.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Estimates the number of bytes occupied by an ordered container of the standard
+ * library, where each node holds the value along with three links and a color.
+ */
+template <typename Container>
+std::size_t getTreeMemoryUsage(const Container& container) {
+    using value_type = typename Container::value_type;
+    return sizeof(container) + container.size() * (sizeof(value_type) + 4 * sizeof(void*));
+}
+
+/**
+ * Estimates the number of bytes occupied by a hashed container of the standard
+ * library, where each node holds the value along with a link and the cached hash.
+ */
+template <typename Container>
+std::size_t getHashMemoryUsage(const Container& container) {
+    using value_type = typename Container::value_type;
+    return sizeof(container) + container.size() * (sizeof(value_type) + 2 * sizeof(void*)) +
+           container.bucket_count() * sizeof(void*);
+}
+
+/**
+ * A summary of the memory occupied by the data structures of a program, such
+ * as relations, the symbol table and the records.
+ */
+class MemoryReport {
+    // the named consumers and their number of bytes
+    std::vector<std::pair<std::string, std::size_t>> entries;
+
+    // the total number of bytes of all consumers
+    std::size_t total = 0;
+
+public:
+    /** Adds a consumer of the given number of bytes */
+    void add(const std::string& name, std::size_t bytes) {
+        entries.emplace_back(name, bytes);
+        total += bytes;
+    }
+
+    /** Obtains the number of bytes occupied by all consumers */
+    std::size_t getTotal() const {
+        return total;
+    }
+
+    /** Obtains the consumers, the largest first */
+    std::vector<std::pair<std::string, std::size_t>> getTopConsumers() const {
+        auto res = entries;
+        std::stable_sort(res.begin(), res.end(),
+                [](const std::pair<std::string, std::size_t>& a,
+                        const std::pair<std::string, std::size_t>& b) { return a.second > b.second; });
+        return res;
+    }
+
+    /** Prints the total and the given number of largest consumers */
+    void print(std::ostream& out, std::size_t limit = 10) const {
+        out << "Memory usage: " << formatBytes(total) << "\n";
+        auto top = getTopConsumers();
+        for (std::size_t i = 0; i < top.size() && i < limit; i++) {
+            out << "  " << std::setw(10) << formatBytes(top[i].second) << "  " << std::setw(5) << std::fixed
+                << std::setprecision(1) << (total ? 100.0 * top[i].second / total : 0.0) << "%  "
+                << top[i].first << "\n";
+        }
+    }
+
+    /** Formats the given number of bytes using the largest fitting binary unit */
+    static std::string formatBytes(std::size_t bytes) {
+        static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+        double value = bytes;
+        unsigned unit = 0;
+        while (value >= 1024 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+            value /= 1024;
+            unit++;
+        }
+        std::stringstream res;
+        res << std::fixed << std::setprecision(unit ? 1 : 0) << value << units[unit];
+        return res.str();
+    }
+};
+
+/**
+ * A limit on the memory occupied by the data structures of a program. Accounting
+ * requires a walk over all data structures, thus checks are due at most once
+ * per interval rather than at every opportunity.
+ */
+class MemoryLimit {
+    // the limit in bytes, zero if disabled
+    std::size_t limit;
+
+    // the minimal time between two checks
+    std::chrono::milliseconds interval;
+
+    // the time the next check is due
+    std::chrono::steady_clock::time_point next;
+
+public:
+    explicit MemoryLimit(std::size_t bytes = 0, std::chrono::milliseconds interval = std::chrono::seconds(1))
+            : limit(bytes), interval(interval), next(std::chrono::steady_clock::now()) {}
+
+    /** Obtains the limit in bytes, zero if disabled */
+    std::size_t getLimit() const {
+        return limit;
+    }
+
+    /** Determines whether the limit is enabled and a check is due, scheduling the next one */
+    bool isDue() {
+        if (limit == 0) {
+            return false;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now < next) {
+            return false;
+        }
+        next = now + interval;
+        return true;
+    }
+
+    /** Determines whether the given report exceeds the limit */
+    bool isExceeded(const MemoryReport& report) const {
+        return limit != 0 && report.getTotal() > limit;
+    }
+};
+
+}  // end of namespace souffle
@@ -0,0 +1,204 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file NodePool.h
+ *
+ * A slab allocator for the nodes of tree-shaped data structures.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "MemoryPlacement.h"
+#include "ParallelUtils.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A pool providing the memory for nodes of type T.
+ *
+ * Nodes are carved from slabs of geometrically growing size, such that a
+ * structure of n nodes performs only O(log n) heap allocations and its nodes
+ * are kept close to each other. Released nodes are recycled by subsequent
+ * allocations, and releaseAll() recycles all nodes at once without visiting
+ * them. The slabs are retained until the pool is destroyed, such that
+ * structures which are repeatedly cleared and refilled -- like the delta
+ * relations of a fixpoint computation -- do not stress the heap.
+ *
+ * On NUMA machines, each node has a partition of slabs placed on it, and
+ * threads allocate from the partition of their node. Threads inserting
+ * into a structure thus create the nodes they are likely to visit in local
+ * memory. Slabs are capped at the size of a huge page, such that large
+ * structures are backed by huge pages.
+ *
+ * Allocations and releases may be conducted concurrently. The pool does not
+ * construct or destroy nodes; this is the responsibility of the client.
+ */
+template <typename T>
+class NodePool {
+    // the number of nodes of the first slab
+    static constexpr std::size_t INITIAL_SLAB_SIZE = 4;
+
+    // the maximal number of bytes per slab
+    static constexpr std::size_t MAX_SLAB_BYTES = MemoryPlacement::HUGE_PAGE_SIZE;
+
+    /* The link of released nodes, stored in the memory of the node itself. */
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    /* The memory of a single node. */
+    union Block {
+        FreeNode link;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type node;
+    };
+
+    /* A contiguous range of blocks obtained from the heap. */
+    struct Slab {
+        Block* blocks;
+        std::size_t size;
+        std::size_t bytes;
+    };
+
+    static_assert(alignof(Block) <= alignof(std::max_align_t), "Over-aligned nodes are not supported!");
+
+    /* The slabs placed on a single NUMA node. */
+    struct Partition {
+        // the slabs of this partition, in the order of their allocation
+        std::vector<Slab> slabs;
+
+        // the slab currently utilized for new nodes
+        std::size_t curSlab = 0;
+
+        // the number of blocks of the current slab handed out so far
+        std::size_t curBlock = 0;
+
+        // the list of released nodes
+        FreeNode* freeList = nullptr;
+
+        // synchronizes concurrent allocations and releases
+        SpinLock lock;
+    };
+
+    // the partitions of this pool, one per NUMA node
+    std::unique_ptr<Partition[]> partitions;
+
+    // the number of partitions
+    std::size_t numPartitions;
+
+    // obtains the partition of the calling thread
+    Partition& getPartition() {
+        return partitions[MemoryPlacement::instance().getCurrentNode() % numPartitions];
+    }
+
+public:
+    NodePool()
+            : partitions(new Partition[MemoryPlacement::instance().getNumNodes()]),
+              numPartitions(MemoryPlacement::instance().getNumNodes()) {}
+
+    NodePool(const NodePool&) = delete;
+
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        for (std::size_t i = 0; i < numPartitions; i++) {
+            for (const Slab& cur : partitions[i].slabs) {
+                MemoryPlacement::instance().deallocate(cur.blocks, cur.bytes);
+            }
+        }
+    }
+
+    /** Obtains the uninitialized memory for a single node. */
+    void* allocate() {
+        int node = MemoryPlacement::instance().getCurrentNode();
+        Partition& part = partitions[node % numPartitions];
+        std::lock_guard<SpinLock> guard(part.lock);
+
+        // recycle a released node if possible
+        if (part.freeList) {
+            FreeNode* res = part.freeList;
+            part.freeList = res->next;
+            return res;
+        }
+
+        // move on to the next slab if the current one is exhausted
+        auto& slabs = part.slabs;
+        while (part.curSlab < slabs.size() && part.curBlock == slabs[part.curSlab].size) {
+            part.curSlab++;
+            part.curBlock = 0;
+        }
+
+        // add a new slab if all are exhausted
+        if (part.curSlab == slabs.size()) {
+            std::size_t size = slabs.empty() ? INITIAL_SLAB_SIZE : 2 * slabs.back().size;
+            std::size_t bytes = size * sizeof(Block);
+            if (bytes > MAX_SLAB_BYTES) {
+                // fill a whole huge page, unless a single node exceeds it
+                size = (sizeof(Block) < MAX_SLAB_BYTES) ? MAX_SLAB_BYTES / sizeof(Block) : 1;
+                bytes = (sizeof(Block) < MAX_SLAB_BYTES) ? MAX_SLAB_BYTES : sizeof(Block);
+            }
+            auto* blocks = static_cast<Block*>(MemoryPlacement::instance().allocate(bytes, node));
+            slabs.push_back(Slab{blocks, size, bytes});
+        }
+
+        return &slabs[part.curSlab].blocks[part.curBlock++];
+    }
+
+    /** Returns the memory of a node obtained from this pool for later reuse. */
+    void release(void* node) {
+        Partition& part = getPartition();
+        std::lock_guard<SpinLock> guard(part.lock);
+        auto* cur = static_cast<FreeNode*>(node);
+        cur->next = part.freeList;
+        part.freeList = cur;
+    }
+
+    /**
+     * Returns the memory of all nodes obtained from this pool for later reuse. Nodes
+     * still in use must not be accessed any more.
+     */
+    void releaseAll() {
+        for (std::size_t i = 0; i < numPartitions; i++) {
+            Partition& part = partitions[i];
+            std::lock_guard<SpinLock> guard(part.lock);
+            part.freeList = nullptr;
+            part.curSlab = 0;
+            part.curBlock = 0;
+        }
+    }
+
+    /** Exchanges the nodes of this and the given pool. */
+    void swap(NodePool& other) {
+        std::swap(partitions, other.partitions);
+        std::swap(numPartitions, other.numPartitions);
+    }
+
+    /** Obtains the number of bytes reserved by this pool. */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = 0;
+        for (std::size_t i = 0; i < numPartitions; i++) {
+            for (const Slab& cur : partitions[i].slabs) {
+                res += cur.bytes;
+            }
+        }
+        return res;
+    }
+};
+
+}  // end of namespace souffle
@@ -354,6 +354,11 @@ public:
         parseJson(json["root"], root);
     }
 
+    // add the entries of the parsed contents of a profile log
+    void addEntries(const json11::Json& json) {
+        parseJson(json["root"], root);
+    }
+
     // add size entry
     void addSizeEntry(std::vector<std::string> qualifier, size_t size) {
         assert(qualifier.size() > 0 && "no qualifier");
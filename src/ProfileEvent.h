@@ -40,24 +40,62 @@ namespace souffle {
 
 /**
  * Profile Event Singleton
+ *
+ * Besides the instance shared by the process, program instances may keep
+ * profiles of their own, which receive the events of the threads within
+ * a scope of the profile.
  */
 class ProfileEventSingleton {
     /** profile database */
     profile::ProfileDatabase database;
 
-    ProfileEventSingleton() = default;
+    /** profile receiving the events of the calling thread, if not the shared one */
+    static ProfileEventSingleton*& current() {
+        static thread_local ProfileEventSingleton* profile = nullptr;
+        return profile;
+    }
 
 public:
+    ProfileEventSingleton() = default;
+
+    ProfileEventSingleton(const ProfileEventSingleton&) = delete;
+
+    ProfileEventSingleton& operator=(const ProfileEventSingleton&) = delete;
+
     ~ProfileEventSingleton() {
         stopTimer();
     }
 
-    /** get instance */
+    /** get instance, being the profile of the innermost scope of the calling thread if any */
     static ProfileEventSingleton& instance() {
+        if (ProfileEventSingleton* profile = current()) {
+            return *profile;
+        }
         static ProfileEventSingleton singleton;
         return singleton;
     }
 
+    /**
+     * A scope during which the events of the calling thread are recorded in
+     * the given profile.
+     */
+    class Scope {
+        ProfileEventSingleton* prev;
+
+    public:
+        explicit Scope(ProfileEventSingleton& profile) : prev(current()) {
+            current() = &profile;
+        }
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            current() = prev;
+        }
+    };
+
     /** create time event */
     void makeTimeEvent(const std::string& txt) {
         profile::EventProcessorSingleton::instance().process(database, txt.c_str(), now().time_since_epoch());
@@ -121,11 +159,14 @@ private:
     /**  Profile Timer */
     class ProfileTimer {
     private:
+        /** profile receiving the utilisation events */
+        ProfileEventSingleton& profile;
+
         /** time interval between per utilisation read */
         uint32_t t;
 
         /** timer is running */
-        bool running = false;
+        std::atomic<bool> running{false};
 
         /** thread timer runs on */
         std::thread th;
@@ -135,7 +176,7 @@ private:
 
         /** run method for thread th */
         void run() {
-            ProfileEventSingleton::instance().makeUtilisationEvent("@utilisation");
+            profile.makeUtilisationEvent("@utilisation");
             ++runCount;
             if (runCount % 128 == 0) {
                 increaseInterval();
@@ -155,7 +196,7 @@ private:
         }
 
     public:
-        ProfileTimer(uint32_t in = 1) : t(in) {}
+        ProfileTimer(ProfileEventSingleton& profile, uint32_t in = 1) : profile(profile), t(in) {}
 
         /** start timer on the thread th */
         void start() {
@@ -178,7 +219,7 @@ private:
         }
     };
 
-    ProfileTimer timer;
+    ProfileTimer timer{*this};
 };
 
 }  // namespace souffle
@@ -51,6 +51,8 @@ enum RamNodeType {
     RN_Project,
     RN_Lookup,
     RN_Scan,
+    RN_LeapfrogJoin,
+    RN_HashJoin,
     RN_Aggregate,
 
     // statements
@@ -66,6 +68,7 @@ enum RamNodeType {
     RN_Return,
 
     RN_Merge,
+    RN_Erase,
     RN_Swap,
 
     // control flow
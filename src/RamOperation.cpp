@@ -20,6 +20,7 @@
 #include "BinaryConstraintOps.h"
 #include "RamCondition.h"
 #include "RamRelation.h"
+#include "RamVisitor.h"
 #include <cstddef>
 #include <iostream>
 #include <memory>
@@ -75,6 +76,54 @@ std::unique_ptr<RamValue> getIndexElement(RamCondition* c, size_t& element, size
     }
     return std::unique_ptr<RamValue>(nullptr);
 }
+
+/** check whether a value can be evaluated repeatedly without side-effects */
+bool isRepeatable(const RamValue& value) {
+    bool repeatable = true;
+    visitDepthFirst(value, [&](const RamAutoIncrement&) { repeatable = false; });
+    return repeatable;
+}
+
+/**
+ * get bound element of an inequality; the bound is a copy of the value since the
+ * inequality itself remains as a filter.
+ */
+std::unique_ptr<RamValue> getBoundElement(RamCondition* c, size_t& element, bool& isLower, size_t level) {
+    if (auto* binRelOp = dynamic_cast<RamBinaryRelation*>(c)) {
+        bool lessThan;
+        switch (binRelOp->getOperator()) {
+            case BinaryConstraintOp::LT:
+            case BinaryConstraintOp::LE:
+                lessThan = true;
+                break;
+            case BinaryConstraintOp::GT:
+            case BinaryConstraintOp::GE:
+                lessThan = false;
+                break;
+            default:
+                return std::unique_ptr<RamValue>(nullptr);
+        }
+        if (auto* lhs = dynamic_cast<RamElementAccess*>(binRelOp->getLHS())) {
+            RamValue* rhs = binRelOp->getRHS();
+            if (lhs->getLevel() == level && (rhs->isConstant() || rhs->getLevel() < level) &&
+                    isRepeatable(*rhs)) {
+                element = lhs->getElement();
+                isLower = !lessThan;
+                return std::unique_ptr<RamValue>(rhs->clone());
+            }
+        }
+        if (auto* rhs = dynamic_cast<RamElementAccess*>(binRelOp->getRHS())) {
+            RamValue* lhs = binRelOp->getLHS();
+            if (rhs->getLevel() == level && (lhs->isConstant() || lhs->getLevel() < level) &&
+                    isRepeatable(*lhs)) {
+                element = rhs->getElement();
+                isLower = lessThan;
+                return std::unique_ptr<RamValue>(lhs->clone());
+            }
+        }
+    }
+    return std::unique_ptr<RamValue>(nullptr);
+}
 }  // namespace
 
 /** add condition */
@@ -94,6 +143,16 @@ void RamScan::addCondition(std::unique_ptr<RamCondition> c, const RamOperation&
             }
             return;
         }
+
+        // use inequalities as bounds of the index range; strict inequalities are
+        // bounded inclusively and the inequality is kept as a filter
+        bool isLower = false;
+        if (std::unique_ptr<RamValue> value = getBoundElement(c.get(), element, isLower, level)) {
+            auto& bound = isLower ? lowerBounds[element] : upperBounds[element];
+            if (bound == nullptr) {
+                bound = std::move(value);
+            }
+        }
     }
 
     // otherwise: use default handling
@@ -122,7 +181,8 @@ void RamScan::print(std::ostream& os, int tabpos) const {
             }
         }
     } else {
-        if (keys == 0) {
+        int rangeColumn = getRangeColumn();
+        if (keys == 0 && rangeColumn < 0) {
             os << "SCAN " << relation->getName() << " AS t" << level << " ";
         } else {
             // Keys indicates index search?
@@ -141,6 +201,24 @@ void RamScan::print(std::ostream& os, int tabpos) const {
                     os << " ";
                 }
             }
+            if (rangeColumn >= 0) {
+                if (!first) {
+                    os << "and ";
+                }
+                os << "t" << level << "." << relation->getArg(rangeColumn) << " IN [";
+                if (lowerBounds[rangeColumn] != nullptr) {
+                    lowerBounds[rangeColumn]->print(os);
+                } else {
+                    os << "-inf";
+                }
+                os << ",";
+                if (upperBounds[rangeColumn] != nullptr) {
+                    upperBounds[rangeColumn]->print(os);
+                } else {
+                    os << "inf";
+                }
+                os << "] ";
+            }
         }
     }
     if (auto condition = getCondition()) {
@@ -154,6 +232,94 @@ void RamScan::print(std::ostream& os, int tabpos) const {
     }
 }
 
+/*
+ * Class LeapfrogJoin
+ */
+
+/** add condition */
+void RamLeapfrogJoin::addCondition(std::unique_ptr<RamCondition> c, const RamOperation& root) {
+    // conditions on any of the joined relations are checked once all of them are bound
+    if (c->getLevel() > level) {
+        getNestedOperation()->addCondition(std::move(c), root);
+        return;
+    }
+
+    if (condition) {
+        condition = std::make_unique<RamAnd>(std::move(condition), std::move(c));
+    } else {
+        condition.swap(c);
+    }
+}
+
+/** print leapfrog join */
+void RamLeapfrogJoin::print(std::ostream& os, int tabpos) const {
+    os << times('\t', tabpos);
+
+    os << "JOIN ";
+    size_t baseLevel = getBaseLevel();
+    for (size_t i = 0; i < relations.size(); i++) {
+        if (i > 0) {
+            os << ", ";
+        }
+        os << relations[i]->getName() << " AS t" << baseLevel + i << " ON (";
+        os << join(variables[i], ",", [](std::ostream& out, size_t var) { out << "v" << var; });
+        os << ")";
+    }
+    os << " ";
+
+    if (auto condition = getCondition()) {
+        os << "WHERE ";
+        condition->print(os);
+    }
+
+    os << "\n";
+    getNestedOperation()->print(os, tabpos + 1);
+}
+
+/*
+ * Class HashJoin
+ */
+
+/** add condition */
+void RamHashJoin::addCondition(std::unique_ptr<RamCondition> c, const RamOperation& root) {
+    // conditions on any of the joined relations are checked once both are bound
+    if (c->getLevel() > level) {
+        getNestedOperation()->addCondition(std::move(c), root);
+        return;
+    }
+
+    if (condition) {
+        condition = std::make_unique<RamAnd>(std::move(condition), std::move(c));
+    } else {
+        condition.swap(c);
+    }
+}
+
+/** print hash join */
+void RamHashJoin::print(std::ostream& os, int tabpos) const {
+    os << times('\t', tabpos);
+
+    size_t leftLevel = getLeftLevel();
+    os << "HASH JOIN " << left->getName() << " AS t" << leftLevel << ", " << right->getName() << " AS t"
+       << level << " ON ";
+    for (size_t i = 0; i < leftKeys.size(); i++) {
+        if (i > 0) {
+            os << " and ";
+        }
+        os << "t" << leftLevel << "." << left->getArg(leftKeys[i]) << "=t" << level << "."
+           << right->getArg(rightKeys[i]);
+    }
+    os << " ";
+
+    if (auto condition = getCondition()) {
+        os << "WHERE ";
+        condition->print(os);
+    }
+
+    os << "\n";
+    getNestedOperation()->print(os, tabpos + 1);
+}
+
 /*
  * Class Lookup
  */
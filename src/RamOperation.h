@@ -23,6 +23,7 @@
 #include "RamTypes.h"
 #include "RamValue.h"
 #include "Util.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <iosfwd>
@@ -190,6 +191,12 @@ protected:
     /** Indexable columns for a range query */
     SearchColumns keys;
 
+    /** Inclusive lower bounds per column derived from inequality constraints (nullptr if unbounded) */
+    std::vector<std::unique_ptr<RamValue>> lowerBounds;
+
+    /** Inclusive upper bounds per column derived from inequality constraints (nullptr if unbounded) */
+    std::vector<std::unique_ptr<RamValue>> upperBounds;
+
     /**
      * Determines whether this scan operation is merely verifying the existence
      * of a value (e.g. rel(_,_), rel(1,2), rel(1,_) or rel(X,Y) where X and Y are bound)
@@ -203,7 +210,8 @@ public:
     RamScan(std::unique_ptr<RamRelation> r, std::unique_ptr<RamOperation> nested, bool pureExistenceCheck,
             std::string profileText = "")
             : RamSearch(RN_Scan, std::move(nested), std::move(profileText)), relation(std::move(r)),
-              queryPattern(relation->getArity()), keys(0), pureExistenceCheck(pureExistenceCheck) {}
+              queryPattern(relation->getArity()), keys(0), lowerBounds(relation->getArity()),
+              upperBounds(relation->getArity()), pureExistenceCheck(pureExistenceCheck) {}
 
     /** Get search relation */
     const RamRelation& getRelation() const {
@@ -220,6 +228,34 @@ public:
         return toPtrVector(queryPattern);
     }
 
+    /** Get lower bounds of columns */
+    std::vector<RamValue*> getLowerBounds() const {
+        return toPtrVector(lowerBounds);
+    }
+
+    /** Get upper bounds of columns */
+    std::vector<RamValue*> getUpperBounds() const {
+        return toPtrVector(upperBounds);
+    }
+
+    /**
+     * Get the column whose bounds narrow the index range of this scan, or -1 if
+     * there is none. The column is placed right after the indexable columns in
+     * the index order. An unrestricted outermost scan remains a full scan since
+     * it is partitioned for parallel evaluation.
+     */
+    int getRangeColumn() const {
+        if (pureExistenceCheck || (keys == 0 && level == 0)) {
+            return -1;
+        }
+        for (size_t i = 0; i < lowerBounds.size(); i++) {
+            if (!(keys & (1 << i)) && (lowerBounds[i] || upperBounds[i])) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
     /** Check for pure existence check */
     // TODO (#541): rename pure existence check to complete/whole etc.
     bool isPureExistenceCheck() const {
@@ -240,6 +276,14 @@ public:
                 res.push_back(cur.get());
             }
         }
+        for (size_t i = 0; i < lowerBounds.size(); i++) {
+            if (lowerBounds[i]) {
+                res.push_back(lowerBounds[i].get());
+            }
+            if (upperBounds[i]) {
+                res.push_back(upperBounds[i].get());
+            }
+        }
         return res;
     }
 
@@ -254,6 +298,14 @@ public:
                 res->queryPattern.push_back(std::unique_ptr<RamValue>(cur->clone()));
             }
         }
+        for (size_t i = 0; i < lowerBounds.size(); i++) {
+            if (lowerBounds[i]) {
+                res->lowerBounds[i] = std::unique_ptr<RamValue>(lowerBounds[i]->clone());
+            }
+            if (upperBounds[i]) {
+                res->upperBounds[i] = std::unique_ptr<RamValue>(upperBounds[i]->clone());
+            }
+        }
         return res;
     }
 
@@ -265,6 +317,14 @@ public:
                 cur = map(std::move(cur));
             }
         }
+        for (size_t i = 0; i < lowerBounds.size(); i++) {
+            if (lowerBounds[i]) {
+                lowerBounds[i] = map(std::move(lowerBounds[i]));
+            }
+            if (upperBounds[i]) {
+                upperBounds[i] = map(std::move(upperBounds[i]));
+            }
+        }
     }
 
 protected:
@@ -274,8 +334,228 @@ protected:
         const auto& other = static_cast<const RamScan&>(node);
         return RamSearch::equal(other) && getRelation() == other.getRelation() &&
                equal_targets(queryPattern, other.queryPattern) && keys == other.keys &&
+               souffle::equal(lowerBounds, other.lowerBounds, equalBound) &&
+               souffle::equal(upperBounds, other.upperBounds, equalBound) &&
                pureExistenceCheck == other.pureExistenceCheck;
     }
+
+    /** Check equality of two optional bounds */
+    static bool equalBound(const std::unique_ptr<RamValue>& a, const std::unique_ptr<RamValue>& b) {
+        if (a == nullptr || b == nullptr) {
+            return a == b;
+        }
+        return *a == *b;
+    }
+};
+
+/**
+ * Leapfrog Triejoin
+ *
+ * Joins several relations by intersecting their tuples variable by
+ * variable (a worst-case optimal join). Each column of a joined relation
+ * binds one of the join variables; the columns of a relation are visited
+ * in the order of their variables. The tuples of the joined relations are
+ * bound to consecutive levels, the last relation to the level of this
+ * operation.
+ */
+class RamLeapfrogJoin : public RamSearch {
+protected:
+    /** Joined relations */
+    std::vector<std::unique_ptr<RamRelation>> relations;
+
+    /** Join variable bound by each column of the joined relations */
+    std::vector<std::vector<size_t>> variables;
+
+public:
+    RamLeapfrogJoin(std::vector<std::unique_ptr<RamRelation>> rels, std::vector<std::vector<size_t>> vars,
+            std::unique_ptr<RamOperation> nested, std::string profileText = "")
+            : RamSearch(RN_LeapfrogJoin, std::move(nested), std::move(profileText)),
+              relations(std::move(rels)), variables(std::move(vars)) {
+        assert(!relations.empty() && relations.size() == variables.size());
+        assert(relations.size() <= level + 1);
+    }
+
+    /** Get joined relations */
+    std::vector<RamRelation*> getRelations() const {
+        return toPtrVector(relations);
+    }
+
+    /** Get join variables bound by the columns of a joined relation */
+    const std::vector<size_t>& getVariables(size_t rel) const {
+        return variables[rel];
+    }
+
+    /** Get number of join variables */
+    size_t getNumVariables() const {
+        size_t res = 0;
+        for (const auto& cur : variables) {
+            for (size_t var : cur) {
+                res = std::max(res, var + 1);
+            }
+        }
+        return res;
+    }
+
+    /** Get level of the first joined relation */
+    size_t getBaseLevel() const {
+        return level + 1 - relations.size();
+    }
+
+    /** Get column of a joined relation binding a variable, or -1 if the relation does not cover it */
+    int getColumn(size_t rel, size_t var) const {
+        for (size_t i = 0; i < variables[rel].size(); i++) {
+            if (variables[rel][i] == var) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /** Get the order of columns of a joined relation in which its variables are bound */
+    std::vector<int> getOrder(size_t rel) const {
+        std::vector<int> order;
+        for (size_t var = 0; var < getNumVariables(); var++) {
+            int column = getColumn(rel, var);
+            if (column >= 0) {
+                order.push_back(column);
+            }
+        }
+        return order;
+    }
+
+    /** Add condition */
+    void addCondition(std::unique_ptr<RamCondition> c, const RamOperation& root) override;
+
+    /** Get depth of query */
+    size_t getDepth() const override {
+        return relations.size() + getOperation().getDepth();
+    }
+
+    /** Apply mapper */
+    void apply(const RamNodeMapper& map) override {
+        RamSearch::apply(map);
+        for (auto& cur : relations) {
+            cur = map(std::move(cur));
+        }
+    }
+
+    /** Print */
+    void print(std::ostream& os, int tabpos) const override;
+
+    /** Create clone */
+    RamLeapfrogJoin* clone() const override {
+        std::vector<std::unique_ptr<RamRelation>> rels;
+        for (const auto& cur : relations) {
+            rels.push_back(std::unique_ptr<RamRelation>(cur->clone()));
+        }
+        auto* res = new RamLeapfrogJoin(std::move(rels), variables,
+                std::unique_ptr<RamOperation>(getNestedOperation()->clone()), getProfileText());
+        if (condition) {
+            res->condition = std::unique_ptr<RamCondition>(condition->clone());
+        }
+        return res;
+    }
+
+protected:
+    /** Check equality */
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamLeapfrogJoin*>(&node));
+        const auto& other = static_cast<const RamLeapfrogJoin&>(node);
+        return RamSearch::equal(other) && equal_targets(relations, other.relations) &&
+               variables == other.variables;
+    }
+};
+
+/**
+ * Hash join of two relations on equal columns, binding the tuples of both
+ * relations on two consecutive levels. A transient hash table is built on
+ * the smaller relation and probed by a scan of the larger one.
+ */
+class RamHashJoin : public RamSearch {
+protected:
+    /** Relation bound on the first level */
+    std::unique_ptr<RamRelation> left;
+
+    /** Relation bound on the second level */
+    std::unique_ptr<RamRelation> right;
+
+    /** Join columns of the first relation */
+    std::vector<size_t> leftKeys;
+
+    /** Join columns of the second relation, pairwise equal to the join columns of the first */
+    std::vector<size_t> rightKeys;
+
+public:
+    RamHashJoin(std::unique_ptr<RamRelation> l, std::unique_ptr<RamRelation> r, std::vector<size_t> lKeys,
+            std::vector<size_t> rKeys, std::unique_ptr<RamOperation> nested, std::string profileText = "")
+            : RamSearch(RN_HashJoin, std::move(nested), std::move(profileText)), left(std::move(l)),
+              right(std::move(r)), leftKeys(std::move(lKeys)), rightKeys(std::move(rKeys)) {
+        assert(!leftKeys.empty() && leftKeys.size() == rightKeys.size());
+        assert(level >= 1);
+    }
+
+    /** Get relation bound on the first level */
+    const RamRelation& getLeftRelation() const {
+        return *left;
+    }
+
+    /** Get relation bound on the second level */
+    const RamRelation& getRightRelation() const {
+        return *right;
+    }
+
+    /** Get join columns of the first relation */
+    const std::vector<size_t>& getLeftKeys() const {
+        return leftKeys;
+    }
+
+    /** Get join columns of the second relation */
+    const std::vector<size_t>& getRightKeys() const {
+        return rightKeys;
+    }
+
+    /** Get level of the first relation */
+    size_t getLeftLevel() const {
+        return level - 1;
+    }
+
+    /** Add condition */
+    void addCondition(std::unique_ptr<RamCondition> c, const RamOperation& root) override;
+
+    /** Get depth of query */
+    size_t getDepth() const override {
+        return 2 + getOperation().getDepth();
+    }
+
+    /** Apply mapper */
+    void apply(const RamNodeMapper& map) override {
+        RamSearch::apply(map);
+        left = map(std::move(left));
+        right = map(std::move(right));
+    }
+
+    /** Print */
+    void print(std::ostream& os, int tabpos) const override;
+
+    /** Create clone */
+    RamHashJoin* clone() const override {
+        auto* res = new RamHashJoin(std::unique_ptr<RamRelation>(left->clone()),
+                std::unique_ptr<RamRelation>(right->clone()), leftKeys, rightKeys,
+                std::unique_ptr<RamOperation>(getNestedOperation()->clone()), getProfileText());
+        if (condition) {
+            res->condition = std::unique_ptr<RamCondition>(condition->clone());
+        }
+        return res;
+    }
+
+protected:
+    /** Check equality */
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamHashJoin*>(&node));
+        const auto& other = static_cast<const RamHashJoin&>(node);
+        return RamSearch::equal(other) && *left == *other.left && *right == *other.right &&
+               leftKeys == other.leftKeys && rightKeys == other.rightKeys;
+    }
 };
 
 /**
@@ -60,11 +60,14 @@ protected:
     bool output = false;    // output relation
     bool computed = false;  // either output or printed
 
-    bool btree = false;    // btree data-structure
-    bool rbtset = false;   // red-black tree set data structure
-    bool hashset = false;  // hash set data-structure
-    bool brie = false;     // brie data-structure
-    bool eqrel = false;    // equivalence relation
+    bool btree = false;       // btree data-structure
+    bool rbtset = false;      // red-black tree set data structure
+    bool hashset = false;     // hash set data-structure
+    bool brie = false;        // brie data-structure
+    bool eqrel = false;       // equivalence relation
+    bool columnar = false;    // column-wise data-structure
+    bool compressed = false;  // btree data-structure with compressed leaves
+    bool spill = false;       // btree data-structure spilling to disk
 
     bool istemp = false;  // Temporary relation for semi-naive evaluation
 
@@ -81,12 +84,14 @@ public:
             std::vector<std::string> attributeTypeQualifiers = {}, SymbolMask mask = SymbolMask(0),
             const bool input = false, const bool computed = false, const bool output = false,
             const bool btree = false, const bool rbtset = false, const bool hashset = false,
-            const bool brie = false, const bool eqrel = false, const bool istemp = false)
+            const bool brie = false, const bool eqrel = false, const bool columnar = false,
+            const bool compressed = false, const bool spill = false, const bool istemp = false)
             : RamNode(RN_Relation), name(std::move(name)), arity(arity),
               attributeNames(std::move(attributeNames)),
               attributeTypeQualifiers(std::move(attributeTypeQualifiers)), mask(std::move(mask)),
               input(input), output(output), computed(computed), btree(btree), rbtset(rbtset),
-              hashset(hashset), brie(brie), eqrel(eqrel), istemp(istemp) {
+              hashset(hashset), brie(brie), eqrel(eqrel), columnar(columnar), compressed(compressed),
+              spill(spill), istemp(istemp) {
         assert(this->attributeNames.size() == arity || this->attributeNames.empty());
         assert(this->attributeTypeQualifiers.size() == arity || this->attributeTypeQualifiers.empty());
     }
@@ -145,6 +150,18 @@ public:
         return eqrel;
     }
 
+    const bool isColumnar() const {
+        return columnar;
+    }
+
+    const bool isCompressed() const {
+        return compressed;
+    }
+
+    const bool isSpill() const {
+        return spill;
+    }
+
     // data-structures that can server various searches
     const bool isCoverable() const {
         return !isHashset();
@@ -177,6 +194,9 @@ public:
         if (isHashset()) out << " hashset";
         if (isBrie()) out << " brie";
         if (isEqRel()) out << " eqrel";
+        if (isColumnar()) out << " columnar";
+        if (isCompressed()) out << " compressed";
+        if (isSpill()) out << " spill";
     }
 
     /** Obtain list of child nodes */
@@ -186,8 +206,9 @@ public:
 
     /** Create clone */
     RamRelation* clone() const override {
-        RamRelation* res = new RamRelation(name, arity, attributeNames, attributeTypeQualifiers, mask, input,
-                computed, output, btree, rbtset, hashset, brie, eqrel, istemp);
+        RamRelation* res =
+                new RamRelation(name, arity, attributeNames, attributeTypeQualifiers, mask, input, computed,
+                        output, btree, rbtset, hashset, brie, eqrel, columnar, compressed, spill, istemp);
         return res;
     }
 
@@ -204,7 +225,9 @@ protected:
                isInput() == other.isInput() && isOutput() == other.isOutput() &&
                isComputed() == other.isComputed() && isBTree() == other.isBTree() &&
                isRbtset() == other.isRbtset() && isHashset() == other.isHashset() &&
-               isBrie() == other.isBrie() && isEqRel() == other.isEqRel() && isTemp() == other.isTemp();
+               isBrie() == other.isBrie() && isEqRel() == other.isEqRel() &&
+               isColumnar() == other.isColumnar() && isCompressed() == other.isCompressed() &&
+               isSpill() == other.isSpill() && isTemp() == other.isTemp();
     }
 };
 
@@ -111,6 +111,9 @@ public:
         if (getRelation().isHashset()) os << " hashset";
         if (getRelation().isBrie()) os << " brie";
         if (getRelation().isEqRel()) os << " eqrel";
+        if (getRelation().isColumnar()) os << " columnar";
+        if (getRelation().isCompressed()) os << " compressed";
+        if (getRelation().isSpill()) os << " spill";
     };
 
     /** Create clone */
@@ -281,6 +284,64 @@ protected:
     }
 };
 
+/**
+ * Erase the tuples of a source relation from a target relation
+ */
+class RamErase : public RamStatement {
+protected:
+    std::unique_ptr<RamRelation> target;
+    std::unique_ptr<RamRelation> source;
+
+public:
+    RamErase(std::unique_ptr<RamRelation> t, std::unique_ptr<RamRelation> s)
+            : RamStatement(RN_Erase), target(std::move(t)), source(std::move(s)) {
+        assert(source->getArity() == target->getArity());
+    }
+
+    /** Get source relation */
+    const RamRelation& getSourceRelation() const {
+        return *source;
+    }
+
+    /** Get target relation */
+    const RamRelation& getTargetRelation() const {
+        return *target;
+    }
+
+    /** Pretty print */
+    void print(std::ostream& os, int tabpos) const override {
+        os << std::string(tabpos, '\t');
+        os << "ERASE " << target->getName() << " WITH " << source->getName();
+    }
+
+    /** Obtain list of child nodes */
+    std::vector<const RamNode*> getChildNodes() const override {
+        return std::vector<const RamNode*>({source.get(), target.get()});
+    }
+
+    /** Create clone */
+    RamErase* clone() const override {
+        RamErase* res = new RamErase(
+                std::unique_ptr<RamRelation>(target->clone()), std::unique_ptr<RamRelation>(source->clone()));
+        return res;
+    }
+
+    /** Apply mapper */
+    void apply(const RamNodeMapper& map) override {
+        source = map(std::move(source));
+        target = map(std::move(target));
+    }
+
+protected:
+    /** Check equality */
+    bool equal(const RamNode& node) const override {
+        assert(nullptr != dynamic_cast<const RamErase*>(&node));
+        const auto& other = static_cast<const RamErase&>(node);
+        return getTargetRelation() == other.getTargetRelation() &&
+               getSourceRelation() == other.getSourceRelation();
+    }
+};
+
 /**
  * Swap operation two relations
  */
@@ -99,6 +99,8 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(Return);
             FORWARD(Lookup);
             FORWARD(Scan);
+            FORWARD(LeapfrogJoin);
+            FORWARD(HashJoin);
             FORWARD(Aggregate);
 
             // statements
@@ -113,6 +115,7 @@ struct RamVisitor : public ram_visitor_tag {
             FORWARD(LogSize);
 
             FORWARD(Merge);
+            FORWARD(Erase);
             FORWARD(Swap);
 
             // control flow
@@ -159,6 +162,7 @@ protected:
     LINK(RelationStatement, Statement);
 
     LINK(Merge, Statement);
+    LINK(Erase, Statement);
     LINK(Swap, Statement);
 
     LINK(Sequence, Statement);
@@ -175,6 +179,8 @@ protected:
     LINK(Project, Operation)
     LINK(Lookup, Search)
     LINK(Scan, Search)
+    LINK(LeapfrogJoin, Search)
+    LINK(HashJoin, Search)
     LINK(Aggregate, Search)
     LINK(Search, Operation)
     LINK(Return, Operation);
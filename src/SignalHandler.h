@@ -29,14 +29,23 @@ namespace souffle {
  * Class SignalHandler captures signals
  * and reports the context where the signal occurs.
  * The signal handler is implemented as a singleton.
+ *
+ * Programs evaluated concurrently on separate threads share the handlers,
+ * which stay registered while any of them runs. The context is kept per
+ * thread, such that each program reports its own rule; threads without a
+ * context of their own, like the workers of a parallel loop, report the
+ * context set last by any thread.
  */
 class SignalHandler {
 private:
     // signal context information
     std::atomic<const char*> msg;
 
-    // state of signal handler
-    bool isSet = false;
+    // number of evaluations requiring the signal handlers
+    int activations = 0;
+
+    // lock protecting the registration of the signal handlers
+    std::mutex activationLock;
 
     bool logMessages = false;
 
@@ -49,7 +58,7 @@ private:
      * Signal handler for various types of signals.
      */
     static void handler(int signal) {
-        const char* msg = instance()->msg;
+        const char* msg = instance()->getMsg();
         std::string error;
         switch (signal) {
             case SIGINT:
@@ -75,6 +84,18 @@ private:
 
     SignalHandler() : msg(nullptr) {}
 
+    // signal context information of the calling thread
+    static const char*& threadMsg() {
+        static thread_local const char* msg = nullptr;
+        return msg;
+    }
+
+    // get the signal context of the calling thread, or else of the process
+    const char* getMsg() const {
+        const char* res = threadMsg();
+        return (res != nullptr) ? res : msg.load();
+    }
+
 public:
     // get singleton
     static SignalHandler* instance() {
@@ -103,6 +124,7 @@ public:
             std::lock_guard<std::mutex> guard(outputMutex);
             std::cout << "Starting work on " << outputMessage << std::endl;
         }
+        threadMsg() = m;
         msg = m;
     }
 
@@ -110,7 +132,8 @@ public:
      * set signal handlers
      */
     void set() {
-        if (!isSet) {
+        std::lock_guard<std::mutex> guard(activationLock);
+        if (activations++ == 0) {
             // register signals
             // floating point exception
             if ((prevFpeHandler = signal(SIGFPE, handler)) == SIG_ERR) {
@@ -127,7 +150,6 @@ public:
                 perror("Failed to set SIGSEGV signal handler.");
                 exit(1);
             }
-            isSet = true;
         }
     }
 
@@ -135,7 +157,9 @@ public:
      * reset signal handlers
      */
     void reset() {
-        if (isSet) {
+        threadMsg() = nullptr;
+        std::lock_guard<std::mutex> guard(activationLock);
+        if (activations > 0 && --activations == 0) {
             // reset floating point exception
             if (signal(SIGFPE, prevFpeHandler) == SIG_ERR) {
                 perror("Failed to reset SIGFPE signal handler.");
@@ -151,7 +175,6 @@ public:
                 perror("Failed to reset SIGSEGV signal handler.");
                 exit(1);
             }
-            isSet = false;
         }
     }
 
@@ -160,8 +183,9 @@ public:
      */
 
     void error(const std::string& error) {
-        if (msg != nullptr) {
-            std::cerr << error << " in rule:\n" << msg << std::endl;
+        const char* context = getMsg();
+        if (context != nullptr) {
+            std::cerr << error << " in rule:\n" << context << std::endl;
         } else {
             std::cerr << error << std::endl;
         }
@@ -19,9 +19,12 @@
 #include "RamTypes.h"
 #include "SymbolTable.h"
 
+#include <algorithm>
 #include <initializer_list>
 #include <iostream>
 #include <map>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -96,12 +99,63 @@ public:
         }
     };
 
+    // range of tuples obtained by a query
+    class iterator_range {
+        iterator first;
+        iterator last;
+
+    public:
+        iterator_range(iterator first, iterator last) : first(std::move(first)), last(std::move(last)) {}
+        iterator begin() const {
+            return first;
+        }
+        iterator end() const {
+            return last;
+        }
+    };
+
     // insert a new tuple into the relation
     virtual void insert(const tuple& t) = 0;
 
     // check whether a tuple exists in the relation
     virtual bool contains(const tuple& t) const = 0;
 
+    // erase a tuple from the relation, returning whether it existed, throwing an exception if the
+    // relation does not support this
+    virtual bool erase(const tuple& t);
+
+    // remove all tuples from the relation, throwing an exception if the relation does not support this
+    virtual void purge();
+
+    // insert the given number of tuples, stored one after another in the given array
+    virtual void insertAll(const RamDomain* rows, size_t count);
+
+    // insert the given number of tuples, given by an array of values per attribute
+    virtual void insertColumns(const RamDomain* const* columns, size_t count) {
+        // transpose the columns in chunks fitting into the cache
+        const size_t arity = getArity();
+        const size_t chunk = (arity == 0) ? count : std::max<size_t>(1, 4096 / arity);
+        std::vector<RamDomain> rows(std::min(count, chunk) * arity);
+        for (size_t first = 0; first < count; first += chunk) {
+            size_t num = std::min(chunk, count - first);
+            for (size_t i = 0; i < num; i++) {
+                for (size_t j = 0; j < arity; j++) {
+                    rows[i * arity + j] = columns[j][first + i];
+                }
+            }
+            insertAll(rows.data(), num);
+        }
+    }
+
+    // copy up to the given number of tuples into the given array, one after another, returning their number
+    virtual size_t exportAll(RamDomain* rows, size_t capacity) const;
+
+    // copy up to the given number of tuples into the given arrays per attribute, returning their number
+    virtual size_t exportColumns(RamDomain* const* columns, size_t capacity) const;
+
+    // obtain the tuples agreeing with the given tuple on the given columns, served by an index covering them
+    virtual iterator_range equalRange(const tuple& pattern, SearchColumns columns) const = 0;
+
     // begin and end iterator
     virtual iterator begin() const = 0;
     virtual iterator end() const = 0;
@@ -230,6 +284,53 @@ public:
     }
 };
 
+// the bulk operations of relations default to inserting and iterating single tuples
+
+inline bool Relation::erase(const tuple&) {
+    throw std::logic_error("relation " + getName() + " does not support erasing tuples");
+}
+
+inline void Relation::purge() {
+    throw std::logic_error("relation " + getName() + " does not support purging");
+}
+
+inline void Relation::insertAll(const RamDomain* rows, size_t count) {
+    const size_t arity = getArity();
+    tuple t(this);
+    for (size_t i = 0; i < count; i++, rows += arity) {
+        for (size_t j = 0; j < arity; j++) {
+            t[j] = rows[j];
+        }
+        insert(t);
+    }
+}
+
+inline size_t Relation::exportAll(RamDomain* rows, size_t capacity) const {
+    const size_t arity = getArity();
+    size_t n = 0;
+    const iterator last = end();
+    for (auto it = begin(); n < capacity && it != last; ++it, ++n) {
+        const tuple& cur = *it;
+        for (size_t j = 0; j < arity; j++) {
+            rows[n * arity + j] = cur[j];
+        }
+    }
+    return n;
+}
+
+inline size_t Relation::exportColumns(RamDomain* const* columns, size_t capacity) const {
+    const size_t arity = getArity();
+    size_t n = 0;
+    const iterator last = end();
+    for (auto it = begin(); n < capacity && it != last; ++it, ++n) {
+        const tuple& cur = *it;
+        for (size_t j = 0; j < arity; j++) {
+            columns[j][n] = cur[j];
+        }
+    }
+    return n;
+}
+
 /**
  * Abstract base class for generated Datalog programs
  */
@@ -241,7 +342,109 @@ private:
     std::vector<Relation*> outputRelations;
     std::vector<Relation*> internalRelations;
 
+    // the relations a stratum depends on and the relations it computes, which are maintained from the
+    // changes of the relations it depends on if the stratum is maintained, or computed anew otherwise
+    struct Stratum {
+        std::set<std::string> dependencies;
+        std::set<std::string> computed;
+        bool maintained;
+    };
+
+    // the strata of the program
+    std::map<size_t, Stratum> strata;
+
+    // whether the program keeps its relations, supporting incremental updates
+    bool incremental = false;
+
+    // the strata skipped by runs, as the selected outputs do not depend on them
+    std::set<size_t> prunedStrata;
+
+    // the changes staged for each relation, applied in order by the next update; each change is stored as
+    // a flag whether the tuple is inserted rather than erased, followed by the values of the tuple
+    std::map<Relation*, std::vector<RamDomain>> staged;
+
+    // the relations modified directly since the last update, whose changes are unknown
+    std::set<Relation*> modified;
+
+    // the temporary relations kept for incremental updates, e.g. the tuples added to a relation by an update
+    std::map<std::string, Relation*> tempRelationMap;
+
+    // stage the insertion or erasure of a tuple of a relation
+    void stage(Relation* rel, const tuple& t, bool insert) {
+        auto& rows = staged[rel];
+        rows.push_back(insert ? 1 : 0);
+        for (size_t i = 0; i < t.size(); i++) {
+            rows.push_back(t[i]);
+        }
+    }
+
+    // get the temporary relation of the given kind kept for a relation, or null if there is none
+    Relation* getTempRelation(const std::string& kind, const std::string& name) const {
+        auto pos = tempRelationMap.find("@" + kind + "_" + name);
+        return (pos != tempRelationMap.end()) ? pos->second : nullptr;
+    }
+
+    // check whether the last update changed the relation of the given name
+    bool hasChanges(const std::string& name) const {
+        Relation* added = getTempRelation("added", name);
+        Relation* removed = getTempRelation("removed", name);
+        return (added && added->size() > 0) || (removed && removed->size() > 0);
+    }
+
+    // apply the staged changes of a relation, recording its net changes and returning whether there are any;
+    // input relations that also have rules only change their facts, from which their strata derive them
+    bool applyChanges(Relation* rel, const std::vector<RamDomain>& rows) {
+        const std::string& name = rel->getName();
+        Relation* facts = getTempRelation("facts", name);
+        Relation* target = facts ? facts : rel;
+        Relation* added = getTempRelation(facts ? "added_facts" : "added", name);
+        Relation* removed = getTempRelation(facts ? "removed_facts" : "removed", name);
+        assert(added && removed && "changes of relation not kept");
+        const size_t arity = rel->getArity();
+        tuple t(rel);
+        for (size_t i = 0; i < rows.size(); i += arity + 1) {
+            bool isInsert = rows[i] != 0;
+            for (size_t j = 0; j < arity; j++) {
+                t[j] = rows[i + 1 + j];
+            }
+            if (isInsert) {
+                if (!target->contains(t)) {
+                    target->insert(t);
+                    if (!removed->erase(t)) {
+                        added->insert(t);
+                    }
+                }
+            } else if (target->erase(t)) {
+                if (!added->erase(t)) {
+                    removed->insert(t);
+                }
+            }
+        }
+        return added->size() > 0 || removed->size() > 0;
+    }
+
 protected:
+    // add stratum of the given index, which is updated if a relation it depends on changes
+    void addStratum(size_t index, std::set<std::string> dependencies, std::set<std::string> computed,
+            bool maintained) {
+        strata[index] = Stratum{std::move(dependencies), std::move(computed), maintained};
+    }
+
+    // add a temporary relation kept for incremental updates
+    void addTempRelation(const std::string& name, Relation* rel) {
+        tempRelationMap[name] = rel;
+    }
+
+    // mark the program as keeping its relations, supporting incremental updates
+    void setIncremental() {
+        incremental = true;
+    }
+
+    // check whether the stratum of the given index is evaluated by runs
+    bool isStratumSelected(size_t index) const {
+        return prunedStrata.count(index) == 0;
+    }
+
     // add relation to relation map
     void addRelation(const std::string& name, Relation* rel, bool isInput, bool isOutput) {
         relationMap[name] = rel;
@@ -308,6 +511,126 @@ public:
         return allRelations;
     }
 
+    // check whether the program keeps its relations, supporting incremental updates
+    bool isIncremental() const {
+        return incremental;
+    }
+
+    /**
+     * Select the relations subsequent runs have to compute, such that strata the given
+     * relations do not transitively depend on are skipped. Relations computed by skipped
+     * strata remain empty. An empty selection evaluates all strata again. Returns false and
+     * keeps the previous selection if a name is not a relation of the program.
+     */
+    bool selectOutputs(const std::set<std::string>& names) {
+        for (const std::string& name : names) {
+            if (getRelation(name) == nullptr) {
+                return false;
+            }
+        }
+        prunedStrata.clear();
+        if (names.empty()) {
+            return true;
+        }
+        // visit the strata in reverse order of evaluation, collecting the required relations
+        std::set<std::string> required(names);
+        for (auto it = strata.rbegin(); it != strata.rend(); ++it) {
+            const Stratum& stratum = it->second;
+            bool isRequired = false;
+            for (const std::string& name : stratum.computed) {
+                if (required.count(name) > 0) {
+                    isRequired = true;
+                    break;
+                }
+            }
+            if (isRequired) {
+                required.insert(stratum.dependencies.begin(), stratum.dependencies.end());
+            } else {
+                prunedStrata.insert(it->first);
+            }
+        }
+        return true;
+    }
+
+    // stage the insertion of a tuple into a relation, applied by the next update
+    void stageInsert(Relation* rel, const tuple& t) {
+        stage(rel, t, true);
+    }
+
+    // stage the erasure of a tuple from a relation, applied by the next update
+    void stageErase(Relation* rel, const tuple& t) {
+        stage(rel, t, false);
+    }
+
+    // mark a relation as modified directly, e.g. by loading facts, such that the next update accounts for it
+    void markModified(Relation* rel) {
+        modified.insert(rel);
+    }
+
+    /**
+     * Apply the staged changes of input relations after the program has been run, and
+     * update the strata depending on changed relations in order. Updated strata start
+     * from the changes of the relations they depend on: tuples losing a derivation are
+     * deleted and derived again if they keep another one (DRed), and new tuples are
+     * derived semi-naively from the added tuples. Strata with aggregates, counters or
+     * equivalence relations, the strata of programs with provenance, and strata depending
+     * on relations modified directly, e.g. by loading facts, compute their relations
+     * anew instead. Input relations that also have rules keep their facts apart.
+     */
+    void update() {
+        assert(isIncremental() && "program does not keep its relations");
+        std::vector<RamDomain> args;
+        std::vector<RamDomain> ret;
+        std::vector<bool> err;
+
+        // discard the changes of the previous update
+        executeSubroutine("clear_changes", args, ret, err);
+
+        // apply the staged changes, noting the relations which changed and those modified directly
+        std::set<std::string> changed;
+        for (const auto& cur : staged) {
+            if (applyChanges(cur.first, cur.second)) {
+                changed.insert(cur.first->getName());
+            }
+        }
+        std::set<std::string> reloaded;
+        for (Relation* rel : modified) {
+            reloaded.insert(rel->getName());
+        }
+        staged.clear();
+        modified.clear();
+
+        // update the affected strata, whose relations may change in turn
+        for (const auto& cur : strata) {
+            const Stratum& stratum = cur.second;
+            bool affected = false;
+            bool recompute = !stratum.maintained;
+            auto check = [&](const std::string& name) {
+                affected = affected || changed.count(name) > 0 || reloaded.count(name) > 0;
+                recompute = recompute || reloaded.count(name) > 0;
+            };
+            for (const std::string& name : stratum.dependencies) {
+                check(name);
+            }
+            // the facts of input relations that also have rules are derived from as well
+            for (const std::string& name : stratum.computed) {
+                check(name);
+            }
+            if (!affected || !isStratumSelected(cur.first)) {
+                continue;
+            }
+            const std::string kind = recompute ? "recompute_" : "update_";
+            executeSubroutine(kind + std::to_string(cur.first), args, ret, err);
+            for (const std::string& name : stratum.computed) {
+                if (hasChanges(name)) {
+                    changed.insert(name);
+                } else {
+                    changed.erase(name);
+                }
+            }
+        }
+    }
+
     virtual void executeSubroutine(std::string name, const std::vector<RamDomain>& args,
             std::vector<RamDomain>& ret, std::vector<bool>& retErr) {}
     virtual const SymbolTable& getSymbolTable() const = 0;
@@ -0,0 +1,453 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SouffleServer.h
+ *
+ * Serves requests to a resident program over a Unix domain socket; works
+ * for compiler and interpreter
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "SouffleInterface.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * A server keeping a program and its relations resident, answering the requests
+ * of clients connected to a Unix domain socket one after another.
+ *
+ * Each request and each response is a frame of a 32-bit length in network byte
+ * order followed by that many bytes of text. A request is a single command, a
+ * response starts with a line of either "ok" or "error: <message>", followed by
+ * the lines of the answer, if any. Tuples are written as their attributes
+ * separated by tabs. The following commands are understood:
+ *
+ *   load [<dir>]              read the facts of input relations and update
+ *   insert <rel>(<v>, ...)    stage the insertion of a tuple
+ *   erase <rel>(<v>, ...)     stage the erasure of a tuple
+ *   run                       apply the staged changes and update
+ *   query <rel>(<v|_>, ...)   list the tuples matching the given values
+ *   size <rel>                print the number of tuples of a relation
+ *   relations                 list the relations and their signatures
+ *   shutdown                  stop the server
+ *
+ * Values are numbers or strings enclosed in quotation marks, and _ matches any
+ * value. Updates require the program to keep its relations, see --incremental.
+ *
+ * Only the owner of the server may connect to the socket. A request exceeding
+ * MAX_FRAME_SIZE bytes is answered by an error, after which the connection is
+ * closed.
+ */
+class SouffleServer {
+private:
+    // the upper bound on the size of a request
+    static constexpr uint32_t MAX_FRAME_SIZE = 64 << 20;
+
+    /** resident program */
+    SouffleProgram& prog;
+
+    /** path of the socket */
+    std::string path;
+
+    /** directory of fact files loaded by default */
+    std::string inputDirectory;
+
+    /** listening socket */
+    int listener = -1;
+
+    /** flag for the socket file having been created by this server */
+    bool bound = false;
+
+    /** flag for stopping the server */
+    bool running = true;
+
+    // outcome of receiving a frame
+    enum class Frame { Received, Closed, Oversized };
+
+    // argument of a command denoting a tuple, with its values and whether they are bound
+    struct Atom {
+        Relation* rel = nullptr;
+        std::vector<std::string> values;
+        std::vector<bool> bound;
+    };
+
+    // throw an exception for the failed system call of the given name
+    [[noreturn]] static void fail(const std::string& call) {
+        throw std::runtime_error(call + ": " + std::strerror(errno));
+    }
+
+    // read the given number of bytes, returning false at the end of the stream
+    static bool readFully(int fd, char* buf, size_t size) {
+        while (size > 0) {
+            ssize_t res = ::read(fd, buf, size);
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res <= 0) {
+                return false;
+            }
+            buf += res;
+            size -= res;
+        }
+        return true;
+    }
+
+    // write the given number of bytes, returning false if the peer is gone
+    static bool writeFully(int fd, const char* buf, size_t size) {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        while (size > 0) {
+            ssize_t res = ::send(fd, buf, size, flags);
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res <= 0) {
+                return false;
+            }
+            buf += res;
+            size -= res;
+        }
+        return true;
+    }
+
+    // receive a frame, whose content is not read if it is oversized
+    static Frame receive(int fd, std::string& msg) {
+        uint32_t size;
+        if (!readFully(fd, reinterpret_cast<char*>(&size), sizeof(size))) {
+            return Frame::Closed;
+        }
+        size = ntohl(size);
+        if (size > MAX_FRAME_SIZE) {
+            return Frame::Oversized;
+        }
+        msg.resize(size);
+        return (size == 0 || readFully(fd, &msg[0], size)) ? Frame::Received : Frame::Closed;
+    }
+
+    // send a frame, returning false if the peer is gone
+    static bool send(int fd, const std::string& msg) {
+        uint32_t size = htonl(msg.size());
+        return writeFully(fd, reinterpret_cast<const char*>(&size), sizeof(size)) &&
+               writeFully(fd, msg.data(), msg.size());
+    }
+
+    // strip surrounding blanks
+    static std::string trim(const std::string& str) {
+        size_t first = str.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            return "";
+        }
+        size_t last = str.find_last_not_of(" \t\r\n");
+        return str.substr(first, last - first + 1);
+    }
+
+    // parse a number
+    static RamDomain parseNumber(const std::string& str) {
+        size_t pos = 0;
+        long long value = 0;
+        try {
+            value = std::stoll(str, &pos);
+        } catch (std::exception&) {
+            pos = 0;
+        }
+        if (pos == 0 || pos != str.size()) {
+            throw std::invalid_argument("invalid number " + str);
+        }
+        return static_cast<RamDomain>(value);
+    }
+
+    // obtain a relation by its name
+    Relation* getRelation(const std::string& name) const {
+        Relation* rel = prog.getRelation(name);
+        if (rel == nullptr) {
+            throw std::invalid_argument("unknown relation " + name);
+        }
+        return rel;
+    }
+
+    // parse a tuple of the form rel(v1, v2, ...), permitting unbound values if requested
+    Atom parseAtom(const std::string& str, bool wildcards) const {
+        Atom atom;
+        size_t open = str.find('(');
+        if (open == std::string::npos || str.back() != ')') {
+            throw std::invalid_argument("expected <relation>(<value>, ...)");
+        }
+        atom.rel = getRelation(trim(str.substr(0, open)));
+
+        // split the values, where strings may contain commas
+        std::string body = str.substr(open + 1, str.size() - open - 2);
+        std::vector<std::pair<std::string, bool>> args;
+        std::string cur;
+        bool quoted = false;
+        bool isString = false;
+        for (char c : body) {
+            if (c == '"') {
+                quoted = !quoted;
+                isString = true;
+            } else if (c == ',' && !quoted) {
+                args.emplace_back(isString ? cur : trim(cur), isString);
+                cur.clear();
+                isString = false;
+            } else if (quoted || !std::isspace(static_cast<unsigned char>(c))) {
+                cur += c;
+            }
+        }
+        if (quoted) {
+            throw std::invalid_argument("unterminated string");
+        }
+        if (!cur.empty() || isString || !args.empty()) {
+            args.emplace_back(cur, isString);
+        }
+        if (args.size() != atom.rel->getArity()) {
+            throw std::invalid_argument("relation " + atom.rel->getName() + " has arity " +
+                                        std::to_string(atom.rel->getArity()));
+        }
+
+        // check the values against the attribute types
+        for (size_t i = 0; i < args.size(); i++) {
+            bool bound = args[i].second || args[i].first != "_";
+            if (!bound && !wildcards) {
+                throw std::invalid_argument("tuple must not contain _");
+            }
+            if (bound && *atom.rel->getAttrType(i) != 's') {
+                if (args[i].second) {
+                    throw std::invalid_argument("attribute " + std::to_string(i) + " is a number");
+                }
+                parseNumber(args[i].first);
+            }
+            atom.values.push_back(args[i].first);
+            atom.bound.push_back(bound);
+        }
+        return atom;
+    }
+
+    // obtain the tuple of a fully bound atom, adding new symbols to the symbol table
+    static tuple makeTuple(const Atom& atom) {
+        tuple t(atom.rel);
+        for (size_t i = 0; i < atom.values.size(); i++) {
+            if (*atom.rel->getAttrType(i) == 's') {
+                t[i] = atom.rel->getSymbolTable().lookup(atom.values[i]);
+            } else {
+                t[i] = parseNumber(atom.values[i]);
+            }
+        }
+        return t;
+    }
+
+    // print a tuple with its attributes separated by tabs
+    static void printTuple(std::ostream& out, const Relation& rel, const tuple& t) {
+        for (size_t i = 0; i < t.size(); i++) {
+            if (i > 0) {
+                out << "\t";
+            }
+            if (*rel.getAttrType(i) == 's') {
+                out << rel.getSymbolTable().resolve(t[i]);
+            } else {
+                out << t[i];
+            }
+        }
+        out << "\n";
+    }
+
+    // answer a query via the indexes of the relation
+    void query(std::ostream& out, const Atom& atom) const {
+        Relation& rel = *atom.rel;
+        bool bound = true;
+        for (size_t i = 0; i < atom.values.size(); i++) {
+            // symbols unknown to the program cannot be matched
+            if (atom.bound[i] && *rel.getAttrType(i) == 's' &&
+                    !rel.getSymbolTable().contains(atom.values[i])) {
+                return;
+            }
+            bound = bound && atom.bound[i];
+        }
+        if (bound) {
+            tuple t = makeTuple(atom);
+            if (rel.contains(t)) {
+                printTuple(out, rel, t);
+            }
+            return;
+        }
+
+        // otherwise look up the tuples agreeing on the bound values
+        tuple pattern(&rel);
+        SearchColumns columns = 0;
+        for (size_t i = 0; i < atom.values.size(); i++) {
+            if (atom.bound[i]) {
+                pattern[i] = (*rel.getAttrType(i) == 's') ? rel.getSymbolTable().lookup(atom.values[i])
+                                                           : parseNumber(atom.values[i]);
+                columns |= SearchColumns(1) << i;
+            }
+        }
+        Relation::iterator_range res = rel.equalRange(pattern, columns);
+        for (auto it = res.begin(), end = res.end(); it != end; ++it) {
+            printTuple(out, rel, *it);
+        }
+    }
+
+    // check that the program keeps its relations for updates
+    void checkIncremental() const {
+        if (!prog.isIncremental()) {
+            throw std::invalid_argument("updates require a program compiled with --incremental");
+        }
+    }
+
+    // process a request, returning the response
+    std::string handle(const std::string& request) {
+        std::string line = trim(request);
+        size_t pos = line.find_first_of(" \t");
+        std::string command = line.substr(0, pos);
+        std::string arg = (pos == std::string::npos) ? "" : trim(line.substr(pos));
+
+        std::stringstream out;
+        try {
+            if (command == "load") {
+                checkIncremental();
+                prog.loadAll(arg.empty() ? inputDirectory : arg);
+                for (Relation* rel : prog.getInputRelations()) {
+                    prog.markModified(rel);
+                }
+                prog.update();
+            } else if (command == "insert") {
+                checkIncremental();
+                Atom atom = parseAtom(arg, false);
+                prog.stageInsert(atom.rel, makeTuple(atom));
+            } else if (command == "erase") {
+                checkIncremental();
+                Atom atom = parseAtom(arg, false);
+                prog.stageErase(atom.rel, makeTuple(atom));
+            } else if (command == "run") {
+                checkIncremental();
+                prog.update();
+            } else if (command == "query") {
+                query(out, parseAtom(arg, true));
+            } else if (command == "size") {
+                out << getRelation(arg)->size() << "\n";
+            } else if (command == "relations") {
+                for (Relation* rel : prog.getAllRelations()) {
+                    out << rel->getName() << "\t" << rel->getSignature() << "\n";
+                }
+            } else if (command == "shutdown") {
+                running = false;
+            } else {
+                throw std::invalid_argument("unknown command " + command);
+            }
+        } catch (std::exception& e) {
+            return std::string("error: ") + e.what() + "\n";
+        }
+        return "ok\n" + out.str();
+    }
+
+public:
+    SouffleServer(SouffleProgram& prog, std::string path, std::string inputDirectory = ".")
+            : prog(prog), path(std::move(path)), inputDirectory(std::move(inputDirectory)) {}
+
+    SouffleServer(const SouffleServer&) = delete;
+
+    SouffleServer& operator=(const SouffleServer&) = delete;
+
+    ~SouffleServer() {
+        if (listener >= 0) {
+            ::close(listener);
+        }
+        if (bound) {
+            ::unlink(path.c_str());
+        }
+    }
+
+    /** Accept connections and answer their requests until a shutdown is requested */
+    void serve() {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            throw std::invalid_argument("invalid socket path " + path);
+        }
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            fail("socket");
+        }
+        // replace the socket of a previous server, but no other file
+        struct stat info;
+        if (::lstat(path.c_str(), &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                throw std::invalid_argument(path + " exists and is not a socket");
+            }
+            ::unlink(path.c_str());
+        } else if (errno != ENOENT) {
+            fail("lstat");
+        }
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            fail("bind");
+        }
+        bound = true;
+
+        // only the owner may connect, which is settled before connections are accepted
+        if (::chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0) {
+            fail("chmod");
+        }
+        if (::listen(listener, SOMAXCONN) != 0) {
+            fail("listen");
+        }
+
+        std::string request;
+        while (running) {
+            int conn = ::accept(listener, nullptr, nullptr);
+            if (conn < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                fail("accept");
+            }
+            Frame frame = Frame::Closed;
+            while (running && (frame = receive(conn, request)) == Frame::Received) {
+                if (!send(conn, handle(request))) {
+                    break;
+                }
+            }
+            if (frame == Frame::Oversized) {
+                send(conn, "error: request exceeds " + std::to_string(MAX_FRAME_SIZE) + " bytes\n");
+            }
+            ::close(conn);
+        }
+    }
+};
+
+inline void serve(SouffleProgram& prog, const std::string& path, const std::string& inputDirectory = ".") {
+    std::cout << "Serving requests on " << path << "\n";
+    SouffleServer server(prog, path, inputDirectory);
+    server.serve();
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,391 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillStorage.h
+ *
+ * Storage for relations exceeding the available memory. Tuples are moved
+ * into memory-mapped files of a scratch directory, such that the operating
+ * system may page them out rather than the process being killed.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace souffle {
+
+class Spillable;
+
+/**
+ * The manager of the memory budget of all spillable data structures. Each data
+ * structure keeps its most recent tuples in memory and reports their size to
+ * the manager; once the total exceeds the budget, data structures move their
+ * tuples into files. Data structures holding many tuples per access are moved
+ * first, such that small or frequently probed relations stay in memory.
+ */
+class SpillManager {
+    // the budget for the memory of all spillable data structures, in bytes; zero if unlimited
+    std::atomic<std::size_t> budget;
+
+    // the total memory occupied by spillable data structures, in bytes
+    std::atomic<std::size_t> resident;
+
+    // the directory hosting spilled tuples
+    std::string directory;
+
+    // all registered data structures
+    std::vector<const Spillable*> clients;
+
+    // synchronizes accesses to the list of clients and the directory
+    mutable std::mutex lock;
+
+    SpillManager() : budget(0), resident(0) {
+        const char* tmp = std::getenv("TMPDIR");
+        directory = (tmp && *tmp) ? tmp : "/tmp";
+    }
+
+    friend class Spillable;
+
+public:
+    /** Obtains the manager of this process */
+    static SpillManager& instance() {
+        static SpillManager manager;
+        return manager;
+    }
+
+    /** Sets the budget in bytes, where zero disables spilling */
+    void setBudget(std::size_t bytes) {
+        budget = bytes;
+    }
+
+    std::size_t getBudget() const {
+        return budget;
+    }
+
+    /** Sets the directory hosting spilled tuples */
+    void setDirectory(const std::string& dir) {
+        std::lock_guard<std::mutex> guard(lock);
+        directory = dir;
+    }
+
+    std::string getDirectory() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return directory;
+    }
+
+    /** Obtains the memory occupied by spillable data structures, in bytes */
+    std::size_t getResidentSize() const {
+        return resident;
+    }
+
+    /**
+     * Determines whether the given data structure should move its tuples into a file.
+     * This is the case if the budget is exceeded and it holds at least half as many
+     * bytes per access as the top-ranked data structure. The relation being filled
+     * thus spills once it dominates, even if the top-ranked one is not touched again.
+     */
+    inline bool shouldSpill(const Spillable& client) const;
+
+    /**
+     * Creates an anonymous file of the given size within the spill directory, returning
+     * its descriptor. The file is unlinked immediately, such that it is reclaimed once
+     * closed and unmapped, or when the process terminates.
+     */
+    int createFile(std::size_t size) const {
+        std::string path = getDirectory() + "/souffle-spill-XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        int fd = mkstemp(name.data());
+        if (fd < 0) {
+            throw std::runtime_error(
+                    "Cannot create spill file in " + getDirectory() + ": " + std::string(strerror(errno)));
+        }
+        unlink(name.data());
+        if (size > 0 && ftruncate(fd, size) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot extend spill file: " + std::string(strerror(errno)));
+        }
+        return fd;
+    }
+};
+
+/**
+ * A data structure participating in the memory budget of the SpillManager.
+ */
+class Spillable {
+    // the bytes reported to the manager
+    std::atomic<std::size_t> resident;
+
+    // the number of lookups since tuples were last spilled
+    std::atomic<std::size_t> accesses;
+
+public:
+    Spillable() : resident(0), accesses(0) {
+        auto& manager = SpillManager::instance();
+        std::lock_guard<std::mutex> guard(manager.lock);
+        manager.clients.push_back(this);
+    }
+
+    Spillable(const Spillable&) = delete;
+
+    Spillable& operator=(const Spillable&) = delete;
+
+    virtual ~Spillable() {
+        auto& manager = SpillManager::instance();
+        manager.resident -= resident;
+        std::lock_guard<std::mutex> guard(manager.lock);
+        manager.clients.erase(std::find(manager.clients.begin(), manager.clients.end(), this));
+    }
+
+    /** Obtains the number of bytes kept in memory */
+    std::size_t getResidentSize() const {
+        return resident;
+    }
+
+    /** Obtains the bytes kept in memory per access, ranking candidates for spilling */
+    double getSpillScore() const {
+        return static_cast<double>(resident) / (1 + accesses);
+    }
+
+protected:
+    /** Records a lookup of the data structure */
+    void touch() {
+        accesses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Updates the number of bytes kept in memory */
+    void setResidentSize(std::size_t bytes) {
+        auto& manager = SpillManager::instance();
+        std::size_t old = resident.exchange(bytes);
+        manager.resident += bytes;
+        manager.resident -= old;
+    }
+
+    /** Resets the access statistics, after the tuples have been spilled */
+    void resetAccesses() {
+        accesses = 0;
+    }
+};
+
+inline bool SpillManager::shouldSpill(const Spillable& client) const {
+    std::size_t limit = budget;
+    if (limit == 0 || resident <= limit || client.getResidentSize() == 0) {
+        return false;
+    }
+    double top = 0;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (const Spillable* cur : clients) {
+            top = std::max(top, cur->getSpillScore());
+        }
+    }
+    return 2 * client.getSpillScore() >= top;
+}
+
+/**
+ * A sorted run of tuples of a fixed arity, written sequentially into a file of
+ * the spill directory and read through a read-only memory mapping.
+ */
+class MappedRun {
+    // the number of values buffered before being written
+    static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+    // the mapped values, null if empty
+    RamDomain* values = nullptr;
+
+    // the number of values of the run
+    std::size_t numValues = 0;
+
+    // the file written to, while the run is being written
+    int fd = -1;
+
+    // the values not yet written
+    std::vector<RamDomain> buffer;
+
+    void flush() {
+        const char* data = reinterpret_cast<const char*>(buffer.data());
+        std::size_t remaining = buffer.size() * sizeof(RamDomain);
+        while (remaining > 0) {
+            ssize_t written = ::write(fd, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Cannot write spill file: " + std::string(strerror(errno)));
+            }
+            data += written;
+            remaining -= written;
+        }
+        buffer.clear();
+    }
+
+public:
+    MappedRun() = default;
+
+    MappedRun(const MappedRun&) = delete;
+
+    MappedRun& operator=(const MappedRun&) = delete;
+
+    MappedRun(MappedRun&& other) {
+        swap(other);
+    }
+
+    MappedRun& operator=(MappedRun&& other) {
+        MappedRun tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    ~MappedRun() {
+        if (values) {
+            munmap(values, numValues * sizeof(RamDomain));
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    void swap(MappedRun& other) {
+        std::swap(values, other.values);
+        std::swap(numValues, other.numValues);
+        std::swap(fd, other.fd);
+        std::swap(buffer, other.buffer);
+    }
+
+    /** Starts writing this run, dropping its previous content */
+    void open() {
+        *this = MappedRun();
+        fd = SpillManager::instance().createFile(0);
+        buffer.reserve(BUFFER_SIZE);
+    }
+
+    /** Appends the given tuple, which must not precede the previous one */
+    void append(const RamDomain* tuple, std::size_t arity) {
+        buffer.insert(buffer.end(), tuple, tuple + arity);
+        numValues += arity;
+        if (buffer.size() >= BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    /** Completes writing this run, making its tuples accessible */
+    void seal() {
+        flush();
+        if (numValues > 0) {
+            void* res = mmap(nullptr, numValues * sizeof(RamDomain), PROT_READ, MAP_SHARED, fd, 0);
+            if (res == MAP_FAILED) {
+                throw std::runtime_error("Cannot map spill file: " + std::string(strerror(errno)));
+            }
+            values = static_cast<RamDomain*>(res);
+        }
+        close(fd);
+        fd = -1;
+        std::vector<RamDomain>().swap(buffer);
+    }
+
+    bool empty() const {
+        return numValues == 0;
+    }
+
+    /** Obtains the first value of the first tuple */
+    const RamDomain* begin() const {
+        return values;
+    }
+
+    /** Obtains the end of the values of this run */
+    const RamDomain* end() const {
+        return values + numValues;
+    }
+};
+
+/**
+ * An allocator for blocks of tuples backed by files of the spill directory. The
+ * memory is mapped shared, such that the operating system writes it to the
+ * file rather than to swap when it is short of memory. Blocks are released all
+ * at once.
+ */
+class MappedArena {
+    // the size of each mapped segment
+    static constexpr std::size_t SEGMENT_SIZE = 64 << 20;
+
+    // the mapped segments
+    std::vector<char*> segments;
+
+    // the number of bytes handed out from the last segment
+    std::size_t used = SEGMENT_SIZE;
+
+    // the segment utilized for new blocks
+    std::size_t current = 0;
+
+public:
+    MappedArena() = default;
+
+    MappedArena(const MappedArena&) = delete;
+
+    MappedArena& operator=(const MappedArena&) = delete;
+
+    ~MappedArena() {
+        for (char* cur : segments) {
+            munmap(cur, SEGMENT_SIZE);
+        }
+    }
+
+    /** Obtains memory of the given size, which must not exceed the size of a segment */
+    void* allocate(std::size_t bytes) {
+        bytes = (bytes + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        if (used + bytes > SEGMENT_SIZE) {
+            if (current + 1 < segments.size()) {
+                current++;
+            } else {
+                int fd = SpillManager::instance().createFile(SEGMENT_SIZE);
+                void* res = mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if (res == MAP_FAILED) {
+                    throw std::runtime_error("Cannot map spill file: " + std::string(strerror(errno)));
+                }
+                segments.push_back(static_cast<char*>(res));
+                current = segments.size() - 1;
+            }
+            used = 0;
+        }
+        void* res = segments[current] + used;
+        used += bytes;
+        return res;
+    }
+
+    /** Releases all blocks, retaining the segments for later allocations */
+    void clear() {
+        for (char* cur : segments) {
+            // release the file space of the dropped content
+            madvise(cur, SEGMENT_SIZE, MADV_REMOVE);
+        }
+        current = 0;
+        used = segments.empty() ? SEGMENT_SIZE : 0;
+    }
+};
+
+}  // end of namespace souffle
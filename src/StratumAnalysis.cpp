@@ -0,0 +1,100 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file StratumAnalysis.cpp
+ *
+ * Computes the relations computed and read by each stratum of a RAM program
+ *
+ ***********************************************************************/
+
+#include "StratumAnalysis.h"
+#include "RamCondition.h"
+#include "RamNode.h"
+#include "RamOperation.h"
+#include "RamStatement.h"
+#include "RamTranslationUnit.h"
+#include "RamValue.h"
+#include "RamVisitor.h"
+
+namespace souffle {
+
+void StratumAnalysis::run(const RamTranslationUnit& translationUnit) {
+    visitDepthFirst(translationUnit.getP(), [&](const RamStratum& stratum) {
+        std::set<RamRelation>& writes = computed[stratum.getIndex()];
+        std::set<RamRelation>& reads = dependencies[stratum.getIndex()];
+
+        // collect the relations filled by the stratum
+        auto addWrite = [&](const RamRelation& rel) {
+            if (!rel.isTemp()) {
+                writes.insert(rel);
+            }
+        };
+        visitDepthFirst(stratum, [&](const RamNode& node) {
+            if (auto project = dynamic_cast<const RamProject*>(&node)) {
+                addWrite(project->getRelation());
+            } else if (auto load = dynamic_cast<const RamLoad*>(&node)) {
+                addWrite(load->getRelation());
+            } else if (auto fact = dynamic_cast<const RamFact*>(&node)) {
+                addWrite(fact->getRelation());
+            } else if (auto merge = dynamic_cast<const RamMerge*>(&node)) {
+                addWrite(merge->getTargetRelation());
+            } else if (auto erase = dynamic_cast<const RamErase*>(&node)) {
+                addWrite(erase->getTargetRelation());
+            }
+        });
+
+        // collect the relations searched by the stratum
+        auto addRead = [&](const RamRelation& rel) {
+            if (!rel.isTemp() && writes.find(rel) == writes.end()) {
+                reads.insert(rel);
+            }
+        };
+        visitDepthFirst(stratum, [&](const RamNode& node) {
+            if (auto scan = dynamic_cast<const RamScan*>(&node)) {
+                addRead(scan->getRelation());
+            } else if (auto lfJoin = dynamic_cast<const RamLeapfrogJoin*>(&node)) {
+                for (const RamRelation* rel : lfJoin->getRelations()) {
+                    addRead(*rel);
+                }
+            } else if (auto hashJoin = dynamic_cast<const RamHashJoin*>(&node)) {
+                addRead(hashJoin->getLeftRelation());
+                addRead(hashJoin->getRightRelation());
+            } else if (auto agg = dynamic_cast<const RamAggregate*>(&node)) {
+                addRead(agg->getRelation());
+            } else if (auto notExist = dynamic_cast<const RamNotExists*>(&node)) {
+                addRead(notExist->getRelation());
+            } else if (auto empty = dynamic_cast<const RamEmpty*>(&node)) {
+                addRead(empty->getRelation());
+            } else if (auto project = dynamic_cast<const RamProject*>(&node)) {
+                if (project->hasFilter()) {
+                    addRead(project->getFilter());
+                }
+            }
+        });
+    });
+}
+
+void StratumAnalysis::print(std::ostream& os) const {
+    os << "------ Stratum Dependency Report -------\n";
+    for (const auto& cur : computed) {
+        os << "Stratum " << cur.first << "\n";
+        os << "\tComputed:";
+        for (const RamRelation& rel : cur.second) {
+            os << " " << rel.getName();
+        }
+        os << "\n\tDepends on:";
+        for (const RamRelation& rel : getDependencies(cur.first)) {
+            os << " " << rel.getName();
+        }
+        os << "\n";
+    }
+}
+
+}  // end of namespace souffle
@@ -0,0 +1,69 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file StratumAnalysis.h
+ *
+ * Computes the relations computed and read by each stratum of a RAM program
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamAnalysis.h"
+#include "RamRelation.h"
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <set>
+
+namespace souffle {
+
+class RamTranslationUnit;
+
+/**
+ * Analysis pass computing the relations computed by each stratum of the main
+ * program, and the relations of other strata it depends on. Temporary relations
+ * are not considered.
+ */
+class StratumAnalysis : public RamAnalysis {
+private:
+    /** relations computed by each stratum */
+    std::map<size_t, std::set<RamRelation>> computed;
+
+    /** relations of other strata read by each stratum */
+    std::map<size_t, std::set<RamRelation>> dependencies;
+
+    /** the empty set of relations */
+    const std::set<RamRelation> none;
+
+public:
+    static constexpr const char* name = "stratum-analysis";
+
+    /** run analysis */
+    void run(const RamTranslationUnit& translationUnit) override;
+
+    /** print analysis */
+    void print(std::ostream& os) const override;
+
+    /** get relations computed by the given stratum, including loaded ones */
+    const std::set<RamRelation>& getComputedRelations(size_t stratum) const {
+        auto pos = computed.find(stratum);
+        return (pos != computed.end()) ? pos->second : none;
+    }
+
+    /** get relations of other strata read by the given stratum */
+    const std::set<RamRelation>& getDependencies(size_t stratum) const {
+        auto pos = dependencies.find(stratum);
+        return (pos != dependencies.end()) ? pos->second : none;
+    }
+};
+
+}  // end of namespace souffle
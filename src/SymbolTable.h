@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "MemoryUsage.h"
 #include "ParallelUtils.h"
 #include "RamTypes.h"
 #include "Util.h"
@@ -116,6 +117,18 @@ public:
         return static_cast<RamDomain>(newSymbolOfIndex(symbol));
     }
 
+    /** Find the indices of the given number of symbols, inserting symbols not in the table yet, and store
+     * them in the given array; note that this operation is more efficient than repeated lookups of single
+     * symbols. */
+    void lookup(const std::string* symbols, size_t count, RamDomain* indices) {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        strToNum.reserve(size() + count);
+        for (size_t i = 0; i < count; i++) {
+            indices[i] = static_cast<RamDomain>(newSymbolOfIndex(symbols[i]));
+        }
+    }
+
     /** Finds the index of a symbol in the table, giving an error if it's not found */
     RamDomain lookupExisting(const std::string& symbol) const {
         auto lease = access.acquire();
@@ -128,6 +141,13 @@ public:
         return static_cast<RamDomain>(result->second);
     }
 
+    /** Check whether a symbol exists in the table */
+    bool contains(const std::string& symbol) const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        return strToNum.find(symbol) != strToNum.end();
+    }
+
     /** Find the index of a symbol in the table, inserting a new symbol if it does not exist there already. */
     RamDomain unsafeLookup(const std::string& symbol) {
         return newSymbolOfIndex(symbol);
@@ -147,6 +167,21 @@ public:
         return numToStr[pos];
     }
 
+    /** Find the symbols of the given number of indices and store them in the given array, note that this
+     * gives an error if an index is out of bounds. */
+    void resolve(const RamDomain* indices, size_t count, const std::string** symbols) const {
+        auto lease = access.acquire();
+        (void)lease;  // avoid warning;
+        for (size_t i = 0; i < count; i++) {
+            auto pos = static_cast<size_t>(indices[i]);
+            if (pos >= size()) {
+                std::cerr << "Error index out of bounds in call to SymbolTable::resolve.\n";
+                exit(1);
+            }
+            symbols[i] = &numToStr[pos];
+        }
+    }
+
     const std::string& unsafeResolve(const RamDomain index) const {
         return numToStr[static_cast<size_t>(index)];
     }
@@ -156,6 +191,21 @@ public:
         return numToStr.size();
     }
 
+    /** Estimates the number of bytes occupied by the symbols and their mappings. */
+    size_t getMemoryUsage() const {
+        auto lease = access.acquire();
+        (void)lease;
+        size_t res = sizeof(*this) + numToStr.size() * sizeof(std::string) + getHashMemoryUsage(strToNum);
+        // each symbol is stored twice, its characters on the heap unless short enough to be inlined
+        const size_t inlined = std::string().capacity();
+        for (const auto& cur : numToStr) {
+            if (cur.capacity() > inlined) {
+                res += 2 * (cur.capacity() + 1);
+            }
+        }
+        return res;
+    }
+
     /** Bulk insert symbols into the table, note that this operation is more efficient than repeated inserts
      * of single symbols. */
     void insert(const std::vector<std::string>& symbols) {
@@ -30,6 +30,7 @@
 #include "RamValue.h"
 #include "RamVisitor.h"
 #include "SymbolMask.h"
+#include "StratumAnalysis.h"
 #include "SymbolTable.h"
 #include "TernaryFunctorOps.h"
 #include "UnaryFunctorOps.h"
@@ -127,6 +128,12 @@ std::string Synthesiser::getRelationType(const RamRelation& rel, std::size_t ari
         res << "Brie,";
     } else if (rel.isEqRel()) {
         res << "EqRel,";
+    } else if (rel.isColumnar()) {
+        res << "Columnar,";
+    } else if (rel.isCompressed()) {
+        res << "Compressed,";
+    } else if (rel.isSpill()) {
+        res << "Spill,";
     } else {
         auto data_structure = Global::config().get("data-structure");
         if (data_structure == "btree") {
@@ -139,6 +146,12 @@ std::string Synthesiser::getRelationType(const RamRelation& rel, std::size_t ari
             res << "Brie,";
         } else if (data_structure == "eqrel") {
             res << "Eqrel,";
+        } else if (data_structure == "columnar") {
+            res << "Columnar,";
+        } else if (data_structure == "compressed") {
+            res << "Compressed,";
+        } else if (data_structure == "spill") {
+            res << "Spill,";
         } else {
             res << "Auto,";
         }
@@ -182,6 +195,13 @@ std::set<RamRelation> Synthesiser::getReferencedRelations(const RamOperation& op
     visitDepthFirst(op, [&](const RamNode& node) {
         if (auto scan = dynamic_cast<const RamScan*>(&node)) {
             res.insert(scan->getRelation());
+        } else if (auto lfJoin = dynamic_cast<const RamLeapfrogJoin*>(&node)) {
+            for (const RamRelation* rel : lfJoin->getRelations()) {
+                res.insert(*rel);
+            }
+        } else if (auto hashJoin = dynamic_cast<const RamHashJoin*>(&node)) {
+            res.insert(hashJoin->getLeftRelation());
+            res.insert(hashJoin->getRightRelation());
         } else if (auto agg = dynamic_cast<const RamAggregate*>(&node)) {
             res.insert(agg->getRelation());
         } else if (auto notExist = dynamic_cast<const RamNotExists*>(&node)) {
@@ -196,6 +216,62 @@ std::set<RamRelation> Synthesiser::getReferencedRelations(const RamOperation& op
     return res;
 }
 
+/** Get relations of a non-recursive stratum whose secondary indices may be built once it completes */
+std::set<RamRelation> Synthesiser::getDeferrableRelations(
+        const RamStratum& stratum, IndexSetAnalysis& indexes) {
+    std::set<RamRelation> res;
+
+    // relations of recursive strata are read while being computed
+    bool recursive = false;
+    visitDepthFirst(stratum, [&](const RamLoop&) { recursive = true; });
+    if (recursive) {
+        return res;
+    }
+
+    // relations filled by this stratum
+    visitDepthFirst(stratum, [&](const RamNode& node) {
+        if (auto project = dynamic_cast<const RamProject*>(&node)) {
+            res.insert(project->getRelation());
+        } else if (auto load = dynamic_cast<const RamLoad*>(&node)) {
+            res.insert(load->getRelation());
+        } else if (auto fact = dynamic_cast<const RamFact*>(&node)) {
+            res.insert(fact->getRelation());
+        }
+    });
+
+    // relations searched by this stratum require all of their indices
+    visitDepthFirst(stratum, [&](const RamNode& node) {
+        if (auto scan = dynamic_cast<const RamScan*>(&node)) {
+            res.erase(scan->getRelation());
+        } else if (auto lfJoin = dynamic_cast<const RamLeapfrogJoin*>(&node)) {
+            for (const RamRelation* rel : lfJoin->getRelations()) {
+                res.erase(*rel);
+            }
+        } else if (auto hashJoin = dynamic_cast<const RamHashJoin*>(&node)) {
+            res.erase(hashJoin->getLeftRelation());
+            res.erase(hashJoin->getRightRelation());
+        } else if (auto agg = dynamic_cast<const RamAggregate*>(&node)) {
+            res.erase(agg->getRelation());
+        } else if (auto notExist = dynamic_cast<const RamNotExists*>(&node)) {
+            // checks binding all columns are answered by the primary index
+            auto values = notExist->getValues();
+            if (std::find(values.begin(), values.end(), nullptr) != values.end()) {
+                res.erase(notExist->getRelation());
+            }
+        }
+    });
+
+    // only relations maintaining secondary indices benefit
+    for (auto it = res.begin(); it != res.end();) {
+        if (indexes.getIndexes(*it).getAllOrders().size() < 2) {
+            it = res.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return res;
+}
+
 void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
     class CodeEmitter : public RamVisitor<void, std::ostream&> {
     private:
@@ -247,6 +323,10 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             out << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
             out << "}\n";
             out << "IODirectives ioDirectives(directiveMap);\n";
+            // input relations are read by all threads, thus spread across all NUMA nodes
+            if (Global::config().has("interleave-inputs")) {
+                out << "MemoryPlacement::InterleaveScope interleave;\n";
+            }
             out << "IOSystem::getInstance().getReader(";
             out << "SymbolMask({" << load.getRelation().getSymbolMask() << "})";
             out << ", symTable, ioDirectives";
@@ -285,6 +365,15 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             // enclose operation with a check for an empty relation
             std::set<RamRelation> input_relations;
             visitDepthFirst(insert, [&](const RamScan& scan) { input_relations.insert(scan.getRelation()); });
+            visitDepthFirst(insert, [&](const RamLeapfrogJoin& join) {
+                for (const RamRelation* rel : join.getRelations()) {
+                    input_relations.insert(*rel);
+                }
+            });
+            visitDepthFirst(insert, [&](const RamHashJoin& join) {
+                input_relations.insert(join.getLeftRelation());
+                input_relations.insert(join.getRightRelation());
+            });
             if (!input_relations.empty()) {
                 out << "if (" << join(input_relations, "&&", [&](std::ostream& out, const RamRelation& rel) {
                     out << "!" << synthesiser.getRelationName(rel) << "->"
@@ -314,6 +403,50 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                     // build a parallel block around this loop nest
                     out << "PARALLEL_START;\n";
                 }
+            } else if (const auto* leapfrog = dynamic_cast<const RamLeapfrogJoin*>(&insert.getOperation())) {
+                parallel = true;
+
+                // partition the values of the first variable via a relation it is bound by
+                auto rels = leapfrog->getRelations();
+                size_t first = 0;
+                while (leapfrog->getColumn(first, 0) < 0) {
+                    first++;
+                }
+                out << "auto bounds = leapfrogPartition(" << synthesiser.getRelationName(*rels[first])
+                    << "->getTrie<ram::index<" << join(leapfrog->getOrder(first), ",") << ">>());\n";
+
+                // build a parallel block around this loop nest
+                out << "PARALLEL_START;\n";
+            } else if (const auto* hashJoin = dynamic_cast<const RamHashJoin*>(&insert.getOperation())) {
+                parallel = true;
+                const auto& left = hashJoin->getLeftRelation();
+                const auto& right = hashJoin->getRightRelation();
+                auto leftName = synthesiser.getRelationName(left);
+                auto rightName = synthesiser.getRelationName(right);
+
+                // build the hash table on the smaller relation and partition the larger one
+                out << "const bool hashLeft = " << leftName << "->size() <= " << rightName << "->size();\n";
+                out << "ram::HashJoinTable<" << left.getArity() << ",ram::index<"
+                    << join(hashJoin->getLeftKeys(), ",") << ">> tableLeft;\n";
+                out << "ram::HashJoinTable<" << right.getArity() << ",ram::index<"
+                    << join(hashJoin->getRightKeys(), ",") << ">> tableRight;\n";
+                out << "decltype(" << leftName << "->partition()) partLeft;\n";
+                out << "decltype(" << rightName << "->partition()) partRight;\n";
+                out << "if (hashLeft) {\n";
+                out << "tableLeft.insertAll(*" << leftName << ");\n";
+                out << "partRight = " << rightName << "->partition();\n";
+                out << "} else {\n";
+                out << "tableRight.insertAll(*" << rightName << ");\n";
+                out << "partLeft = " << leftName << "->partition();\n";
+                out << "}\n";
+
+                // build a parallel block around this loop nest
+                out << "PARALLEL_START;\n";
+            }
+
+            // the threads of the parallel block record their events in the profile of the program
+            if (parallel && Global::config().has("profile")) {
+                out << "ProfileEventSingleton::Scope threadProfileScope(profileEvents);\n";
             }
 
             // create operation contexts for this operation
@@ -350,6 +483,14 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visitErase(const RamErase& erase, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            out << synthesiser.getRelationName(erase.getTargetRelation()) << "->"
+                << "eraseAll("
+                << "*" << synthesiser.getRelationName(erase.getSourceRelation()) << ");\n";
+            PRINT_END_COMMENT(out);
+        }
+
         void visitClear(const RamClear& clear, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
             out << synthesiser.getRelationName(clear.getRelation()) << "->"
@@ -418,9 +559,12 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             // start parallel section
             out << "SECTIONS_START;\n";
 
-            // put each thread in another section
+            // put each thread in another section, recording its events in the profile of the program
             for (const auto& cur : stmts) {
                 out << "SECTION_START;\n";
+                if (Global::config().has("profile")) {
+                    out << "ProfileEventSingleton::Scope threadProfileScope(profileEvents);\n";
+                }
                 visit(cur, out);
                 out << "SECTION_END\n";
             }
@@ -436,6 +580,9 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             out << "for(;;) {\n";
             visit(loop.getBody(), out);
             out << "iter++;\n";
+            if (Global::config().has("memory-limit")) {
+                out << "checkMemoryLimit();\n";
+            }
             out << "}\n";
             out << "iter = 0;\n";
             PRINT_END_COMMENT(out);
@@ -529,7 +676,8 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             auto level = scan.getLevel();
 
             // if this search is a full scan
-            if (scan.getRangeQueryColumns() == 0) {
+            int rangeColumn = scan.getRangeColumn();
+            if (scan.getRangeQueryColumns() == 0 && rangeColumn < 0) {
                 if (scan.isPureExistenceCheck()) {
                     out << "if(!" << relName << "->"
                         << "empty()) {\n";
@@ -558,10 +706,14 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             const auto& rangePattern = scan.getRangePattern();
 
             // a lambda for printing boundary key values
-            auto printKeyTuple = [&]() {
+            auto printKeyTuple = [&](int boundColumn, RamValue* bound, const std::string& unbounded) {
                 for (size_t i = 0; i < arity; i++) {
                     if (rangePattern[i] != nullptr) {
                         visit(rangePattern[i], out);
+                    } else if ((int)i == boundColumn && bound != nullptr) {
+                        visit(bound, out);
+                    } else if ((int)i == boundColumn) {
+                        out << unbounded;
                     } else {
                         out << "0";
                     }
@@ -575,12 +727,27 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             auto keys = scan.getRangeQueryColumns();
             auto index = synthesiser.toIndex(keys);
 
-            // if it is a equality-range query
-            out << "const Tuple<RamDomain," << arity << "> key({{";
-            printKeyTuple();
-            out << "}});\n";
-            out << "auto range = " << relName << "->"
-                << "equalRange" << index << "(key," << ctxName << ");\n";
+            if (rangeColumn >= 0) {
+                // a range query bounding the column following the equality prefix
+                RamValue* lowerBound = scan.getLowerBounds()[rangeColumn];
+                RamValue* upperBound = scan.getUpperBounds()[rangeColumn];
+                out << "const Tuple<RamDomain," << arity << "> lower({{";
+                printKeyTuple(rangeColumn, lowerBound, "MIN_RAM_DOMAIN");
+                out << "}});\n";
+                out << "const Tuple<RamDomain," << arity << "> upper({{";
+                printKeyTuple(rangeColumn, upperBound, "MAX_RAM_DOMAIN");
+                out << "}});\n";
+                out << "auto range = " << relName << "->"
+                    << "lowerUpperRange<ram::index" << index << "," << rangeColumn << ">(lower,upper,"
+                    << ctxName << ");\n";
+            } else {
+                // if it is a equality-range query
+                out << "const Tuple<RamDomain," << arity << "> key({{";
+                printKeyTuple(-1, nullptr, "0");
+                out << "}});\n";
+                out << "auto range = " << relName << "->"
+                    << "equalRange" << index << "(key," << ctxName << ");\n";
+            }
             if (scan.isPureExistenceCheck()) {
                 out << "if(!range.empty()) {\n";
             } else {
@@ -591,6 +758,115 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visitLeapfrogJoin(const RamLeapfrogJoin& leapfrog, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            auto rels = leapfrog.getRelations();
+            auto base = leapfrog.getBaseLevel();
+            auto numVars = leapfrog.getNumVariables();
+
+            // obtain the tries ordering the joined relations by their join variables
+            for (size_t i = 0; i < rels.size(); i++) {
+                out << "const auto* trie" << base + i << "_0 = &" << synthesiser.getRelationName(*rels[i])
+                    << "->getTrie<ram::index<" << join(leapfrog.getOrder(i), ",") << ">>();\n";
+            }
+
+            // the number of variables of each relation bound so far
+            std::vector<size_t> depth(rels.size(), 0);
+
+            // the values of the first variable of an outermost join are partitioned among threads by
+            // the enclosing insert
+            bool parallel = (base == 0);
+
+            // bind one variable per loop
+            for (size_t var = 0; var < numVars; var++) {
+                std::vector<std::string> tries;
+                for (size_t i = 0; i < rels.size(); i++) {
+                    if (leapfrog.getColumn(i, var) >= 0) {
+                        tries.push_back("trie" + toString(base + i) + "_" + toString(depth[i]));
+                    }
+                }
+                std::string value = "val" + toString(base) + "_" + toString(var);
+                std::string found = "found" + toString(base) + "_" + toString(var);
+                std::string seek = "leapfrogSeek(" + value + "," + toString(join(tries, ",")) + ")";
+                if (parallel && var == 0) {
+                    seek += " && leapfrogWithin(" + value + ",bounds,chunk)";
+                    out << "pfor(size_t chunk = 0; chunk < bounds.size(); ++chunk) \n";
+                    out << "try{";
+                    out << "RamDomain " << value << " = bounds[chunk];\n";
+                } else {
+                    out << "RamDomain " << value << " = leapfrogFirst();\n";
+                }
+                out << "for(bool " << found << " = " << seek << "; " << found << "; " << found
+                    << " = leapfrogNext(" << value << ") && " << seek << ") {\n";
+
+                // descend into the sub-tries of the bound value
+                for (size_t i = 0; i < rels.size(); i++) {
+                    if (leapfrog.getColumn(i, var) < 0) {
+                        continue;
+                    }
+                    if (depth[i] + 1 < rels[i]->getArity()) {
+                        out << "const auto* trie" << base + i << "_" << depth[i] + 1 << " = trie" << base + i
+                            << "_" << depth[i] << "->getNested(" << value << ");\n";
+                    }
+                    depth[i]++;
+                }
+            }
+
+            // assemble the tuples of the joined relations
+            for (size_t i = 0; i < rels.size(); i++) {
+                out << "const ram::Tuple<RamDomain," << rels[i]->getArity() << "> env" << base + i << "({{";
+                out << join(leapfrog.getVariables(i), ",",
+                        [&](std::ostream& out, size_t var) { out << "val" << base << "_" << var; });
+                out << "}});\n";
+            }
+
+            visitSearch(leapfrog, out);
+
+            for (size_t var = 0; var < numVars; var++) {
+                out << "}\n";
+            }
+            if (parallel) {
+                out << "} catch(std::exception &e) { SignalHandler::instance()->error(e.what());}\n";
+            }
+            PRINT_END_COMMENT(out);
+        }
+
+        void visitHashJoin(const RamHashJoin& hashJoin, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            // the hash tables and partitions are prepared by the enclosing insert
+            assert(hashJoin.getLeftLevel() == 0 && "hash join is not the outermost operation");
+            const auto& left = hashJoin.getLeftRelation();
+            const auto& right = hashJoin.getRightRelation();
+
+            // a lambda for probing the hash table of one relation by a partitioned scan of the other
+            auto printProbe = [&](const RamRelation& build, const std::vector<size_t>& buildKeys,
+                                      size_t buildLevel, const std::string& table,
+                                      const std::vector<size_t>& probeKeys, size_t probeLevel,
+                                      const std::string& part) {
+                out << "pfor(auto it = " << part << ".begin(); it<" << part << ".end(); ++it) \n";
+                out << "try{";
+                out << "for(const auto& env" << probeLevel << " : *it) {\n";
+                out << "ram::Tuple<RamDomain," << build.getArity() << "> key({{}});\n";
+                for (size_t i = 0; i < buildKeys.size(); i++) {
+                    out << "key[" << buildKeys[i] << "] = env" << probeLevel << "[" << probeKeys[i] << "];\n";
+                }
+                out << "for(const auto& env" << buildLevel << " : " << table << ".equalRange(key)) {\n";
+                visitSearch(hashJoin, out);
+                out << "}\n";
+                out << "}\n";
+                out << "} catch(std::exception &e) { SignalHandler::instance()->error(e.what());}\n";
+            };
+
+            out << "if (hashLeft) {\n";
+            printProbe(left, hashJoin.getLeftKeys(), hashJoin.getLeftLevel(), "tableLeft",
+                    hashJoin.getRightKeys(), hashJoin.getLevel(), "partRight");
+            out << "} else {\n";
+            printProbe(right, hashJoin.getRightKeys(), hashJoin.getLevel(), "tableRight",
+                    hashJoin.getLeftKeys(), hashJoin.getLeftLevel(), "partLeft");
+            out << "}\n";
+            PRINT_END_COMMENT(out);
+        }
+
         void visitLookup(const RamLookup& lookup, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
             auto arity = lookup.getArity();
@@ -602,7 +878,8 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             out << "auto ref = env" << lookup.getReferenceLevel() << "[" << lookup.getReferencePosition()
                 << "];\n";
             out << "if (isNull<" << tuple_type << ">(ref)) continue;\n";
-            out << tuple_type << " env" << lookup.getLevel() << " = unpack<" << tuple_type << ">(ref);\n";
+            out << tuple_type << " env" << lookup.getLevel() << " = records.unpack<" << tuple_type
+                << ">(ref);\n";
 
             out << "{\n";
 
@@ -1152,7 +1429,7 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         void visitPack(const RamPack& pack, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << "pack("
+            out << "records.pack("
                 << "ram::Tuple<RamDomain," << pack.getValues().size() << ">({"
                 << join(pack.getValues(), ",", rec) << "})"
                 << ")";
@@ -1200,6 +1477,7 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     const SymbolTable& symTable = unit.getSymbolTable();
     const RamProgram& prog = unit.getP();
     auto* idxAnalysis = unit.getAnalysis<IndexSetAnalysis>();
+    stratumAnalysis = unit.getAnalysis<StratumAnalysis>();
 
     // ---------------------------------------------------------------
     //                      Code Generation
@@ -1212,6 +1490,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     if (Global::config().has("provenance")) {
         os << "#include \"souffle/Explain.h\"\n";
     }
+    if (Global::config().has("incremental")) {
+        os << "#include \"souffle/SouffleServer.h\"\n";
+    }
 
     if (Global::config().has("live-profile")) {
         os << "#include <thread>\n";
@@ -1251,8 +1532,15 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
 
     if (Global::config().has("profile")) {
         os << "std::string profiling_fname;\n";
+        os << "ProfileEventSingleton profileEvents;\n";
     }
 
+    // declare the records of this instance, a map per arity
+    std::set<size_t> recordArities;
+    visitDepthFirst(prog, [&](const RamPack& pack) { recordArities.insert(pack.getValues().size()); });
+    visitDepthFirst(prog, [&](const RamLookup& lookup) { recordArities.insert(lookup.getArity()); });
+    os << "RecordTable<" << join(recordArities, ",") << "> records;\n";
+
     os << "public:\n";
 
     // declare symbol table
@@ -1286,12 +1574,14 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         const std::string& raw_name = rel.getName();
         const std::string& name = getRelationName(rel);
 
-        // ensure that the type of the new knowledge is the same as that of the delta knowledge
+        // ensure that the type of the new knowledge is the same as that of the delta knowledge; other
+        // temporary relations kept for incremental updates have their own type
         tempType = (rel.isTemp() && raw_name.find("@delta") != std::string::npos)
                            ? getRelationType(rel, rel.getArity(), idxAnalysis->getIndexes(rel))
                            : tempType;
-        const std::string& type = (rel.isTemp()) ? tempType : getRelationType(rel, rel.getArity(),
-                                                                      idxAnalysis->getIndexes(rel));
+        bool isNew = rel.isTemp() && raw_name.find("@new") == 0;
+        const std::string& type =
+                (isNew) ? tempType : getRelationType(rel, rel.getArity(), idxAnalysis->getIndexes(rel));
 
         // defining table
         os << "// -- Table: " << raw_name << "\n";
@@ -1301,7 +1591,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         }
         initCons += name + "(new " + type + "())";
         deleteForNew += "delete " + name + ";\n";
-        if ((rel.isInput() || rel.isComputed() || Global::config().has("provenance")) && !rel.isTemp()) {
+        bool isKept = Global::config().has("incremental") && rel.isTemp();
+        if (((rel.isInput() || rel.isComputed() || Global::config().has("provenance")) && !rel.isTemp()) ||
+                isKept) {
             os << "souffle::RelationWrapper<";
             os << relCtr++ << ",";
             os << type << ",";
@@ -1331,8 +1623,12 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
 
             initCons += ",\nwrapper_" + name + "(" + "*" + name + ",symTable,\"" + raw_name + "\"," +
                         tupleType + "," + tupleName + ")";
-            registerRel += "addRelation(\"" + raw_name + "\",&wrapper_" + name + "," +
-                           std::to_string(rel.isInput()) + "," + std::to_string(rel.isOutput()) + ");\n";
+            if (isKept) {
+                registerRel += "addTempRelation(\"" + raw_name + "\",&wrapper_" + name + ");\n";
+            } else {
+                registerRel += "addRelation(\"" + raw_name + "\",&wrapper_" + name + "," +
+                               std::to_string(rel.isInput()) + "," + std::to_string(rel.isOutput()) + ");\n";
+            }
         }
     });
 
@@ -1354,6 +1650,48 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     }
     os << "{\n";
     os << registerRel;
+
+    // register the strata for the selection of outputs and incremental updates, naming the relations
+    // they depend on and compute
+    auto printNames = [&](const std::set<RamRelation>& rels) {
+        os << "{" << join(rels, ",", [](std::ostream& out, const RamRelation& rel) {
+            out << "R\"_(" << rel.getName() << ")_\"";
+        }) << "}";
+    };
+    visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
+        os << "addStratum(" << stratum.getIndex() << ", ";
+        printNames(stratumAnalysis->getDependencies(stratum.getIndex()));
+        os << ", ";
+        printNames(stratumAnalysis->getComputedRelations(stratum.getIndex()));
+        // strata without an update subroutine are computed anew by incremental updates
+        bool maintained = prog.getSubroutines().count("update_" + std::to_string(stratum.getIndex())) > 0;
+        os << ", " << (maintained ? "true" : "false") << ");\n";
+    });
+    if (Global::config().has("incremental")) {
+        os << "setIncremental();\n";
+    }
+
+    // filter the lookups of negations and existence checks on complete relations
+    if (!areIndexesDisabled()) {
+        std::set<std::string> filters;
+        auto addFilter = [&](const RamRelation& rel, SearchColumns key) {
+            if (!rel.isTemp() && key != 0) {
+                filters.insert(getRelationName(rel) + "->enableFilter<ram::index" + toIndex(key) + ">();\n");
+            }
+        };
+        visitDepthFirst(*(prog.getMain()), [&](const RamNode& node) {
+            if (auto ne = dynamic_cast<const RamNotExists*>(&node)) {
+                addFilter(ne->getRelation(), ne->getKey());
+            } else if (auto scan = dynamic_cast<const RamScan*>(&node)) {
+                if (scan->isPureExistenceCheck() && scan->getRangeColumn() < 0) {
+                    addFilter(scan->getRelation(), scan->getRangeQueryColumns());
+                }
+            }
+        });
+        for (const auto& cur : filters) {
+            os << cur;
+        }
+    }
     os << "}\n";
     // -- destructor --
 
@@ -1361,6 +1699,34 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     os << deleteForNew;
     os << "}\n";
 
+    // -- memory limit --
+    if (Global::config().has("memory-limit")) {
+        os << "private:\n";
+        os << "MemoryLimit memoryLimit{" << std::stoull(Global::config().get("memory-limit"))
+           << "ull << 20};\n";
+        os << "void checkMemoryLimit() {\n";
+        os << "if (!memoryLimit.isDue()) return;\n";
+        os << "MemoryReport report;\n";
+        visitDepthFirst(*(prog.getMain()), [&](const RamCreate& create) {
+            os << "report.add(R\"_(" << create.getRelation().getName() << ")_\", "
+               << getRelationName(create.getRelation()) << "->getMemoryUsage());\n";
+        });
+        os << "report.add(\"@symbol-table\", symTable.getMemoryUsage());\n";
+        os << "report.add(\"@records\", records.getMemoryUsage());\n";
+        os << "if (!memoryLimit.isExceeded(report)) return;\n";
+        os << "std::cerr << \"Error: memory limit of \" << MemoryReport::formatBytes(memoryLimit.getLimit()) "
+              "<< \" exceeded\\n\";\n";
+        os << "report.print(std::cerr);\n";
+        os << "exit(1);\n";
+        os << "}\n";
+    }
+
+    // -- counter kept across evaluations of single strata --
+    if (Global::config().has("incremental")) {
+        os << "private:\n";
+        os << "std::atomic<RamDomain> ctr{0};\n";
+    }
+
     // -- run function --
     os << "private:\ntemplate <bool performIO> void runFunction(std::string inputDirectory = \".\", "
           "std::string outputDirectory = \".\", size_t stratumIndex = (size_t) -1) {\n";
@@ -1372,7 +1738,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
 
     // initialize counter
     os << "// -- initialize counter --\n";
-    os << "std::atomic<RamDomain> ctr(0);\n\n";
+    if (!Global::config().has("incremental")) {
+        os << "std::atomic<RamDomain> ctr(0);\n\n";
+    }
     os << "std::atomic<size_t> iter(0);\n\n";
 
     // set default threads (in embedded mode)
@@ -1382,10 +1750,26 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         os << "#endif\n\n";
     }
 
+    // configure the memory budget of spilling relations
+    if (Global::config().has("spill-budget")) {
+        os << "SpillManager::instance().setBudget(" << std::stoull(Global::config().get("spill-budget"))
+           << "ull << 20);\n";
+    }
+    if (Global::config().has("spill-dir")) {
+        os << "SpillManager::instance().setDirectory(R\"_(" << Global::config().get("spill-dir")
+           << ")_\");\n";
+    }
+
+    // keep the threads on the NUMA nodes hosting the memory they allocate
+    if (Global::config().has("pin-threads")) {
+        os << "MemoryPlacement::instance().pinThreads();\n";
+    }
+
     // add actual program body
     os << "// -- query evaluation --\n";
     if (Global::config().has("profile")) {
-        os << "ProfileEventSingleton::instance().startTimer();\n";
+        os << "ProfileEventSingleton::Scope profileScope(profileEvents);\n";
+        os << "profileEvents.startTimer();\n";
         os << "{\n"
            << R"_(Logger logger("@runtime;", 0);)_" << '\n';
     }
@@ -1412,9 +1796,24 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         if (Global::config().has("engine")) {
             os << "STRATUM_" << stratum.getIndex() << ":\n";
         }
-        os << "{\n";
+        // strata the outputs selected via the interface do not depend on are skipped
+        os << "if (isStratumSelected(" << stratum.getIndex() << ")) {\n";
+        // relations produced outside of recursion obtain their secondary indices in bulk
+        std::set<RamRelation> deferred;
+        if (Global::config().has("defer-indices")) {
+            deferred = getDeferrableRelations(stratum, *idxAnalysis);
+        }
+        for (const RamRelation& rel : deferred) {
+            os << getRelationName(rel) << "->deferIndices();\n";
+        }
         emitCode(os, stratum.getBody());
+        for (const RamRelation& rel : deferred) {
+            os << getRelationName(rel) << "->buildIndices();\n";
+        }
         os << "}\n";
+        if (Global::config().has("memory-limit")) {
+            os << "checkMemoryLimit();\n";
+        }
         if (Global::config().has("engine")) {
             os << "if (stratumIndex != (size_t) -1) goto EXIT;\n";
         }
@@ -1428,9 +1827,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     if (Global::config().has("profile")) {
         os << "}\n";
         os << "dumpFreqs();\n";
-        os << "ProfileEventSingleton::instance().stopTimer();\n";
+        os << "profileEvents.stopTimer();\n";
         os << "std::ofstream profile(profiling_fname);\n";
-        os << "ProfileEventSingleton::instance().dump(profile);\n";
+        os << "profileEvents.dump(profile);\n";
     }
 
     // add code printing hint statistics
@@ -1456,7 +1855,10 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
           "size_t stratumIndex = (size_t) -1) "
           "override { ";
     if (Global::config().has("live-profile")) {
-        os << "std::thread profiler([]() { profile::Tui().runProf(); });\n";
+        os << "std::thread profiler([this]() {\n";
+        os << "ProfileEventSingleton::Scope profileScope(profileEvents);\n";
+        os << "profile::Tui().runProf();\n";
+        os << "});\n";
     }
     os << "runFunction<true>(inputDirectory, outputDirectory);\n";
     if (Global::config().has("live-profile")) {
@@ -1500,7 +1902,7 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         os << "private:\n";
         os << "void dumpFreqs() {\n";
         for (auto const& cur : idxMap) {
-            os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(" << cur.first << ")_\", freqs["
+            os << "\tprofileEvents.makeQuantityEvent(R\"_(" << cur.first << ")_\", freqs["
                << cur.second << "],0);\n";
         }
         os << "}\n";  // end of dumpFreqs() method
@@ -1572,7 +1974,7 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     os << "}\n";  // end of getSymbolTable() method
 
     // TODO: generate code for subroutines
-    if (Global::config().has("provenance")) {
+    if (Global::config().has("provenance") || Global::config().has("incremental")) {
         // generate subroutine adapter
         os << "void executeSubroutine(std::string name, const std::vector<RamDomain>& args, "
               "std::vector<RamDomain>& ret, std::vector<bool>& err) override {\n";
@@ -1581,8 +1983,8 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         size_t subroutineNum = 0;
         for (auto& sub : prog.getSubroutines()) {
             os << "if (name == \"" << sub.first << "\") {\n"
-               << "subproof_" << subroutineNum
-               << "(args, ret, err);\n"  // subproof_i to deal with special characters in relation names
+               << "subroutine_" << subroutineNum
+               << "(args, ret, err);\n"  // subroutine_i to deal with special characters in relation names
                << "}\n";
             subroutineNum++;
         }
@@ -1593,8 +1995,18 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         for (auto& sub : prog.getSubroutines()) {
             // method header
             os << "void "
-               << "subproof_" << subroutineNum << "(const std::vector<RamDomain>& args, "
-                                                  "std::vector<RamDomain>& ret, std::vector<bool>& err) {\n";
+               << "subroutine_" << subroutineNum
+               << "(const std::vector<RamDomain>& args, "
+                  "std::vector<RamDomain>& ret, std::vector<bool>& err) {\n";
+
+            // loops and logging of subroutines evaluating strata count their iterations
+            bool isIterated = false;
+            visitDepthFirst(*sub.second, [&](const RamLoop&) { isIterated = true; });
+            visitDepthFirst(*sub.second, [&](const RamLogSize&) { isIterated = true; });
+            visitDepthFirst(*sub.second, [&](const RamLogTimer&) { isIterated = true; });
+            if (isIterated) {
+                os << "std::atomic<size_t> iter(0);\n";
+            }
 
             // generate code for body
             emitCode(os, *sub.second);
@@ -1641,6 +2053,10 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     }
     os << std::stoi(Global::config().get("jobs")) << ",\n";
     os << "-1";
+    if (Global::config().has("incremental")) {
+        os << ",\ntrue,\n";
+        os << "R\"(" << Global::config().get("serve") << ")\"";
+    }
     os << ");\n";
 
     os << "if (!opt.parse(argc,argv)) return 1;\n";
@@ -1656,6 +2072,24 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         os << classname + " obj;\n";
     }
 
+    // select the computed outputs, rejecting names of unknown relations
+    os << "for (const auto& name : opt.getOutputs()) {\n";
+    os << "if (obj.getRelation(name) == nullptr) {\n";
+    os << "std::cerr << \"Error: unknown relation \" << name << \" given by --outputs\\n\";\n";
+    os << "return 1;\n";
+    os << "}\n";
+    os << "}\n";
+    os << "obj.selectOutputs(opt.getOutputs());\n";
+
+    // keep the evaluated program resident to serve requests
+    if (Global::config().has("incremental")) {
+        os << "if (!opt.getSocketName().empty()) {\n";
+        os << "obj.loadAll(opt.getInputFileDir());\n";
+        os << "obj.run();\n";
+        os << "souffle::serve(obj, opt.getSocketName(), opt.getInputFileDir());\n";
+        os << "return 0;\n";
+        os << "}\n";
+    }
     os << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir(), opt.getStratumIndex());\n";
     if (Global::config().get("provenance") == "1") {
         os << "explain(obj, true, false);\n";
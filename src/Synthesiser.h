@@ -29,6 +29,7 @@ namespace souffle {
 class RamOperation;
 class RamRelation;
 class RamTranslationUnit;
+class StratumAnalysis;
 
 /**
  * A RAM synthesiser: synthesises a C++ program from a RAM program.
@@ -41,6 +42,9 @@ private:
     /** Frequency profiling of searches */
     std::map<std::string, unsigned> idxMap;
 
+    /** Relations computed and read by strata of the program */
+    const StratumAnalysis* stratumAnalysis = nullptr;
+
 protected:
     /** Convert RAM identifier */
     const std::string convertRamIdent(const std::string& name);
@@ -63,6 +67,9 @@ protected:
     /** Get referenced relations */
     std::set<RamRelation> getReferencedRelations(const RamOperation& op);
 
+    /** Get relations of a non-recursive stratum whose secondary indices may be built once it completes */
+    std::set<RamRelation> getDeferrableRelations(const RamStratum& stratum, IndexSetAnalysis& indexes);
+
     /** Generate code */
     void emitCode(std::ostream& out, const RamStatement& stmt);
 
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <iterator>
 
 namespace souffle {
@@ -101,6 +102,10 @@ public:
         return count;
     }
 
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + (count + blockSize - 1) / blockSize * sizeof(Block);
+    }
+
     const T& insert(const T& element) {
         // check whether the head is initialized
         if (!head) {
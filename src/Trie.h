@@ -34,7 +34,9 @@
 #include <bitset>
 #include <cstring>
 #include <iterator>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace souffle {
 
@@ -695,6 +697,64 @@ public:
         get(i, ctxt) = val;
     }
 
+    /**
+     * Resets the value stored in cell i to the default value, releasing the nodes
+     * left without non-default values. Resets must not run concurrently with any
+     * other operation, and invalidate the operation contexts of other operations.
+     */
+    void reset(index_type i) {
+        // check whether there is something to reset
+        if (!unsynced.root || !inBoundaries(i)) return;
+
+        // navigate to the leaf node
+        Node* node = unsynced.root;
+        unsigned level = unsynced.levels;
+        while (level != 0) {
+            node = node->cell[getIndex(i, level)].ptr;
+            if (!node) return;
+            --level;
+        }
+        node->cell[i & INDEX_MASK].value = value_type();
+
+        // release nodes without non-default values bottom-up
+        bool releasedFirst = false;
+        while (node && isEmpty(node, level)) {
+            Node* parent = const_cast<Node*>(node->parent);
+            releasedFirst = releasedFirst || node == unsynced.first;
+            free(node);
+            ++level;
+            if (parent) {
+                parent->cell[getIndex(i, level)].ptr = nullptr;
+            }
+            node = parent;
+        }
+
+        // the array may have become empty
+        if (!node) {
+            unsynced.root = nullptr;
+            unsynced.levels = 0;
+            unsynced.first = nullptr;
+            unsynced.firstOffset = std::numeric_limits<index_type>::max();
+            return;
+        }
+
+        // locate the new first leaf node and its offset
+        if (releasedFirst) {
+            node = unsynced.root;
+            index_type offset = unsynced.offset;
+            for (level = unsynced.levels; level > 0; --level) {
+                index_type x = 0;
+                while (!node->cell[x].ptr) {
+                    ++x;
+                }
+                offset |= x << (BIT_PER_STEP * level);
+                node = node->cell[x].ptr;
+            }
+            unsynced.first = node;
+            unsynced.firstOffset = offset;
+        }
+    }
+
     /**
      * Obtains the value associated to index i -- which might be
      * the default value of the covered type if the value hasn't been
@@ -1101,7 +1161,7 @@ public:
         if (!unsynced.root) return end();
 
         // check boundaries
-        if (!inBoundaries(i)) return end();
+        if (!inBoundaries(i)) return (i < unsynced.offset) ? begin() : end();
 
         // navigate to value
         Node* node = unsynced.root;
@@ -1115,17 +1175,20 @@ public:
 
             // check next step
             if (!next) {
-                if (x == NUM_CELLS - 1) {
+                // move up while the last cell of a node has been passed
+                while (x == NUM_CELLS - 1) {
                     ++level;
                     node = const_cast<Node*>(node->parent);
                     if (!node) return end();
+                    x = getIndex(i, level);
                 }
 
-                // continue search
-                i = i & getLevelMask(level);
+                // find next higher value, stop at the end of the index range
+                index_type next = (i & getLevelMask(level)) + (index_type(1) << (BITS * level));
+                if (next < i || !inBoundaries(next)) return end();
 
-                // find next higher value
-                i += (1 << (BITS * level));
+                // continue search
+                i = next;
 
             } else {
                 if (level == 0) {
@@ -1228,6 +1291,19 @@ private:
         unsynced.levels = 0;
     }
 
+    /**
+     * Determines whether the given node of the given level is only covering
+     * default values.
+     */
+    static bool isEmpty(const Node* node, unsigned level) {
+        for (int i = 0; i < NUM_CELLS; i++) {
+            if ((level == 0) ? node->cell[i].value != value_type() : node->cell[i].ptr != nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * Clones the given node and all its sub-nodes.
      */
@@ -1364,7 +1440,7 @@ private:
      * Obtains the index within the arrays of cells of a given index on a given
      * level of the internally maintained tree.
      */
-    static index_type getIndex(RamDomain a, unsigned level) {
+    static index_type getIndex(index_type a, unsigned level) {
         return (a & (INDEX_MASK << (level * BIT_PER_STEP))) >> (level * BIT_PER_STEP);
     }
 
@@ -1500,6 +1576,24 @@ public:
         return store.lookup(i >> LEAF_INDEX_WIDTH, ctxt) & bit;
     }
 
+    /**
+     * Resets the bit addressed by i to 0, returning whether it has been set before.
+     * Resets must not run concurrently with any other operation on this map.
+     */
+    bool reset(index_type i) {
+        value_t bit = (1ull << (i & LEAF_INDEX_MASK));
+        value_t old = store.lookup(i >> LEAF_INDEX_WIDTH);
+        if (!(old & bit)) return false;
+
+        // release blocks left without any set bit
+        if (old == bit) {
+            store.reset(i >> LEAF_INDEX_WIDTH);
+        } else {
+            store.update(i >> LEAF_INDEX_WIDTH, old & ~bit);
+        }
+        return true;
+    }
+
     /**
      * Determines the whether the bit addressed by i is set or not.
      */
@@ -1706,6 +1800,31 @@ public:
         return iterator(it, mask, i);
     }
 
+    /**
+     * Obtains an iterator referencing the smallest index >= i whose bit is
+     * set, end() if there is no such index.
+     */
+    iterator lowerBound(index_type i) const {
+        // locate first block not before the block of i
+        auto it = store.lowerBound(i >> LEAF_INDEX_WIDTH);
+        if (it.isEnd()) return end();
+
+        // remove all bits before pos i if i is within this block
+        uint64_t mask = iterator::toMask(it->second);
+        if (it->first == (i >> LEAF_INDEX_WIDTH)) {
+            mask &= ~((1ull << (i & LEAF_INDEX_MASK)) - 1);
+            if (mask == 0) {
+                ++it;
+                return (it.isEnd()) ? end() : iterator(it);
+            }
+        }
+
+        // consume the first remaining bit
+        auto pos = __builtin_ctzll(mask);
+        mask &= ~(1llu << pos);
+        return iterator(it, mask, (it->first << LEAF_INDEX_WIDTH) | pos);
+    }
+
     /**
      * A debugging utility printing the internal structure of this map to the
      * given output stream.
@@ -1762,6 +1881,14 @@ public:
         return static_cast<const Derived&>(*this).contains((entry_type){{RamDomain(values)...}});
     }
 
+    /**
+     * A generic function enabling the removal of tuple values in a user-friendly way.
+     */
+    template <typename... Values>
+    bool erase(Values... values) {
+        return static_cast<Derived&>(*this).erase((entry_type){{RamDomain(values)...}});
+    }
+
     // ---------------------------------------------------------------------
     //                           Iterator
     // ---------------------------------------------------------------------
@@ -2164,6 +2291,7 @@ public:
     };
 
     using base::contains;
+    using base::erase;
     using base::insert;
 
     /**
@@ -2271,6 +2399,18 @@ public:
         return contains_internal<0>(tuple, ctxt);
     }
 
+    /**
+     * Removes the given tuple from this trie. Erasures must not run concurrently
+     * with any other operation, and invalidate the operation contexts of other
+     * operations on this trie.
+     *
+     * @param tuple the tuple to be removed
+     * @return true if the tuple has been present before, false otherwise
+     */
+    bool erase(const entry_type& tuple) {
+        return erase_internal<0>(tuple);
+    }
+
     /**
      * Inserts all elements stored within the given trie into this trie.
      *
@@ -2369,6 +2509,29 @@ public:
         return ctxt.lastBoundaries;
     }
 
+    /**
+     * Obtains the smallest value of the first component of the stored tuples
+     * not smaller than the given value w.r.t. the order of this trie. This is
+     * the seek operation of a leapfrog triejoin.
+     *
+     * @param value the value to start from, updated to the located value
+     * @return true if such a value exists, false otherwise
+     */
+    bool seek(RamDomain& value) const {
+        auto pos = store.lowerBound(value);
+        if (pos.isEnd()) return false;
+        value = RamDomain(pos->first);
+        return true;
+    }
+
+    /**
+     * Obtains the sub-trie of the tuples whose first component is the given
+     * value, nullptr if there is no such tuple.
+     */
+    const nested_trie_type* getNested(RamDomain value) const {
+        return store.lookup(value);
+    }
+
     /**
      * Computes a partition of an approximate number of chunks of the content
      * of this trie. Thus, the union of the resulting set of disjoint ranges is
@@ -2510,6 +2673,28 @@ private:
         // conduct recursive step
         return next && next->template contains_internal<I + 1>(tuple, ctxt.nestedCtxt);
     }
+
+    /**
+     * An internal implementation of the erase member function removing a given
+     * tuple from this sub-trie. Nested tries left empty are deleted.
+     *
+     * @tparam I the component index associated to this level
+     * @tparam Tuple the tuple type to be removed
+     * @param tuple the tuple to be removed
+     * @return true if this tuple has been present, false otherwise
+     */
+    template <unsigned I, typename Tuple>
+    bool erase_internal(const Tuple& tuple) {
+        nested_trie_type* next = store.lookup(tuple[I]);
+        if (!next || !next->template erase_internal<I + 1>(tuple)) {
+            return false;
+        }
+        if (next->empty()) {
+            delete next;
+            store.reset(tuple[I]);
+        }
+        return true;
+    }
 };
 
 /**
@@ -2537,6 +2722,7 @@ public:
     struct op_context {};
 
     using base::contains;
+    using base::erase;
     using base::insert;
 
     // a simple default constructor
@@ -2614,6 +2800,17 @@ public:
         return contains(tuple);
     }
 
+    /**
+     * Removes the 0-ary tuple from this trie.
+     *
+     * @return true if the trie has not been empty before, false otherwise
+     */
+    bool erase(const entry_type&) {
+        bool res = present;
+        present = false;
+        return res;
+    }
+
     // ---------------------------------------------------------------------
     //                           Iterator
     // ---------------------------------------------------------------------
@@ -2735,6 +2932,14 @@ private:
     bool contains_internal(const Tuple&, op_context&) const {
         return present;
     }
+
+    /**
+     * The internal implementation of the erase operation on this level.
+     */
+    template <unsigned I, typename Tuple>
+    bool erase_internal(const Tuple& tuple) {
+        return erase(tuple);
+    }
 };
 
 /**
@@ -2764,6 +2969,7 @@ public:
     using op_context = typename map_type::op_context;
 
     using base::contains;
+    using base::erase;
     using base::insert;
 
     /**
@@ -2841,6 +3047,18 @@ public:
         return contains_internal<0>(tuple, ctxt);
     }
 
+    /**
+     * Removes the given tuple from this trie. Erasures must not run concurrently
+     * with any other operation, and invalidate the operation contexts of other
+     * operations on this trie.
+     *
+     * @param tuple the tuple to be removed
+     * @return true if the tuple has been present before, false otherwise
+     */
+    bool erase(const entry_type& tuple) {
+        return erase_internal<0>(tuple);
+    }
+
     /**
      * Inserts all tuples stored within the given trie into this trie.
      * This operation is considerably more efficient than the consecutive
@@ -2998,6 +3216,20 @@ public:
         return make_range(iterator(pos), iterator(next));
     }
 
+    /**
+     * Obtains the smallest stored value not smaller than the given value w.r.t.
+     * the order of this trie. This is the seek operation of a leapfrog triejoin.
+     *
+     * @param value the value to start from, updated to the located value
+     * @return true if such a value exists, false otherwise
+     */
+    bool seek(RamDomain& value) const {
+        auto pos = map.lowerBound(value);
+        if (pos == map.end()) return false;
+        value = RamDomain(*pos);
+        return true;
+    }
+
     /**
      * Provides protected access to the internally maintained store.
      */
@@ -3049,6 +3281,107 @@ private:
     bool contains_internal(const Tuple& tuple, op_context& ctxt) const {
         return map.test(tuple[I], ctxt);
     }
+
+    /**
+     * An internal implementation of the erase member function removing a given
+     * tuple from this sub-trie.
+     *
+     * @tparam I the component index associated to this level
+     * @tparam Tuple the tuple type to be removed
+     * @param tuple the tuple to be removed
+     * @return true if this tuple has been present, false otherwise
+     */
+    template <unsigned I, typename Tuple>
+    bool erase_internal(const Tuple& tuple) {
+        return map.reset(tuple[I]);
+    }
 };
 
+// ---------------------------------------------------------------------
+//                      Leapfrog Triejoin
+// ---------------------------------------------------------------------
+
+namespace detail {
+
+// one round of seeks over all tries; clears stable if the value got advanced
+inline bool leapfrog_seek_round(RamDomain&, bool&) {
+    return true;
+}
+
+template <typename First, typename... Rest>
+bool leapfrog_seek_round(RamDomain& value, bool& stable, const First* first, const Rest*... rest) {
+    RamDomain cur = value;
+    if (!first->seek(cur)) return false;
+    if (cur != value) {
+        value = cur;
+        stable = false;
+    }
+    return leapfrog_seek_round(value, stable, rest...);
+}
+}  // namespace detail
+
+/**
+ * The search step of a leapfrog triejoin. Advances the given value to the
+ * smallest value not smaller than the given one that is contained in the
+ * first component of all the given tries.
+ *
+ * @param value the value to start from, updated to the located value
+ * @param tries the tries to be intersected
+ * @return true if such a value exists, false otherwise
+ */
+template <typename... Tries>
+bool leapfrogSeek(RamDomain& value, const Tries*... tries) {
+    bool stable = false;
+    while (!stable) {
+        stable = true;
+        if (!detail::leapfrog_seek_round(value, stable, tries...)) return false;
+    }
+    return true;
+}
+
+/**
+ * Advances the given value to its successor w.r.t. the order of tries.
+ *
+ * @return false if the given value is the last one in this order, true otherwise
+ */
+inline bool leapfrogNext(RamDomain& value) {
+    using index_type = typename std::make_unsigned<RamDomain>::type;
+    index_type next = index_type(value) + 1;
+    if (next == 0) return false;
+    value = RamDomain(next);
+    return true;
+}
+
+/** The first value w.r.t. the order of tries. */
+inline RamDomain leapfrogFirst() {
+    return 0;
+}
+
+/**
+ * Partitions the values of the first component of the given trie into chunks of
+ * about equal numbers of top-level elements, such that the iterations of a leapfrog
+ * triejoin over these values may be distributed among threads.
+ *
+ * @param trie the trie whose first component is partitioned
+ * @param chunks the number of chunks requested
+ * @return the smallest value of each chunk, in the order of tries
+ */
+template <typename Trie>
+std::vector<RamDomain> leapfrogPartition(const Trie& trie, unsigned chunks = 500) {
+    std::vector<RamDomain> bounds;
+    for (const auto& part : trie.partition(chunks)) {
+        bounds.push_back((*part.begin())[0]);
+    }
+    return bounds;
+}
+
+/**
+ * Checks whether the given value, not smaller than the smallest value of the given
+ * chunk of a partition obtained by leapfrogPartition, belongs to this chunk.
+ */
+inline bool leapfrogWithin(RamDomain value, const std::vector<RamDomain>& bounds, size_t chunk) {
+    using index_type = typename std::make_unsigned<RamDomain>::type;
+    return chunk + 1 == bounds.size() || index_type(value) < index_type(bounds[chunk + 1]);
+}
+
 }  // end namespace souffle
@@ -40,6 +40,7 @@
 #pragma once
 
 #include "BlockList.h"
+#include "MemoryUsage.h"
 #include "Util.h"
 
 #include <atomic>
@@ -317,6 +318,20 @@ public:
         nodeLock.unlock();
     }
 
+    /**
+     * Estimates the number of bytes occupied by the nodes and the member lists
+     * @return the number of bytes
+     */
+    size_t getMemoryUsage() const {
+        mapLock.lock_shared();
+        size_t res = a_blocks.getMemoryUsage() + getHashMemoryUsage(repToSubords);
+        for (const auto& cur : repToSubords) {
+            res += cur.second.getMemoryUsage() - sizeof(cur.second);
+        }
+        mapLock.unlock_shared();
+        return res;
+    }
+
     /**
      * Check whether the two indices are in the same set
      * @param x node to be checked
@@ -655,6 +670,18 @@ public:
         mapsLock.unlock();
     }
 
+    /**
+     * Estimates the number of bytes occupied by the dense set and the mappings
+     * @return the number of bytes
+     */
+    std::size_t getMemoryUsage() const {
+        mapsLock.lock_shared();
+        std::size_t res = ds.getMemoryUsage() + getHashMemoryUsage(sparseToDenseMap) +
+                          denseToSparseMap.capacity() * sizeof(SparseDomain);
+        mapsLock.unlock_shared();
+        return res;
+    }
+
     /**
      * Gets the number of the items in the underlying dense set (mapping from sparse->dense)
      * @param in the node which we count the size of it's representative map
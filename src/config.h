@@ -0,0 +1 @@
+#define PACKAGE_VERSION "dev"
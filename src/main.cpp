@@ -32,6 +32,7 @@
 #include "RamSemanticChecker.h"
 #include "RamTransformer.h"
 #include "RamTranslationUnit.h"
+#include "SouffleServer.h"
 #include "SymbolTable.h"
 #include "Synthesiser.h"
 #include "Util.h"
@@ -158,7 +159,7 @@ int main(int argc, char** argv) {
                             {"no-warn", 'w', "", "", false, "Disable warnings."},
                             {"magic-transform", 'm', "RELATIONS", "", false,
                                     "Enable magic set transformation changes on the given relations, use '*' "
-                                    "for all."},
+                                    "for all and 'auto' for those estimated to benefit."},
                             {"dl-program", 'o', "FILE", "", false,
                                     "Generate C++ source code, written to <FILE>, and compile this to a "
                                     "binary executable (without executing it)."},
@@ -171,7 +172,39 @@ int main(int argc, char** argv) {
                                     "Enable provenance information via guided SLD."},
 #endif
                             {"data-structure", 'd', "type", "", false,
-                                    "Specify data structure (brie/btree/eqrel/rbtset/hashset)."},
+                                    "Specify data structure "
+                                    "(brie/btree/eqrel/rbtset/hashset/columnar/compressed/spill)."},
+                            {"spill-budget", '\1', "MB", "", false,
+                                    "Spill relations to disk once they occupy more than <MB> megabytes."},
+                            {"spill-dir", '\2', "DIR", "", false,
+                                    "Specify directory for the files of spilled relations."},
+                            {"memory-limit", '\3', "MB", "", false,
+                                    "Abort with a report of the largest relations once they occupy more "
+                                    "than <MB> megabytes."},
+                            {"pin-threads", '\4', "", "", false,
+                                    "Pin threads to the NUMA nodes, keeping the memory they allocate local."},
+                            {"interleave-inputs", '\5', "", "", false,
+                                    "Interleave the memory of input relations across all NUMA nodes."},
+                            {"defer-indices", '\6', "", "", false,
+                                    "Build the secondary indices of non-recursive relations once computed."},
+                            {"incremental", '\7', "", "", false,
+                                    "Keep all relations, such that changes of input relations can be "
+                                    "propagated via the interface by evaluating affected strata only."},
+                            {"serve", '\10', "SOCKET", "", false,
+                                    "Keep the evaluated program resident and serve requests on the Unix "
+                                    "domain socket <SOCKET>."},
+                            {"outputs", '\11', "RELATIONS", "", false,
+                                    "Compute only the given comma-separated output relations and the "
+                                    "relations they depend on."},
+                            {"auto-schedule", '\12', "", "", false,
+                                    "Order the atoms of clauses without execution plans by the estimated "
+                                    "sizes of relations."},
+                            {"use-profile", '\13', "FILE", "", false,
+                                    "Use the profile log <FILE> of a previous run to order the atoms of hot "
+                                    "clauses and to choose data structures of relations."},
+                            {"share-joins", '\14', "", "", false,
+                                    "Compute joins starting several clauses of a stratum once, where "
+                                    "estimated to be beneficial."},
                             {"engine", 'e', "[ file ]", "", false,
                                     "Specify communication engine for distributed execution."},
                             {"verbose", 'v', "", "", false, "Verbose output."},
@@ -192,6 +225,25 @@ int main(int argc, char** argv) {
             ERROR("cannot open file " + std::string(Global::config().get("")));
         }
 
+        /* for the memory options, to check the budget of spilling relations and the memory limit */
+        if (Global::config().has("spill-budget")) {
+            if (!isNumber(Global::config().get("spill-budget").c_str()) ||
+                    std::stoll(Global::config().get("spill-budget")) < 0) {
+                ERROR("Wrong parameter " + Global::config().get("spill-budget") +
+                        " for option --spill-budget!");
+            }
+        }
+        if (Global::config().has("spill-dir") && !existDir(Global::config().get("spill-dir"))) {
+            ERROR("spill directory " + Global::config().get("spill-dir") + " does not exist");
+        }
+        if (Global::config().has("memory-limit")) {
+            if (!isNumber(Global::config().get("memory-limit").c_str()) ||
+                    std::stoll(Global::config().get("memory-limit")) < 0) {
+                ERROR("Wrong parameter " + Global::config().get("memory-limit") +
+                        " for option --memory-limit!");
+            }
+        }
+
         /* for the jobs option, to determine the number of threads used */
         if (Global::config().has("jobs")) {
             if (isNumber(Global::config().get("jobs").c_str())) {
@@ -266,6 +318,11 @@ int main(int argc, char** argv) {
         if (Global::config().has("live-profile") && !Global::config().has("profile")) {
             Global::config().set("profile");
         }
+
+        /* updates of a served program require its relations to be kept */
+        if (Global::config().has("serve")) {
+            Global::config().set("incremental");
+        }
     }
 
     // ------ start souffle -------------
@@ -356,7 +413,17 @@ int main(int argc, char** argv) {
             std::make_unique<RemoveRelationCopiesTransformer>(),
             std::make_unique<MaterializeAggregationQueriesTransformer>(),
             std::make_unique<RemoveEmptyRelationsTransformer>(),
+            std::make_unique<ConditionalTransformer>(
+                    Global::config().has("outputs"), std::make_unique<SelectOutputsTransformer>()),
             std::make_unique<RemoveRedundantRelationsTransformer>(), std::move(magicPipeline),
+            std::make_unique<ConditionalTransformer>(Global::config().has("share-joins"),
+                    std::make_unique<FixpointTransformer>(
+                            std::make_unique<MaterializeSharedJoinsTransformer>())),
+            std::make_unique<ConditionalTransformer>(
+                    Global::config().has("auto-schedule") || Global::config().has("use-profile"),
+                    std::make_unique<AutoScheduleTransformer>()),
+            std::make_unique<ConditionalTransformer>(Global::config().has("use-profile"),
+                    std::make_unique<SelectDataStructuresTransformer>()),
             std::make_unique<AstExecutionPlanChecker>(), std::move(provenancePipeline));
 
     // Set up the debug report if necessary
@@ -437,6 +504,16 @@ int main(int argc, char** argv) {
         }
 #endif
 
+        // keep the program resident to serve requests
+        if (Global::config().has("serve")) {
+            InterpreterProgInterface interface(*interpreter);
+            try {
+                serve(interface, Global::config().get("serve"), Global::config().get("fact-dir"));
+            } catch (std::exception& e) {
+                ERROR(e.what());
+            }
+        }
+
     } else {
         // ------- compiler -------------
 
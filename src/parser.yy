@@ -98,6 +98,9 @@
 %token EQREL_QUALIFIER           "equivalence relation qualifier"
 %token RBTSET_QUALIFIER          "red-black tree set relation qualifier"
 %token HASHSET_QUALIFIER         "hashset relation qualifier"
+%token COLUMNAR_QUALIFIER        "columnar relation qualifier"
+%token COMPRESSED_QUALIFIER      "compressed relation qualifier"
+%token SPILL_QUALIFIER           "spill relation qualifier"
 %token OVERRIDABLE_QUALIFIER     "relation qualifier overidable"
 %token INLINE_QUALIFIER          "relation qualifier inline"
 %token TMATCH                    "match predicate"
@@ -368,25 +371,37 @@ qualifiers
         $$ = $1 | INLINE_RELATION;
     }
   | qualifiers BRIE_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
         $$ = $1 | BRIE_RELATION;
     }
   | qualifiers BTREE_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
         $$ = $1 | BTREE_RELATION;
     }
   | qualifiers EQREL_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
         $$ = $1 | EQREL_RELATION;
     }
   | qualifiers RBTSET_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
         $$ = $1 | RBTSET_RELATION;
     }
   | qualifiers HASHSET_QUALIFIER {
-        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset qualifier already set");
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
         $$ = $1 | HASHSET_RELATION;
     }
+  | qualifiers COLUMNAR_QUALIFIER {
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
+        $$ = $1 | COLUMNAR_RELATION;
+    }
+  | qualifiers COMPRESSED_QUALIFIER {
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
+        $$ = $1 | COMPRESSED_RELATION;
+    }
+  | qualifiers SPILL_QUALIFIER {
+        if($1 & (BRIE_RELATION|BTREE_RELATION|EQREL_RELATION|RBTSET_RELATION|HASHSET_RELATION|COLUMNAR_RELATION|COMPRESSED_RELATION|SPILL_RELATION)) driver.error(@2, "btree/brie/eqrel/rbtset/hashset/columnar/compressed/spill qualifier already set");
+        $$ = $1 | SPILL_RELATION;
+    }
   | %empty {
         $$ = 0;
     }
@@ -103,6 +103,9 @@
 "inline"                              { return yy::parser::make_INLINE_QUALIFIER(yylloc); }
 "brie"                                { return yy::parser::make_BRIE_QUALIFIER(yylloc); }
 "btree"                               { return yy::parser::make_BTREE_QUALIFIER(yylloc); }
+"columnar"                            { return yy::parser::make_COLUMNAR_QUALIFIER(yylloc); }
+"compressed"                          { return yy::parser::make_COMPRESSED_QUALIFIER(yylloc); }
+"spill"                               { return yy::parser::make_SPILL_QUALIFIER(yylloc); }
 "min"                                 { return yy::parser::make_MIN(yylloc); }
 "max"                                 { return yy::parser::make_MAX(yylloc); }
 "nil"                                 { return yy::parser::make_NIL(yylloc); }
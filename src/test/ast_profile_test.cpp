@@ -0,0 +1,162 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ast_profile_test.cpp
+ *
+ * Tests the transformations guided by the profile log of a previous run.
+ *
+ ***********************************************************************/
+
+#include "AstProfileAnalysis.h"
+#include "AstProgram.h"
+#include "AstRelation.h"
+#include "AstTransforms.h"
+#include "AstTranslationUnit.h"
+#include "Global.h"
+#include "ParserDriver.h"
+#include "test.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+namespace souffle {
+
+namespace test {
+
+namespace {
+
+const std::string LOG_FILE = "/tmp/souffle_ast_profile_test.log";
+
+const std::string PROGRAM = R"(
+        .decl edge(x:number, y:number)
+        .input edge()
+        .decl small(x:number)
+        .input small()
+
+        .decl path(x:number, y:number)
+        .output path()
+        .decl reached(x:number, y:number)
+        .decl target(y:number)
+        .output target()
+        .decl hot(x:number)
+        .output hot()
+        .decl cold(x:number)
+        .output cold()
+
+        path(x, y) :- edge(x, y).
+        reached(x, y) :- edge(x, y).
+        target(y) :- reached(1, y).
+        hot(x) :- edge(x, y), edge(y, z), small(z).
+        cold(x) :- edge(x, y), edge(y, z), small(z).
+    )";
+
+/**
+ * Write a profile log of a run taking a second, recording the tuples of relations and the
+ * runtimes in microseconds of the first clauses of relations.
+ */
+void writeProfileLog(const AstProgram& program, const std::map<std::string, size_t>& tuples,
+        const std::map<std::string, long>& runtimes) {
+    std::ofstream log(LOG_FILE);
+    log << R"({"root": {"program": {"runtime": {"start": 0, "end": 1000000}, "relation": {)";
+    bool first = true;
+    for (const auto& cur : tuples) {
+        log << (first ? "" : ", ") << "\"" << cur.first << "\": {\"num-tuples\": " << cur.second;
+        auto pos = runtimes.find(cur.first);
+        if (pos != runtimes.end()) {
+            const AstClause* clause = program.getRelation(cur.first)->getClause(0);
+            log << R"(, "non-recursive-rule": {"rule": {"source-locator": ")" << clause->getSrcLoc()
+                << R"(", "runtime": {"start": 0, "end": )" << pos->second << "}}}";
+        }
+        log << "}";
+        first = false;
+    }
+    log << "}}}}";
+}
+
+}  // namespace
+
+TEST(ProfileUse, SelectsHashsetsAndHotClauses) {
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(PROGRAM, sym, e, d);
+    AstProgram& program = *tu->getProgram();
+
+    writeProfileLog(program,
+            {{"edge", 50000}, {"small", 2}, {"path", 50000}, {"reached", 50000}, {"target", 10},
+                    {"hot", 20}, {"cold", 20}},
+            {{"hot", 500000}, {"cold", 1000}});
+    Global::config().unset("auto-schedule");
+    Global::config().set("use-profile", LOG_FILE);
+
+    const auto* profile = tu->getAnalysis<ProfileUseAnalysis>();
+    EXPECT_TRUE(profile->hasSize("path"));
+    EXPECT_EQ(50000u, profile->getSize("path"));
+    EXPECT_FALSE(profile->hasSize("unknown"));
+
+    // clauses taking at least a hundredth of the runtime are hot
+    const AstClause* hot = program.getRelation("hot")->getClause(0);
+    const AstClause* cold = program.getRelation("cold")->getClause(0);
+    EXPECT_TRUE(profile->isHot(*hot));
+    EXPECT_FALSE(profile->isHot(*cold));
+
+    // only the atoms of hot clauses are reordered by the recorded sizes
+    EXPECT_TRUE(std::make_unique<AutoScheduleTransformer>()->apply(*tu));
+    EXPECT_NE(nullptr, program.getRelation("hot")->getClause(0)->getExecutionPlan());
+    EXPECT_EQ(nullptr, program.getRelation("cold")->getClause(0)->getExecutionPlan());
+
+    // large relations that are never searched on some of their columns become hash sets
+    EXPECT_TRUE(std::make_unique<SelectDataStructuresTransformer>()->apply(*tu));
+    EXPECT_TRUE(program.getRelation("path")->isHashset());
+    EXPECT_FALSE(program.getRelation("reached")->isHashset());
+    EXPECT_FALSE(program.getRelation("target")->isHashset());
+
+    Global::config().unset("use-profile");
+    std::remove(LOG_FILE.c_str());
+}
+
+TEST(ProfileUse, IgnoresMissingLog) {
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(PROGRAM, sym, e, d);
+
+    std::remove(LOG_FILE.c_str());
+    Global::config().set("use-profile", LOG_FILE);
+
+    EXPECT_FALSE(tu->getAnalysis<ProfileUseAnalysis>()->hasSize("path"));
+    EXPECT_FALSE(std::make_unique<SelectDataStructuresTransformer>()->apply(*tu));
+    EXPECT_FALSE(tu->getProgram()->getRelation("path")->isHashset());
+
+    Global::config().unset("use-profile");
+}
+
+TEST(ProfileUse, IgnoresMalformedLog) {
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(PROGRAM, sym, e, d);
+
+    {
+        std::ofstream log(LOG_FILE);
+        log << R"({"root": {"program": {"relation": {"path": {"num-tuples": 50000)";
+    }
+    Global::config().set("use-profile", LOG_FILE);
+
+    EXPECT_FALSE(tu->getAnalysis<ProfileUseAnalysis>()->hasSize("path"));
+    EXPECT_FALSE(std::make_unique<SelectDataStructuresTransformer>()->apply(*tu));
+    EXPECT_FALSE(tu->getProgram()->getRelation("path")->isHashset());
+
+    Global::config().unset("use-profile");
+    std::remove(LOG_FILE.c_str());
+}
+
+}  // end namespace test
+}  // end namespace souffle
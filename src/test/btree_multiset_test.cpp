@@ -372,6 +372,71 @@ TEST(BTreeMultiSet, Clear) {
     EXPECT_TRUE(t.empty());
 }
 
+TEST(BTreeMultiSet, Erase) {
+    using test_set = btree_multiset<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    EXPECT_FALSE(t.erase(1));
+
+    // three occurrences of each key
+    for (int r = 0; r < 3; r++) {
+        for (int i = 0; i < 500; i++) {
+            t.insert((i * 7919) % 500);
+        }
+    }
+    EXPECT_EQ(1500u, t.size());
+
+    // each erasure removes a single occurrence
+    for (int r = 3; r > 0; r--) {
+        for (int i = 0; i < 500; i += 2) {
+            EXPECT_TRUE(t.erase(i));
+        }
+        EXPECT_TRUE(t.check());
+        EXPECT_EQ(250u * (r - 1) + 750u, t.size());
+        int last = -1;
+        for (int cur : t) {
+            EXPECT_TRUE(last <= cur);
+            last = cur;
+        }
+    }
+    for (int i = 0; i < 500; i++) {
+        EXPECT_EQ(i % 2 == 1, t.contains(i));
+    }
+    EXPECT_FALSE(t.erase(0));
+
+    for (int r = 0; r < 3; r++) {
+        for (int i = 1; i < 500; i += 2) {
+            EXPECT_TRUE(t.erase(i));
+        }
+    }
+    EXPECT_TRUE(t.empty());
+}
+
+TEST(BTreeMultiSet, EraseInterleaved) {
+    using test_set = btree_multiset<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    // insertions into trees thinned out by erasures keep them ordered
+    test_set t;
+    std::multiset<int> expected;
+    srand(1);
+    for (int i = 0; i < 20000; i++) {
+        int k = rand() % 100;
+        if (rand() % 3) {
+            t.insert(k);
+            expected.insert(k);
+        } else {
+            auto pos = expected.find(k);
+            EXPECT_EQ(pos != expected.end(), t.erase(k));
+            if (pos != expected.end()) {
+                expected.erase(pos);
+            }
+        }
+    }
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ(expected.size(), t.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), t.begin()));
+}
+
 using Entry = std::tuple<int, int>;
 
 std::vector<Entry> getData(unsigned numEntries) {
@@ -427,6 +427,41 @@ TEST(BTreeSet, BoundaryTest) {
     EXPECT_EQ(++a, b);
 }
 
+// counts the lookups in which a simd-searched set disagrees with std::set
+template <typename T>
+int countSimdMismatches() {
+    using test_set = btree_set<T, detail::comparator<T>, std::allocator<T>, 256, detail::simd_search>;
+
+    test_set t;
+    std::set<T> ref;
+
+    srand(3);
+    for (int i = 0; i < 5000; i++) {
+        T value = (T)(rand() % 20000) - 10000;
+        t.insert(value);
+        ref.insert(value);
+    }
+
+    int errors = 0;
+    for (T i = -10010; i < 10010; i++) {
+        auto a = t.lower_bound(i);
+        auto b = ref.lower_bound(i);
+        errors += (a == t.end()) != (b == ref.end()) || (a != t.end() && *a != *b);
+
+        a = t.upper_bound(i);
+        b = ref.upper_bound(i);
+        errors += (a == t.end()) != (b == ref.end()) || (a != t.end() && *a != *b);
+
+        errors += t.contains(i) != (ref.find(i) != ref.end());
+    }
+    return errors;
+}
+
+TEST(BTreeSet, SimdSearch) {
+    EXPECT_EQ(0, countSimdMismatches<int32_t>());
+    EXPECT_EQ(0, countSimdMismatches<int64_t>());
+}
+
 TEST(BTreeSet, BoundaryEmpty) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -493,6 +528,114 @@ TEST(BTreeSet, Clear) {
     EXPECT_TRUE(t.empty());
 }
 
+TEST(BTreeSet, Refill) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    test_set o;
+    for (int i = 0; i < 1000; i++) {
+        o.insert(-i);
+    }
+
+    // cleared nodes are reused by subsequent insertions
+    for (int r = 1; r <= 3; r++) {
+        t.clear();
+        for (int i = 0; i < 1000 * r; i++) {
+            t.insert(i * r);
+        }
+        EXPECT_EQ(1000u * r, t.size());
+        EXPECT_TRUE(t.contains(999 * r));
+        EXPECT_FALSE(t.contains(-1));
+    }
+
+    // assignments replace the content of non-empty sets
+    t = o;
+    EXPECT_EQ(1000u, t.size());
+    EXPECT_TRUE(t.contains(-999));
+    EXPECT_FALSE(t.contains(1));
+
+    // swapped sets keep their nodes
+    t.swap(o);
+    o.clear();
+    EXPECT_EQ(1000u, t.size());
+    EXPECT_TRUE(t.contains(-999));
+}
+
+TEST(BTreeSet, Erase) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    EXPECT_FALSE(t.erase(1));
+
+    for (int i = 0; i < 1000; i++) {
+        t.insert(i);
+    }
+
+    // erase keys of inner nodes and leaves alike, in an order unrelated to the insertion
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back((i * 7919) % 1000);
+    }
+    std::set<int> expected(t.begin(), t.end());
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        EXPECT_TRUE(t.erase(keys[i]));
+        EXPECT_FALSE(t.erase(keys[i]));
+        expected.erase(keys[i]);
+        if (i % 97 == 0) {
+            EXPECT_TRUE(t.check());
+            EXPECT_EQ(expected.size(), t.size());
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(), t.begin()));
+        }
+    }
+    EXPECT_TRUE(t.empty());
+    EXPECT_TRUE(t.begin() == t.end());
+
+    // nodes released by erasures are reused by subsequent insertions
+    for (int i = 0; i < 100; i++) {
+        t.insert(i);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        EXPECT_TRUE(t.erase(i));
+    }
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ(50u, t.size());
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(i % 2 == 1, t.contains(i));
+    }
+}
+
+TEST(BTreeSet, EraseShuffled) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    std::vector<int> data;
+    for (int i = 0; i < 5000; i++) {
+        data.push_back(i);
+    }
+    random_shuffle(data.begin(), data.end());
+
+    test_set t(data.begin(), data.end());
+    random_shuffle(data.begin(), data.end());
+
+    // erasures and insertions of bulk-loaded and inserted trees keep them balanced and ordered
+    std::vector<int> sorted(t.begin(), t.end());
+    auto loaded = test_set::load(sorted.begin(), sorted.end());
+    for (int i = 0; i < 2500; i++) {
+        EXPECT_TRUE(t.erase(data[i]));
+        EXPECT_TRUE(loaded.erase(data[i]));
+        t.insert(-data[i]);
+    }
+    EXPECT_TRUE(t.check());
+    EXPECT_TRUE(loaded.check());
+    EXPECT_EQ(5000u, t.size());
+    EXPECT_EQ(2500u, loaded.size());
+    int last = -5000;
+    for (int cur : loaded) {
+        EXPECT_LT(last, cur);
+        EXPECT_TRUE(t.contains(cur));
+        last = cur;
+    }
+}
+
 TEST(BTreeSet, ChunkSplit) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -533,6 +533,459 @@ TEST(Relation, EqualRange) {
     EXPECT_EQ("{[2,4]}", toString(set));
 }
 
+TEST(Relation, LowerUpperRange) {
+    Relation<Auto, 3, index<0, 1, 2>, index<2, 0, 1>> rel;
+    using tuple_t = decltype(rel)::tuple_type;
+    auto ctxt = rel.createContext();
+
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 10; j++) {
+            rel.insert(i, j, j % 3);
+        }
+    }
+
+    // bounded second column after a fixed first column
+    std::set<tuple_t> set;
+    tuple_t low = {{2, 4, MIN_RAM_DOMAIN}};
+    tuple_t high = {{2, 6, MAX_RAM_DOMAIN}};
+    for (const auto& cur : rel.lowerUpperRange<index<0>, 1>(low, high, ctxt)) {
+        set.insert(cur);
+    }
+    EXPECT_EQ("{[2,4,1],[2,5,2],[2,6,0]}", toString(set));
+
+    // bounded leading column
+    int count = 0;
+    low = {{0, 0, 1}};
+    high = {{0, 0, 2}};
+    for (const auto& cur : rel.lowerUpperRange<index<>, 2>(low, high, ctxt)) {
+        EXPECT_NE(0, cur[2]);
+        count++;
+    }
+    EXPECT_EQ(5 * 6, count);
+
+    // crossing bounds yield an empty range
+    low = {{2, 6, 0}};
+    high = {{2, 4, 0}};
+    EXPECT_TRUE((rel.lowerUpperRange<index<0>, 1>(low, high, ctxt).empty()));
+
+    // no index ordered by the range column => equal-range on the prefix
+    count = 0;
+    low = {{2, 1, 0}};
+    high = {{2, 1, 0}};
+    for (const auto& cur : rel.lowerUpperRange<index<0>, 2>(low, high, ctxt)) {
+        EXPECT_EQ(2, cur[0]);
+        count++;
+    }
+    EXPECT_EQ(10, count);
+}
+
+TEST(Relation, Columnar) {
+    const int N = 3000;
+
+    using rel_type = Relation<Columnar, 10, index<1>, index<2, 0>>;
+    using tuple_type = typename rel_type::tuple_type;
+
+    rel_type rel;
+    auto ctxt = rel.createContext();
+
+    std::set<tuple_type> all;
+    for (int i = 0; i < N; i++) {
+        tuple_type cur;
+        for (int j = 0; j < 10; j++) {
+            cur[j] = i * 10 + j;
+        }
+        cur[1] = i % 7;
+        cur[2] = i % 5;
+        cur[0] = i % 3;
+        EXPECT_TRUE(rel.insert(cur));
+        EXPECT_FALSE(rel.insert(cur));
+        all.insert(cur);
+    }
+    EXPECT_EQ(N, rel.size());
+
+    // existence checks compare all columns
+    for (const auto& cur : all) {
+        EXPECT_TRUE(rel.contains(cur));
+        tuple_type other = cur;
+        other[9]++;
+        EXPECT_FALSE(rel.contains(other));
+    }
+
+    // scans assemble the stored tuples
+    std::set<tuple_type> scanned(rel.begin(), rel.end());
+    EXPECT_EQ(all, scanned);
+
+    // partitions cover all tuples
+    std::set<tuple_type> parts;
+    for (const auto& part : rel.partition()) {
+        for (const auto& cur : part) {
+            EXPECT_TRUE(parts.insert(cur).second);
+        }
+    }
+    EXPECT_EQ(all, parts);
+
+    // equal-range queries on a key column
+    tuple_type key = {{0, 3}};
+    int count = 0;
+    for (const auto& cur : rel.equalRange<1>(key, ctxt)) {
+        EXPECT_EQ(3, cur[1]);
+        EXPECT_TRUE(all.count(cur));
+        count++;
+    }
+    EXPECT_EQ((N + 3) / 7, count);
+
+    // equal-range queries on a permuted prefix of an index
+    key[0] = 1;
+    key[2] = 4;
+    count = 0;
+    for (const auto& cur : rel.equalRange<0, 2>(key, ctxt)) {
+        EXPECT_EQ(1, cur[0]);
+        EXPECT_EQ(4, cur[2]);
+        count++;
+    }
+    EXPECT_EQ(N / 15, count);
+
+    // range queries on the column following the prefix
+    tuple_type low = {{1, 0, 4}};
+    tuple_type high = {{2, 0, 4}};
+    count = 0;
+    for (const auto& cur : rel.lowerUpperRange<index<2>, 0>(low, high, ctxt)) {
+        EXPECT_NE(0, cur[0]);
+        EXPECT_EQ(4, cur[2]);
+        count++;
+    }
+    EXPECT_EQ(2 * N / 15, count);
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_TRUE(rel.begin() == rel.end());
+}
+
+TEST(Relation, Compressed) {
+    const int N = 20000;
+
+    using rel_type = Relation<Compressed, 2, index<0>, index<1, 0>>;
+    using tuple_type = typename rel_type::tuple_type;
+
+    rel_type rel;
+    auto ctxt = rel.createContext();
+
+    // insert in a scrambled order, covering negative and wide values
+    std::set<tuple_type> all;
+    for (int i = 0; i < N; i++) {
+        int j = (i * 7919) % N;
+        tuple_type cur = {{j / 10 - 1000, (j % 10) * 100000 - 3}};
+        EXPECT_TRUE(rel.insert(cur));
+        EXPECT_FALSE(rel.insert(cur));
+        all.insert(cur);
+    }
+    EXPECT_EQ(N, rel.size());
+
+    for (const auto& cur : all) {
+        EXPECT_TRUE(rel.contains(cur));
+        EXPECT_FALSE(rel.contains(tuple_type({{cur[0], cur[1] + 1}})));
+    }
+
+    // scans decompress the tuples in order
+    std::vector<tuple_type> scanned(rel.begin(), rel.end());
+    EXPECT_EQ(std::vector<tuple_type>(all.begin(), all.end()), scanned);
+
+    // partitions cover all tuples
+    std::set<tuple_type> parts;
+    for (const auto& part : rel.partition()) {
+        for (const auto& cur : part) {
+            EXPECT_TRUE(parts.insert(cur).second);
+        }
+    }
+    EXPECT_EQ(all, parts);
+
+    // equal-range queries on both indices
+    int count = 0;
+    for (const auto& cur : rel.equalRange<0>(tuple_type({{-1, 0}}), ctxt)) {
+        EXPECT_EQ(-1, cur[0]);
+        count++;
+    }
+    EXPECT_EQ(10, count);
+
+    count = 0;
+    for (const auto& cur : rel.equalRange<1>(tuple_type({{0, 299997}}), ctxt)) {
+        EXPECT_EQ(299997, cur[1]);
+        count++;
+    }
+    EXPECT_EQ(N / 10, count);
+
+    EXPECT_TRUE(rel.equalRange<0>(tuple_type({{N, 0}}), ctxt).empty());
+
+    // range queries on the second column
+    count = 0;
+    tuple_type low = {{5, 100000}};
+    tuple_type high = {{5, 400000}};
+    for (const auto& cur : rel.lowerUpperRange<index<0>, 1>(low, high, ctxt)) {
+        EXPECT_EQ(5, cur[0]);
+        count++;
+    }
+    EXPECT_EQ(3, count);
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_TRUE(rel.begin() == rel.end());
+    EXPECT_TRUE(rel.insert(tuple_type({{1, 2}})));
+    EXPECT_EQ(1, rel.size());
+}
+
+TEST(Relation, Spill) {
+    const int N = 20000;
+
+    using rel_type = Relation<Spill, 2, index<0>, index<1, 0>>;
+    using tuple_type = typename rel_type::tuple_type;
+
+    // a tiny budget forces the indices to spill repeatedly
+    SpillManager::instance().setBudget(1);
+
+    rel_type rel;
+    auto ctxt = rel.createContext();
+
+    std::set<tuple_type> all;
+    for (int i = 0; i < N; i++) {
+        int j = (i * 7919) % N;
+        tuple_type cur = {{j / 10, j % 10}};
+        EXPECT_TRUE(rel.insert(cur));
+        EXPECT_FALSE(rel.insert(cur));
+        all.insert(cur);
+    }
+    EXPECT_EQ(N, rel.size());
+    EXPECT_LT(SpillManager::instance().getResidentSize(), N * sizeof(tuple_type));
+
+    for (const auto& cur : all) {
+        EXPECT_TRUE(rel.contains(cur));
+        EXPECT_FALSE(rel.contains(tuple_type({{cur[0], cur[1] + 10}})));
+    }
+
+    // scans merge the spilled and the resident tuples
+    std::vector<tuple_type> scanned(rel.begin(), rel.end());
+    EXPECT_EQ(std::vector<tuple_type>(all.begin(), all.end()), scanned);
+
+    std::set<tuple_type> parts;
+    for (const auto& part : rel.partition()) {
+        for (const auto& cur : part) {
+            EXPECT_TRUE(parts.insert(cur).second);
+        }
+    }
+    EXPECT_EQ(all, parts);
+
+    int count = 0;
+    for (const auto& cur : rel.equalRange<0>(tuple_type({{7, 0}}), ctxt)) {
+        EXPECT_EQ(7, cur[0]);
+        count++;
+    }
+    EXPECT_EQ(10, count);
+
+    count = 0;
+    for (const auto& cur : rel.equalRange<1>(tuple_type({{0, 3}}), ctxt)) {
+        EXPECT_EQ(3, cur[1]);
+        count++;
+    }
+    EXPECT_EQ(N / 10, count);
+
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    EXPECT_TRUE(rel.begin() == rel.end());
+    EXPECT_TRUE(rel.insert(tuple_type({{1, 2}})));
+    EXPECT_EQ(1, rel.size());
+
+    SpillManager::instance().setBudget(0);
+}
+
+/* Obtains the memory usage of a relation when empty, filled with N tuples, and purged. */
+template <typename Setup>
+std::vector<std::size_t> getMemoryUsages(int N) {
+    using rel_type = Relation<Setup, 2, index<0, 1>, index<1, 0>>;
+    using tuple_type = ram::Tuple<RamDomain, 2>;
+
+    rel_type rel;
+    std::vector<std::size_t> res;
+    res.push_back(rel.getMemoryUsage());
+    for (int i = 0; i < N; i++) {
+        rel.insert(tuple_type({{i, i + 1}}));
+    }
+    res.push_back(rel.getMemoryUsage());
+    rel.purge();
+    res.push_back(rel.getMemoryUsage());
+    return res;
+}
+
+/* Determines whether the memory usage covers the plain size of the tuples and shrinks once purged. */
+template <typename Setup>
+bool isMemoryAccounted() {
+    const int N = 10000;
+    auto usage = getMemoryUsages<Setup>(N);
+    return usage[0] > 0 && usage[1] >= usage[0] + N * sizeof(ram::Tuple<RamDomain, 2>) && usage[2] < usage[1];
+}
+
+TEST(Relation, MemoryUsage) {
+    EXPECT_TRUE(isMemoryAccounted<Auto>());
+    EXPECT_TRUE(isMemoryAccounted<BTree>());
+    EXPECT_TRUE(isMemoryAccounted<Brie>());
+
+    // equivalence relations only store the classes of their elements
+    auto eqrel = getMemoryUsages<EqRel>(10000);
+    EXPECT_LT(eqrel[0], eqrel[1]);
+    EXPECT_LT(eqrel[2], eqrel[1]);
+
+    EXPECT_TRUE(isMemoryAccounted<Rbtset>());
+    EXPECT_TRUE(isMemoryAccounted<Hashset>());
+    EXPECT_TRUE(isMemoryAccounted<Columnar>());
+    EXPECT_TRUE(isMemoryAccounted<Compressed>());
+
+    // the report lists the largest consumers first
+    MemoryReport report;
+    report.add("small", 10);
+    report.add("large", 2048);
+    EXPECT_EQ(2058, report.getTotal());
+    EXPECT_EQ("large", report.getTopConsumers()[0].first);
+    EXPECT_EQ("2.0KiB", MemoryReport::formatBytes(2048));
+}
+
+/* Counts the tuples with a last column of 3 found via a secondary index built after the insertions. */
+template <typename Setup, unsigned arity>
+int countDeferred(int N) {
+    using tuple_type = ram::Tuple<RamDomain, arity>;
+    Relation<Setup, arity, typename index_utils::get_full_index<arity>::type, index<arity - 1>> rel;
+
+    rel.deferIndices();
+    tuple_type tuple;
+    for (int i = 0; i < N; i++) {
+        for (unsigned j = 0; j < arity; j++) {
+            tuple[j] = i;
+        }
+        tuple[arity - 1] = i % 10;
+        rel.insert(tuple);
+    }
+    rel.buildIndices();
+
+    // insertions after the build maintain all indices again
+    tuple[0] = N;
+    tuple[arity - 1] = 3;
+    rel.insert(tuple);
+
+    int res = 0;
+    for (const auto& cur : rel.template equalRange<arity - 1>(tuple)) {
+        res += (cur[arity - 1] == 3) ? 1 : -N;
+    }
+    return res;
+}
+
+TEST(Relation, DeferredIndices) {
+    const int N = 10000;
+    EXPECT_EQ(N / 10 + 1, (countDeferred<Auto, 2>(N)));
+    EXPECT_EQ(N / 10 + 1, (countDeferred<Auto, 3>(N)));
+    EXPECT_EQ(N / 10 + 1, (countDeferred<Auto, 7>(N)));
+    EXPECT_EQ(N / 10 + 1, (countDeferred<BTree, 3>(N)));
+    EXPECT_EQ(N / 10 + 1, (countDeferred<Brie, 3>(N)));
+}
+
+/* Counts the failed checks of erasures of single tuples and of the tuples of another relation. */
+template <typename Setup, unsigned arity>
+int countEraseFailures(int N) {
+    using tuple_type = ram::Tuple<RamDomain, arity>;
+    using rel_type = Relation<Setup, arity, typename index_utils::get_full_index<arity>::type, index<arity - 1>>;
+    rel_type rel;
+    rel_type other;
+
+    tuple_type tuple;
+    for (int i = 0; i < N; i++) {
+        for (unsigned j = 0; j < arity; j++) {
+            tuple[j] = i;
+        }
+        tuple[arity - 1] = i % 10;
+        rel.insert(tuple);
+        if (i % 4 == 1) {
+            other.insert(tuple);
+        }
+    }
+
+    // erase the tuples of even keys one by one
+    int res = 0;
+    for (int i = 0; i < N; i += 2) {
+        for (unsigned j = 0; j < arity; j++) {
+            tuple[j] = i;
+        }
+        tuple[arity - 1] = i % 10;
+        res += (rel.erase(tuple) && !rel.erase(tuple) && !rel.contains(tuple)) ? 0 : 1;
+    }
+    res += (rel.size() == std::size_t(N / 2)) ? 0 : 1;
+
+    // secondary indices no longer list erased tuples
+    tuple[arity - 1] = 3;
+    int count = 0;
+    for (const auto& cur : rel.template equalRange<arity - 1>(tuple)) {
+        count += (cur[0] % 2 == 1 && cur[arity - 1] == 3) ? 1 : -N;
+    }
+    res += (count == N / 10) ? 0 : 1;
+
+    // erase the tuples of another relation in one go
+    rel.eraseAll(other);
+    res += (rel.size() == std::size_t(N / 4)) ? 0 : 1;
+    for (const auto& cur : rel) {
+        res += (cur[0] % 4 == 3) ? 0 : 1;
+    }
+    rel.eraseAll(rel);
+    res += rel.empty() ? 0 : 1;
+    return res;
+}
+
+TEST(Relation, Erase) {
+    const int N = 2000;
+    EXPECT_EQ(0, (countEraseFailures<Auto, 2>(N)));
+    EXPECT_EQ(0, (countEraseFailures<Auto, 3>(N)));
+    EXPECT_EQ(0, (countEraseFailures<Auto, 7>(N)));
+    EXPECT_EQ(0, (countEraseFailures<BTree, 3>(N)));
+    EXPECT_EQ(0, (countEraseFailures<Brie, 3>(N)));
+    EXPECT_EQ(0, (countEraseFailures<Columnar, 3>(N)));
+
+    Relation<Auto, 1> unary;
+    unary.insert(1);
+    unary.insert(2);
+    EXPECT_TRUE(unary.erase(1));
+    EXPECT_FALSE(unary.erase(1));
+    EXPECT_EQ(1, unary.size());
+    EXPECT_TRUE(unary.contains(2));
+
+    Relation<Auto, 0> nullary;
+    nullary.insert();
+    EXPECT_TRUE(nullary.erase());
+    EXPECT_FALSE(nullary.erase());
+    EXPECT_TRUE(nullary.empty());
+}
+
+TEST(ColumnStore, NarrowColumns) {
+    using tuple_type = ram::Tuple<RamDomain, 3>;
+    using store_type = detail::ColumnStore<tuple_type>;
+    const int N = 2 * store_type::BLOCK_SIZE;
+
+    store_type store;
+    EXPECT_EQ(0, store.getMemoryUsage());
+
+    // a flag, a column outgrowing 16 bits within the second block, and a negative column
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(static_cast<size_t>(i), store.append(tuple_type({{i % 2, i * 24, -i}})));
+    }
+    EXPECT_EQ(N, store.size());
+
+    for (int i = 0; i < N; i++) {
+        tuple_type cur;
+        store.load(i, cur);
+        EXPECT_EQ(tuple_type({{i % 2, i * 24, -i}}), cur);
+    }
+
+    // the first block needs 1, 2 and 2 bytes per value, the second 1, 4 and 2
+    EXPECT_EQ(store_type::BLOCK_SIZE * (5 + 7), store.getMemoryUsage());
+
+    store.clear();
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(0, store.getMemoryUsage());
+}
+
 TEST(Relation, NullArity) {
     Relation<Auto, 0> rel;
     EXPECT_EQ(0, sizeof(Relation<Auto, 0>::tuple_type));  // strange, but true
@@ -871,5 +1324,65 @@ TEST(Relation, PartitionBug_InsertAll) {
     EXPECT_EQ(all, is);
 }
 
+TEST(Relation, Filter) {
+    typedef Tuple<RamDomain, 3> tuple_type;
+
+    Relation<BTree, 3, index<1>, index<0, 2>> btree;
+    Relation<Brie, 3, index<1>, index<0, 2>> brie;
+    btree.enableFilter<index<1>>();
+    btree.enableFilter<index<0, 1, 2>>();
+    brie.enableFilter<index<0, 2>>();
+
+    for (int i = 0; i < 10000; i += 2) {
+        btree.insert(i % 50, i, i % 30);
+        brie.insert(i % 50, i, i % 30);
+    }
+
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_EQ(i % 2 == 0, btree.contains(i % 50, i, i % 30));
+        EXPECT_EQ(i % 2 == 0, !btree.equalRange<index<1>>(tuple_type({{0, i, 0}})).empty());
+        bool found = !brie.equalRange<index<0, 2>>(tuple_type({{i % 50, 0, i % 30}})).empty();
+        EXPECT_EQ(i % 2 == 0, found);
+    }
+
+    // filters are reset when purging relations
+    btree.purge();
+    btree.insert(1, 3, 5);
+    EXPECT_TRUE(btree.contains(1, 3, 5));
+    EXPECT_FALSE(btree.contains(0, 0, 0));
+    EXPECT_TRUE(btree.equalRange<index<1>>(tuple_type({{0, 0, 0}})).empty());
+    EXPECT_FALSE(btree.equalRange<index<1>>(tuple_type({{0, 3, 0}})).empty());
+}
+
+TEST(HashJoinTable, EqualRange) {
+    typedef Tuple<RamDomain, 3> tuple_type;
+
+    Relation<BTree, 3> rel;
+    for (int i = 0; i < 100; i++) {
+        rel.insert(i % 5, i, i % 3);
+    }
+
+    HashJoinTable<3, index<0, 2>> table;
+    table.insertAll(rel);
+
+    for (int a = 0; a < 6; a++) {
+        for (int c = 0; c < 4; c++) {
+            std::set<tuple_type> should;
+            for (const auto& cur : rel) {
+                if (cur[0] == a && cur[2] == c) {
+                    should.insert(cur);
+                }
+            }
+
+            std::set<tuple_type> is;
+            for (const auto& cur : table.equalRange(tuple_type({{a, 0, c}}))) {
+                EXPECT_TRUE(is.insert(cur).second) << "Duplicate: " << cur;
+            }
+
+            EXPECT_EQ(should, is);
+        }
+    }
+}
+
 }  // namespace ram
 }  // end namespace souffle
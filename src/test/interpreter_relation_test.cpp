@@ -0,0 +1,151 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2013, 2015, Oracle and/or its affiliates. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file interpreter_relation_test.h
+ *
+ * A test case testing the relations of the interpreter.
+ *
+ ***********************************************************************/
+
+#include "InterpreterRelation.h"
+#include "test.h"
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+using namespace souffle;
+
+namespace test {
+
+namespace {
+
+// counts the indexed ranges of the relation disagreeing with the given tuples
+size_t countMismatches(const InterpreterRelation& rel, const std::set<std::vector<RamDomain>>& expected) {
+    size_t res = 0;
+    std::set<std::vector<RamDomain>> stored;
+    for (const RamDomain* cur : rel) {
+        stored.insert(std::vector<RamDomain>(cur, cur + rel.getArity()));
+    }
+    res += (stored != expected) ? 1 : 0;
+    res += (rel.size() != expected.size()) ? 1 : 0;
+
+    // look up each tuple through an index on its second column
+    InterpreterIndex* index = rel.getIndex(2);
+    for (const auto& cur : expected) {
+        RamDomain low[3] = {MIN_RAM_DOMAIN, cur[1], MIN_RAM_DOMAIN};
+        RamDomain high[3] = {MAX_RAM_DOMAIN, cur[1], MAX_RAM_DOMAIN};
+        size_t count = 0;
+        auto range = index->lowerUpperBound(low, high);
+        for (auto it = range.first; it != range.second; ++it) {
+            count += ((*it)[1] == cur[1]) ? 1 : 0;
+        }
+        size_t num = 0;
+        for (const auto& other : expected) {
+            num += (other[1] == cur[1]) ? 1 : 0;
+        }
+        res += (count != num) ? 1 : 0;
+        res += rel.exists(cur.data()) ? 0 : 1;
+    }
+    return res;
+}
+
+// erases random tuples of a relation filled with random tuples, returning the number of failed checks
+size_t countEraseFailures(InterpreterRelation& rel) {
+    srand(1);
+    std::set<std::vector<RamDomain>> expected;
+    size_t res = 0;
+    for (int i = 0; i < 5000; i++) {
+        std::vector<RamDomain> cur = {rand() % 50, rand() % 20, rand() % 10};
+        if (rand() % 3 == 0) {
+            bool existed = expected.erase(cur) > 0;
+            res += (rel.erase(cur.data()) != existed) ? 1 : 0;
+            res += rel.exists(cur.data()) ? 1 : 0;
+        } else {
+            expected.insert(cur);
+            rel.insert(cur.data());
+        }
+        if (i % 500 == 0) {
+            res += countMismatches(rel, expected);
+        }
+    }
+    res += countMismatches(rel, expected);
+    for (const auto& cur : std::set<std::vector<RamDomain>>(expected)) {
+        res += rel.erase(cur.data()) ? 0 : 1;
+        expected.erase(cur);
+    }
+    res += countMismatches(rel, expected);
+    res += rel.empty() ? 0 : 1;
+    return res;
+}
+
+}  // namespace
+
+TEST(InterpreterRelation, Erase) {
+    InterpreterRelation rel(3);
+
+    rel.insert(1, 2, 3);
+    rel.insert(4, 5, 6);
+    rel.insert(7, 8, 9);
+    EXPECT_TRUE(rel.erase(1, 2, 3));
+    EXPECT_FALSE(rel.erase(1, 2, 3));
+    EXPECT_EQ(2, rel.size());
+
+    // the last tuple takes the place of the erased one
+    auto it = rel.begin();
+    EXPECT_EQ(7, (*it)[0]);
+    ++it;
+    EXPECT_EQ(4, (*it)[0]);
+
+    // tuples stored by the relation itself can be erased
+    EXPECT_TRUE(rel.erase(*rel.begin()));
+    EXPECT_EQ(1, rel.size());
+    EXPECT_TRUE(rel.exists(std::vector<RamDomain>({4, 5, 6}).data()));
+
+    InterpreterRelation nullary(0);
+    EXPECT_FALSE(nullary.erase(nullptr));
+    nullary.insert(nullptr);
+    EXPECT_TRUE(nullary.erase(nullptr));
+    EXPECT_TRUE(nullary.empty());
+}
+
+TEST(InterpreterRelation, EraseStress) {
+    InterpreterRelation rel(3);
+    EXPECT_EQ(0, countEraseFailures(rel));
+
+    // compact indexes refer to the stored tuples, which are moved by erasures
+    InterpreterRelation columnar(3, true);
+    EXPECT_EQ(0, countEraseFailures(columnar));
+
+    // spilled tuples are erased from the runs of the indexes
+    SpillManager::instance().setBudget(1);
+    InterpreterRelation spill(3, false, true);
+    EXPECT_EQ(0, countEraseFailures(spill));
+    SpillManager::instance().setBudget(0);
+}
+
+TEST(InterpreterEqRelation, Erase) {
+    InterpreterEqRelation rel(2);
+
+    RamDomain a[2] = {1, 2};
+    RamDomain b[2] = {3, 3};
+    rel.insert(a);
+    rel.insert(b);
+    EXPECT_EQ(5, rel.size());
+
+    // pairs implied by the remaining ones remain
+    EXPECT_FALSE(rel.erase(a));
+    EXPECT_EQ(5, rel.size());
+
+    EXPECT_TRUE(rel.erase(b));
+    EXPECT_EQ(4, rel.size());
+}
+
+}  // namespace test
@@ -90,6 +90,25 @@ TEST(SymbolTable, Assign) {
     EXPECT_STREQ("Hello", c.resolve(c_idx));
 }
 
+TEST(SymbolTable, Batch) {
+    SymbolTable table;
+    table.insert("b");
+
+    std::string symbols[] = {"a", "b", "a", "c"};
+    RamDomain indices[4];
+    table.lookup(symbols, 4, indices);
+
+    EXPECT_EQ(3, table.size());
+    EXPECT_EQ(table.lookup("b"), indices[1]);
+    EXPECT_EQ(indices[0], indices[2]);
+
+    const std::string* resolved[4];
+    table.resolve(indices, 4, resolved);
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ(symbols[i], *resolved[i]);
+    }
+}
+
 TEST(SymbolTable, Inserts) {
     // whether to print the recorded times to stdout
     // should be false unless developing
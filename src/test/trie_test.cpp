@@ -16,7 +16,11 @@
 
 #include "Trie.h"
 #include "test.h"
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <set>
+#include <vector>
 
 using namespace souffle;
 
@@ -315,6 +319,76 @@ TEST(SparseArray, LowerBound) {
     EXPECT_EQ(m.end(), m.lowerBound(500));
 }
 
+TEST(SparseArray, Reset) {
+    SparseArray<int> m;
+
+    // resetting missing values is fine
+    m.reset(12);
+    EXPECT_TRUE(m.empty());
+
+    m.update(12, 1);
+    m.update(14, 2);
+    m.update(1000, 3);
+    m.update(100000, 4);
+
+    // values of the first node
+    m.reset(12);
+    EXPECT_EQ(0, m[12]);
+    EXPECT_EQ(2, m[14]);
+    EXPECT_EQ(3, m.size());
+    EXPECT_EQ(m.find(14), m.begin());
+
+    // the first node is released, the first value moves to another node
+    m.reset(14);
+    EXPECT_EQ(2, m.size());
+    EXPECT_EQ(m.find(1000), m.begin());
+    EXPECT_EQ(1000, m.begin()->first);
+
+    m.reset(100000);
+    EXPECT_EQ(1, m.size());
+    EXPECT_EQ(m.find(1000), m.begin());
+    EXPECT_EQ(m.end(), m.lowerBound(1001));
+
+    // the array becomes empty, and may be refilled
+    m.reset(1000);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.end(), m.begin());
+
+    m.update(5, 6);
+    EXPECT_EQ(1, m.size());
+    EXPECT_EQ(6, m.begin()->second);
+}
+
+TEST(SparseArray, ResetStress) {
+    const int N = 10000;
+
+    SparseArray<int> m;
+    std::set<int> should;
+    for (int i = 0; i < N; i++) {
+        int pos = random() % (N * 10);
+        m.update(pos, pos + 1);
+        should.insert(pos);
+    }
+
+    // reset half of the values, in an order unrelated to their positions
+    std::vector<int> pos(should.begin(), should.end());
+    random_shuffle(pos.begin(), pos.end());
+    for (std::size_t i = 0; i < pos.size() / 2; i++) {
+        m.reset(pos[i]);
+        should.erase(pos[i]);
+    }
+
+    // iteration covers exactly the remaining values
+    auto it = should.begin();
+    for (const auto& cur : m) {
+        ASSERT_TRUE(it != should.end());
+        EXPECT_EQ(*it, (int)cur.first);
+        EXPECT_EQ(*it + 1, cur.second);
+        ++it;
+    }
+    EXPECT_TRUE(it == should.end());
+}
+
 TEST(SparseArray, MemoryUsage) {
     if (sizeof(void*) > 4) {
         SparseArray<int> a;
@@ -534,6 +608,30 @@ TEST(SparseBitMap, Size) {
     EXPECT_EQ(3, map.size());
 }
 
+TEST(SparseBitMap, Reset) {
+    SparseBitMap<> map;
+    map.set(3);
+    map.set(5);
+    map.set(1000);
+
+    EXPECT_TRUE(map.reset(3));
+    EXPECT_FALSE(map.reset(3));
+    EXPECT_FALSE(map.reset(4));
+    EXPECT_FALSE(map[3]);
+    EXPECT_TRUE(map[5]);
+    EXPECT_EQ(2, map.size());
+    EXPECT_EQ(5, *map.begin());
+
+    // the block of the first bits is released
+    EXPECT_TRUE(map.reset(5));
+    EXPECT_EQ(1, map.size());
+    EXPECT_EQ(1000, *map.begin());
+
+    EXPECT_TRUE(map.reset(1000));
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.end(), map.begin());
+}
+
 TEST(SparseBitMap, CopyAndMerge) {
     SparseBitMap<> mapA;
     SparseBitMap<> mapB;
@@ -1242,6 +1340,71 @@ TEST(Trie, Limits) {
     EXPECT_EQ(2, counter);
 }
 
+TEST(Trie, Erase) {
+    Trie<2> t;
+    EXPECT_FALSE(t.erase(1, 2));
+
+    t.insert(1, 2);
+    t.insert(1, 3);
+    t.insert(2, 1);
+    EXPECT_EQ(3, t.size());
+
+    EXPECT_TRUE(t.erase(1, 2));
+    EXPECT_FALSE(t.erase(1, 2));
+    EXPECT_FALSE(t.erase(3, 1));
+    EXPECT_FALSE(t.contains(1, 2));
+    EXPECT_TRUE(t.contains(1, 3));
+    EXPECT_EQ(2, t.size());
+
+    // nested tries left empty are released
+    EXPECT_TRUE(t.erase(1, 3));
+    EXPECT_EQ(1, t.size());
+    EXPECT_EQ(2, (*t.begin())[0]);
+    EXPECT_EQ(1, (*t.begin())[1]);
+
+    EXPECT_TRUE(t.erase(2, 1));
+    EXPECT_TRUE(t.empty());
+    EXPECT_TRUE(t.begin() == t.end());
+
+    // the trie may be refilled
+    t.insert(4, 5);
+    EXPECT_EQ(1, t.size());
+    EXPECT_TRUE(t.contains(4, 5));
+}
+
+TEST(Trie, EraseStress_3D) {
+    const int N = 10000;
+
+    Trie<3> t;
+    std::set<std::array<RamDomain, 3>> should;
+    for (int i = 0; i < N; i++) {
+        std::array<RamDomain, 3> cur = {{(RamDomain)(random() % 10), (RamDomain)(random() % 100),
+                (RamDomain)(random() % 1000)}};
+        t.insert(cur[0], cur[1], cur[2]);
+        should.insert(cur);
+    }
+
+    std::vector<std::array<RamDomain, 3>> erased(should.begin(), should.end());
+    random_shuffle(erased.begin(), erased.end());
+    erased.resize(erased.size() / 2);
+    for (const auto& cur : erased) {
+        EXPECT_TRUE(t.erase(cur[0], cur[1], cur[2]));
+        should.erase(cur);
+    }
+    EXPECT_EQ(should.size(), t.size());
+
+    // iteration covers exactly the remaining tuples
+    auto it = should.begin();
+    for (const auto& cur : t) {
+        ASSERT_TRUE(it != should.end());
+        EXPECT_EQ((*it)[0], cur[0]);
+        EXPECT_EQ((*it)[1], cur[1]);
+        EXPECT_EQ((*it)[2], cur[2]);
+        ++it;
+    }
+    EXPECT_TRUE(it == should.end());
+}
+
 TEST(Trie, Parallel) {
     const int N = 10000;
 
@@ -1310,3 +1473,73 @@ TEST(Trie, Parallel) {
         EXPECT_EQ(should, is);
     }
 }
+
+TEST(Trie, Seek) {
+    Trie<2> a;
+    Trie<1> b;
+
+    RamDomain v = 0;
+    EXPECT_FALSE(a.seek(v));
+    EXPECT_FALSE(b.seek(v));
+
+    for (int i = 0; i < 200; i += 3) {
+        a.insert({i, i + 1});
+    }
+    a.insert({-5, 1});
+    for (int i = 0; i < 200; i += 2) {
+        b.insert({i});
+    }
+    b.insert({-5});
+
+    // negative values are ordered after all positive values
+    for (RamDomain i : {0, 1, 100, 181, 198, 199, 5000, -6, -5, -4}) {
+        RamDomain x = i;
+        bool found = a.seek(x);
+        RamDomain y = i;
+        bool foundB = b.seek(y);
+        if (0 <= i && i <= 198) {
+            EXPECT_TRUE(found);
+            EXPECT_EQ(i + (3 - i % 3) % 3, x);
+            EXPECT_TRUE(foundB);
+            EXPECT_EQ(i + i % 2, y);
+        } else if (i != -4) {
+            EXPECT_TRUE(found);
+            EXPECT_EQ(-5, x);
+            EXPECT_TRUE(foundB);
+            EXPECT_EQ(-5, y);
+        } else {
+            EXPECT_FALSE(found);
+            EXPECT_FALSE(foundB);
+        }
+    }
+
+    EXPECT_TRUE(a.getNested(3) != nullptr);
+    EXPECT_TRUE(a.getNested(4) == nullptr);
+    EXPECT_TRUE(a.getNested(3)->contains({4}));
+}
+
+TEST(Trie, LeapfrogSeek) {
+    Trie<2> a;
+    Trie<2> b;
+    Trie<1> c;
+
+    for (int i = 0; i < 200; i += 3) {
+        a.insert({i, i + 1});
+    }
+    for (int i = 0; i < 200; i += 5) {
+        b.insert({i, 2});
+    }
+    for (int i = 0; i < 200; i += 2) {
+        c.insert({i});
+    }
+    a.insert({-5, 1});
+    b.insert({-5, 3});
+    c.insert({-5});
+
+    std::vector<RamDomain> res;
+    RamDomain v = leapfrogFirst();
+    for (bool f = leapfrogSeek(v, &a, &b, &c); f; f = leapfrogNext(v) && leapfrogSeek(v, &a, &b, &c)) {
+        res.push_back(v);
+    }
+    EXPECT_EQ("[0,30,60,90,120,150,180,-5]", toString(res));
+}
@@ -0,0 +1,224 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program inserting and exporting tuples of relations in bulk
+ *
+ ***********************************************************************/
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Print the given tuples
+ */
+void print(const std::vector<RamDomain> &rows, size_t count, size_t arity, std::string title)
+{
+   std::cout << title << ":";
+   for(size_t i = 0; i < count; i++) {
+      std::cout << " ";
+      for(size_t j = 0; j < arity; j++) {
+         std::cout << (j > 0 ? "," : "") << rows[i * arity + j];
+      }
+   }
+   std::cout << "\n";
+}
+
+/**
+ * Print the tuples of a relation agreeing with a pattern on the given columns
+ */
+void lookup(Relation *rel, const tuple &pattern, SearchColumns columns, std::string title)
+{
+   std::cout << title << ":";
+   for(auto &t : rel->equalRange(pattern, columns)) {
+      std::cout << " ";
+      for(size_t i = 0; i < rel->getArity(); i++) {
+         std::cout << (i > 0 ? "," : "") << t[i];
+      }
+   }
+   std::cout << "\n";
+}
+
+/**
+ * Binary relation only providing single tuple insertion and iteration, relying on
+ * the default implementations of the bulk operations
+ */
+class PairRelation : public Relation {
+   std::vector<std::vector<RamDomain>> rows;
+
+   class iterator_pair : public iterator_base {
+      const PairRelation *rel;
+      size_t pos;
+      tuple current;
+
+   public:
+      iterator_pair(const PairRelation *rel, size_t pos)
+            : iterator_base(1), rel(rel), pos(pos), current(rel) {}
+      void operator++() override {
+         pos++;
+      }
+      tuple &operator*() override {
+         current[0] = rel->rows[pos][0];
+         current[1] = rel->rows[pos][1];
+         return current;
+      }
+      iterator_base *clone() const override {
+         return new iterator_pair(rel, pos);
+      }
+
+   protected:
+      bool equal(const iterator_base &o) const override {
+         return pos == static_cast<const iterator_pair &>(o).pos;
+      }
+   };
+
+public:
+   void insert(const tuple &t) override {
+      if(!contains(t)) {
+         rows.push_back({t[0], t[1]});
+      }
+   }
+   bool contains(const tuple &t) const override {
+      for(const auto &row : rows) {
+         if(row[0] == t[0] && row[1] == t[1]) {
+            return true;
+         }
+      }
+      return false;
+   }
+   iterator_range equalRange(const tuple &, SearchColumns) const override {
+      return iterator_range(begin(), end());
+   }
+   iterator begin() const override {
+      return iterator(new iterator_pair(this, 0));
+   }
+   iterator end() const override {
+      return iterator(new iterator_pair(this, rows.size()));
+   }
+   std::size_t size() override {
+      return rows.size();
+   }
+   bool isOutput() const override {
+      return false;
+   }
+   bool isInput() const override {
+      return false;
+   }
+   std::string getName() const override {
+      return "pair";
+   }
+   const char *getAttrType(size_t) const override {
+      return "i:number";
+   }
+   const char *getAttrName(size_t idx) const override {
+      return idx == 0 ? "x" : "y";
+   }
+   size_t getArity() const override {
+      return 2;
+   }
+   SymbolTable &getSymbolTable() const override {
+      static SymbolTable symbolTable;
+      return symbolTable;
+   }
+};
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   if(argc < 2) {
+      error("no fact directory specified");
+   }
+
+   // create an instance of program "bulk_insert"
+   if(SouffleProgram *prog = ProgramFactory::newInstance("bulk_insert")) {
+      prog->loadAll(argv[1]);
+      Relation *edge = prog->getRelation("edge");
+
+      // a batch at least as large as the relation defers its secondary indices
+      std::vector<RamDomain> batch = {2, 3, 4, 3, 5, 6, 1, 2};
+      edge->insertAll(batch.data(), 4);
+      std::cout << "edge size: " << edge->size() << "\n";
+      lookup(edge, tuple(edge, {0, 3}), 2, "edge(_,3)");
+
+      // a smaller batch is inserted into all indices directly
+      std::vector<RamDomain> single = {6, 3};
+      edge->insertAll(single.data(), 1);
+      lookup(edge, tuple(edge, {0, 3}), 2, "edge(_,3)");
+
+      // tuples given by columns
+      std::vector<RamDomain> xs = {7, 8};
+      std::vector<RamDomain> ys = {3, 9};
+      const RamDomain *columns[] = {xs.data(), ys.data()};
+      edge->insertColumns(columns, 2);
+      lookup(edge, tuple(edge, {0, 3}), 2, "edge(_,3)");
+
+      // exports are bounded by the given capacity
+      std::vector<RamDomain> rows(3 * 2);
+      print(rows, edge->exportAll(rows.data(), 3), 2, "edge rows");
+      std::vector<RamDomain> first(10), second(10);
+      RamDomain *targets[] = {first.data(), second.data()};
+      size_t count = edge->exportColumns(targets, 10);
+      std::vector<RamDomain> transposed;
+      for(size_t i = 0; i < count; i++) {
+         transposed.push_back(first[i]);
+         transposed.push_back(second[i]);
+      }
+      print(transposed, count, 2, "edge columns");
+
+      // the inserted tuples are used by the rules
+      prog->run();
+      Relation *pred = prog->getRelation("pred");
+      std::vector<RamDomain> preds(pred->size());
+      print(preds, pred->exportAll(preds.data(), preds.size()), 1, "pred");
+
+      // free program analysis
+      delete prog;
+   } else {
+      error("cannot find program bulk_insert");
+   }
+
+   // relations without bulk operations of their own insert and iterate single tuples
+   PairRelation pair;
+   std::vector<RamDomain> batch = {1, 2, 3, 4, 1, 2};
+   pair.insertAll(batch.data(), 3);
+   std::vector<RamDomain> xs = {5, 6};
+   std::vector<RamDomain> ys = {7, 8};
+   const RamDomain *columns[] = {xs.data(), ys.data()};
+   pair.insertColumns(columns, 2);
+   std::cout << "pair size: " << pair.size() << "\n";
+   std::vector<RamDomain> rows(4 * 2);
+   print(rows, pair.exportAll(rows.data(), 3), 2, "pair rows");
+   std::vector<RamDomain> first(4), second(4);
+   RamDomain *targets[] = {first.data(), second.data()};
+   size_t count = pair.exportColumns(targets, 4);
+   std::cout << "pair columns: " << count << " " << first[3] << "," << second[3] << "\n";
+   try {
+      pair.purge();
+   } catch(std::logic_error &e) {
+      std::cout << e.what() << "\n";
+   }
+}
@@ -0,0 +1,73 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program running two instances of a Souffle program concurrently
+ *
+ ***********************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "souffle/ProfileEvent.h"
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   if(argc < 2) {
+      error("no fact directory specified");
+   }
+
+   // create two instances of program "concurrent_instances"
+   SouffleProgram *first = ProgramFactory::newInstance("concurrent_instances");
+   SouffleProgram *second = ProgramFactory::newInstance("concurrent_instances");
+   if(first == nullptr || second == nullptr) {
+      error("cannot find program concurrent_instances");
+   }
+   first->loadAll(argv[1]);
+   second->loadAll(argv[1]);
+
+   // run both instances at the same time
+   std::thread firstRun([&]() { first->run(); });
+   std::thread secondRun([&]() { second->run(); });
+   firstRun.join();
+   secondRun.join();
+
+   for(SouffleProgram *prog : {first, second}) {
+      std::cout << "path: " << prog->getRelation("path")->size()
+                << ", hop: " << prog->getRelation("hop")->size() << "\n";
+   }
+
+   // all events are recorded by the profiles of the instances, including those of their worker threads
+   std::stringstream shared;
+   ProfileEventSingleton::instance().dump(shared);
+   std::cout << "shared profile: "
+             << (shared.str().find("relation") == std::string::npos ? "no relations" : "relations") << "\n";
+
+   // free program analysis
+   delete first;
+   delete second;
+}
@@ -0,0 +1,95 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program looking up tuples of the relations of a Souffle program
+ *
+ ***********************************************************************/
+
+#include <iostream>
+#include <string>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Print the tuples of a relation agreeing with a pattern on the given columns
+ */
+void lookup(Relation *rel, const tuple &pattern, SearchColumns columns, std::string title)
+{
+   std::cout << title << ":";
+   for(auto &t : rel->equalRange(pattern, columns)) {
+      std::cout << " ";
+      for(size_t i = 0; i < rel->getArity(); i++) {
+         std::cout << (i > 0 ? "," : "");
+         if(*rel->getAttrType(i) == 's') {
+            std::cout << rel->getSymbolTable().resolve(t[i]);
+         } else {
+            std::cout << t[i];
+         }
+      }
+   }
+   std::cout << "\n";
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   if(argc < 2) {
+      error("no fact directory specified");
+   }
+
+   // create an instance of program "equal_range"
+   if(SouffleProgram *prog = ProgramFactory::newInstance("equal_range")) {
+      prog->loadAll(argv[1]);
+      prog->run();
+      Relation *edge = prog->getRelation("edge");
+      Relation *path = prog->getRelation("path");
+      Relation *labelled = prog->getRelation("labelled");
+
+      // looked up via the primary index
+      lookup(edge, tuple(edge, {1, 0}), 1, "edge(1,_)");
+      lookup(edge, tuple(edge, {9, 0}), 1, "edge(9,_)");
+      lookup(path, tuple(path, {2, 4}), 3, "path(2,4)");
+
+      // looked up via the index on the second column
+      lookup(edge, tuple(edge, {0, 3}), 2, "edge(_,3)");
+
+      // no index covers the second column only, thus the relation is scanned
+      lookup(path, tuple(path, {0, 4}), 2, "path(_,4)");
+
+      // no columns select all tuples
+      lookup(edge, tuple(edge, {0, 0}), 0, "edge(_,_)");
+
+      // looked up via an index prefix, filtering the remaining columns
+      tuple key(labelled);
+      key << 1 << std::string("e") << 3;
+      lookup(labelled, key, 5, "labelled(1,_,3)");
+      lookup(labelled, key, 3, "labelled(1,e,_)");
+      lookup(labelled, key, 4, "labelled(_,_,3)");
+
+      // free program analysis
+      delete prog;
+   } else {
+      error("cannot find program equal_range");
+   }
+}
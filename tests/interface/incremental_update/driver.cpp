@@ -0,0 +1,124 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program updating the input relations of a Souffle program
+ *
+ ***********************************************************************/
+
+#include <iostream>
+#include <string>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Print the tuples of the output relations
+ */
+void print(SouffleProgram *prog, std::string title)
+{
+   std::cout << "-- " << title << "\n";
+   for(std::string name : {"path", "reach", "isolated"}) {
+      Relation *rel = prog->getRelation(name);
+      std::cout << name << ":";
+      for(auto &t : *rel) {
+         std::cout << " ";
+         for(size_t i = 0; i < rel->getArity(); i++) {
+            std::cout << (i > 0 ? "," : "") << t[i];
+         }
+      }
+      std::cout << "\n";
+   }
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   if(argc < 2) {
+      error("no fact directory specified");
+   }
+
+   // create an instance of program "incremental_update"
+   if(SouffleProgram *prog = ProgramFactory::newInstance("incremental_update")) {
+      if(!prog->isIncremental()) {
+         error("program does not keep its relations");
+      }
+      Relation *edge = prog->getRelation("edge");
+      Relation *reach = prog->getRelation("reach");
+      prog->loadAll(argv[1]);
+      prog->run();
+      print(prog, "run");
+
+      // insertions extend the relations depending on edge
+      prog->stageInsert(edge, tuple(edge, {3, 4}));
+      prog->update();
+      print(prog, "insert edge(3,4)");
+
+      // erasures remove the tuples derived from the erased ones, including those of reach
+      prog->stageErase(edge, tuple(edge, {2, 3}));
+      prog->update();
+      print(prog, "erase edge(2,3)");
+
+      // facts of an input relation that also has rules are derived from
+      prog->stageInsert(reach, tuple(reach, {3}));
+      prog->update();
+      print(prog, "insert reach(3)");
+
+      // erased facts of an input relation that also has rules remove the tuples derived from them
+      prog->stageErase(reach, tuple(reach, {1}));
+      prog->update();
+      print(prog, "erase reach(1)");
+
+      // erasing tuples that are not contained changes nothing
+      prog->stageErase(edge, tuple(edge, {9, 9}));
+      prog->update();
+      print(prog, "erase edge(9,9)");
+
+      // tuples keeping another derivation are derived again
+      prog->stageInsert(edge, tuple(edge, {1, 3}));
+      prog->stageInsert(edge, tuple(edge, {2, 3}));
+      prog->update();
+      print(prog, "insert edge(1,3), edge(2,3)");
+      prog->stageErase(edge, tuple(edge, {1, 3}));
+      prog->update();
+      print(prog, "erase edge(1,3)");
+
+      // tuples of a cycle do not derive themselves once the cycle is broken
+      prog->stageInsert(edge, tuple(edge, {4, 3}));
+      prog->update();
+      print(prog, "insert edge(4,3)");
+      prog->stageErase(edge, tuple(edge, {3, 4}));
+      prog->update();
+      print(prog, "erase edge(3,4)");
+
+      // changes cancelling each other change nothing
+      prog->stageInsert(edge, tuple(edge, {5, 1}));
+      prog->stageErase(edge, tuple(edge, {5, 1}));
+      prog->update();
+      print(prog, "insert and erase edge(5,1)");
+
+      // free program analysis
+      delete prog;
+   } else {
+      error("cannot find program incremental_update");
+   }
+}
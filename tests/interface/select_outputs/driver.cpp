@@ -0,0 +1,63 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program selecting the outputs computed by a Souffle program
+ *
+ ***********************************************************************/
+
+#include <iostream>
+#include <set>
+#include <string>
+#include "souffle/SouffleInterface.h"
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   if(argc < 2) {
+      error("no fact directory specified");
+   }
+
+   // create an instance of program "select_outputs"
+   if(SouffleProgram *prog = ProgramFactory::newInstance("select_outputs")) {
+      // a selection naming an unknown relation is rejected
+      if(prog->selectOutputs({"path", "unknown"})) {
+         error("unknown relation selected");
+      }
+
+      // only compute path, such that loop remains empty
+      if(!prog->selectOutputs({"path"})) {
+         error("cannot select relation path");
+      }
+      prog->loadAll(argv[1]);
+      prog->run();
+      std::cout << "path: " << prog->getRelation("path")->size() << "\n";
+      std::cout << "loop: " << prog->getRelation("loop")->size() << "\n";
+
+      // free program analysis
+      delete prog;
+   } else {
+      error("cannot find program select_outputs");
+   }
+}
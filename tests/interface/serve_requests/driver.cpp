@@ -0,0 +1,175 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program serving requests to a resident Souffle program, and
+ * sending requests to it over its socket
+ *
+ ***********************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "souffle/SouffleInterface.h"
+#include "souffle/SouffleServer.h"
+
+using namespace souffle;
+
+const char* SOCKET = "serve_requests.sock";
+
+/**
+ * Error handler
+ */
+void error(std::string txt)
+{
+   std::cerr << "error: " << txt << "\n";
+   exit(1);
+}
+
+/**
+ * Connect to the server, waiting for it to listen
+ */
+int connectServer()
+{
+   sockaddr_un addr = {};
+   addr.sun_family = AF_UNIX;
+   std::strncpy(addr.sun_path, SOCKET, sizeof(addr.sun_path) - 1);
+   for(int attempt = 0; attempt < 500; attempt++) {
+      int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+         return fd;
+      }
+      close(fd);
+      usleep(10000);
+   }
+   error("cannot connect to server");
+   return -1;
+}
+
+/**
+ * Read the given number of bytes
+ */
+void readFully(int fd, char* buf, size_t size)
+{
+   while(size > 0) {
+      ssize_t res = read(fd, buf, size);
+      if(res <= 0) {
+         error("connection closed");
+      }
+      buf += res;
+      size -= res;
+   }
+}
+
+/**
+ * Send a frame of the given size, and print the response
+ */
+void request(int fd, const std::string& msg, uint32_t size)
+{
+   uint32_t header = htonl(size);
+   if(write(fd, &header, sizeof(header)) != sizeof(header) ||
+         write(fd, msg.data(), msg.size()) != (ssize_t)msg.size()) {
+      error("cannot send request");
+   }
+   readFully(fd, reinterpret_cast<char*>(&header), sizeof(header));
+   std::string response(ntohl(header), '\0');
+   readFully(fd, &response[0], response.size());
+   std::cout << "> " << (size == msg.size() ? msg : "<oversized>") << "\n" << response;
+}
+
+void request(int fd, const std::string& msg)
+{
+   request(fd, msg, msg.size());
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char **argv)
+{
+   if(argc < 2) {
+      error("no fact directory specified");
+   }
+
+   // create an instance of program "serve_requests"
+   SouffleProgram *prog = ProgramFactory::newInstance("serve_requests");
+   if(prog == nullptr) {
+      error("cannot find program serve_requests");
+   }
+   prog->loadAll(argv[1]);
+   prog->run();
+
+   // a file that is not a socket is not replaced
+   unlink(SOCKET);
+   {
+      std::ofstream file(SOCKET);
+   }
+   try {
+      SouffleServer(*prog, SOCKET).serve();
+      error("file replaced by socket");
+   } catch(std::invalid_argument& e) {
+      std::cout << "refused: " << e.what() << "\n";
+   }
+   unlink(SOCKET);
+
+   // serve the requests in a child process
+   std::cout.flush();
+   pid_t pid = fork();
+   if(pid == 0) {
+      SouffleServer(*prog, SOCKET, argv[1]).serve();
+      exit(0);
+   }
+
+   int fd = connectServer();
+   struct stat info;
+   if(stat(SOCKET, &info) != 0 || (info.st_mode & 0777) != 0600) {
+      error("socket is accessible to others");
+   }
+   request(fd, "size path");
+   request(fd, "query path(1, _)");
+   request(fd, "insert edge(3, 4)");
+   request(fd, "run");
+   request(fd, "query path(1, _)");
+   request(fd, "erase edge(2, 3)");
+   request(fd, "run");
+   request(fd, "query path(_, _)");
+   request(fd, "query path(1)");
+   close(fd);
+
+   // an oversized request is answered by an error before the connection is closed
+   fd = connectServer();
+   request(fd, "", 0xffffffff);
+   close(fd);
+
+   fd = connectServer();
+   request(fd, "shutdown");
+   close(fd);
+
+   int status;
+   if(waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      error("server failed");
+   }
+   struct stat gone;
+   if(stat(SOCKET, &gone) == 0) {
+      error("socket not removed");
+   }
+
+   // free program analysis
+   delete prog;
+}